@@ -969,7 +969,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
   try {
     con->query().exec("DELETE FROM oCard");
     {
-      list<oCard>::iterator it = oe->Cards.begin();
+      oCardList::iterator it = oe->Cards.begin();
       while (it != oe->Cards.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -979,7 +979,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
 
     con->query().exec("DELETE FROM oClub");
     {
-      list<oClub>::iterator it = oe->Clubs.begin();
+      oClubList::iterator it = oe->Clubs.begin();
       while (it != oe->Clubs.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -988,7 +988,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
     }
     con->query().exec("DELETE FROM oControl");
     {
-      list<oControl>::iterator it = oe->Controls.begin();
+      oControlList::iterator it = oe->Controls.begin();
       while (it != oe->Controls.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -997,7 +997,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
     }
     con->query().exec("DELETE FROM oCourse");
     {
-      list<oCourse>::iterator it = oe->Courses.begin();
+      oCourseList::iterator it = oe->Courses.begin();
       while (it != oe->Courses.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -1006,7 +1006,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
     }
     con->query().exec("DELETE FROM oClass");
     {
-      list<oClass>::iterator it = oe->Classes.begin();
+      oClassList::iterator it = oe->Classes.begin();
       while (it != oe->Classes.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -1015,7 +1015,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
     }
     con->query().exec("DELETE FROM oRunner");
     {
-      list<oRunner>::iterator it = oe->Runners.begin();
+      oRunnerList::iterator it = oe->Runners.begin();
       while (it != oe->Runners.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -1025,7 +1025,7 @@ OpFailStatus MeosSQL::SyncUpdate(oEvent *oe)
 
     con->query().exec("DELETE FROM oTeam");
     {
-      list<oTeam>::iterator it = oe->Teams.begin();
+      oTeamList::iterator it = oe->Teams.begin();
       while (it != oe->Teams.end()) {
         if (!it->isRemoved() && syncUpdate(&*it, true) == opStatusFail)
           return opStatusFail;
@@ -2318,8 +2318,24 @@ OpFailStatus MeosSQL::syncRead(bool forceRead, oRunner *r, bool readClassClub, b
     auto res = query.store();
 
     RowWrapper row;
-    if (!res.empty()) {
-      row=res.at(0);
+    if (!res.empty())
+      row = res.at(0);
+
+    return syncReadRow(row, r, readClassClub, readCourseCard, nullptr);
+  }
+  catch (const Exception& er){
+    alert(string(er.what())+" [SYNCREAD oRunner]");
+    return opStatusFail;
+  }
+
+  return opStatusFail;
+}
+
+OpFailStatus MeosSQL::syncReadRow(const RowWrapper &row, oRunner *r, 
+                                  bool readClassClub, bool readCourseCard, 
+                                  vector<oCard *> *deferredCards) {
+  try {
+    if (row) {
       // Remotly changed update!
       OpFailStatus success=opStatusOK;
       if (r->changed)
@@ -2345,8 +2361,12 @@ OpFailStatus MeosSQL::syncRead(bool forceRead, oRunner *r, bool readClassClub, b
       }
     }
 
-    if (r->Card && readCourseCard)
-      syncRead(false, r->Card);
+    if (r->Card && readCourseCard) {
+      if (deferredCards)
+        deferredCards->push_back(r->Card);
+      else
+        syncRead(false, r->Card);
+    }
     if (r->Class && readClassClub)
       syncRead(false, r->Class, readClassClub);
     if (r->Course && readCourseCard) {
@@ -2416,8 +2436,22 @@ OpFailStatus MeosSQL::syncRead(bool forceRead, oCard *c)
     auto res = query.store();
 
     RowWrapper row;
-    if (!res.empty()){
-      row=res.at(0);
+    if (!res.empty())
+      row = res.at(0);
+
+    return syncReadRow(row, c);
+  }
+  catch (const Exception& er){
+    alert(string(er.what())+" [SYNCREAD oCard]");
+    return opStatusFail;
+  }
+
+  return opStatusFail;
+}
+
+OpFailStatus MeosSQL::syncReadRow(const RowWrapper &row, oCard *c) {
+  try {
+    if (row) {
       if (!c->changed || isOld(row["Counter"], string(row["Modified"]), c)){
 
         OpFailStatus success=opStatusOK;
@@ -3145,8 +3179,21 @@ OpFailStatus MeosSQL::syncRead(bool forceRead, oFreePunch *c, bool rehash)
     auto res = query.store();
 
     RowWrapper row;
-    if (!res.empty()) {
-      row=res.at(0);
+    if (!res.empty())
+      row = res.at(0);
+
+    return syncReadRow(row, c, rehash);
+  }
+  catch (const Exception& er){
+    alert(string(er.what())+" [SYNCREAD oPunch]");
+    return opStatusFail;
+  }
+  return opStatusFail;
+}
+
+OpFailStatus MeosSQL::syncReadRow(const RowWrapper &row, oFreePunch *c, bool rehash) {
+  try {
+    if (row) {
       OpFailStatus success = opStatusOK;
       if (c->changed)
         success = opStatusWarning;
@@ -3545,17 +3592,15 @@ bool MeosSQL::syncListRunner(oEvent *oe)
     auto res = query.store(selectUpdated("oRunner", oe->sqlRunners));
 
     if (res) {
+      vector<ChangedRow> changedRows;
       const auto nr = res.num_rows();
       for (int i = 0; i < nr; i++) {
-        OpFailStatus st = OpFailStatus::opUnreachable;
-
         auto row=res.at(i);
         int Id = row["Id"];
         int counter = row["Counter"];
         string modified = row["Modified"];
 
         if (int(row["Removed"])==1){
-          st = OpFailStatus::opStatusOK;
           oRunner *r=oe->getRunner(Id, 0);
 
           if (r && !r->Removed) {
@@ -3571,24 +3616,62 @@ bool MeosSQL::syncListRunner(oEvent *oe)
             r->changed = false;
             oe->dataRevision++;
           }
+          updateCounters(opStatusOK, counter, modified, oe->sqlRunners, maxCounterRunner);
         }
-        else{
+        else {
           oRunner *r=oe->getRunner(Id, 0);
+          if (r && !isOld(counter, modified, r))
+            updateCounters(opStatusOK, counter, modified, oe->sqlRunners, maxCounterRunner);
+          else
+            changedRows.emplace_back(Id, counter, modified);
+        }
+      }
 
+      // Read all changed runners with a few queries, then their cards
+      vector<oCard *> cardsToRead;
+      for (size_t start = 0; start < changedRows.size(); start += maxBatchRead) {
+        size_t end = min(changedRows.size(), start + maxBatchRead);
+        map<int, int> rowIndex;
+        auto rows = readRows("oRunner", changedRows, start, end, rowIndex);
+
+        for (size_t k = start; k < end; k++) {
+          const ChangedRow &cr = changedRows[k];
+          RowWrapper row;
+          auto ix = rowIndex.find(cr.id);
+          if (ix != rowIndex.end())
+            row = rows.at(ix->second);
+
+          OpFailStatus st = OpFailStatus::opUnreachable;
+          oRunner *r = oe->getRunner(cr.id, 0);
           if (r) {
-            if (isOld(counter, modified, r))
-              st = syncRead(false, r);
+            if (!r->existInDB())
+              st = syncUpdate(r, true);
+            else if (!r->changed && skipSynchronize(*r))
+              st = opStatusOKSkipped;
             else
-              st = opStatusOK;
+              st = syncReadRow(row, r, true, true, &cardsToRead);
           }
           else {
-            oRunner oR(oe, Id);
+            oRunner oR(oe, cr.id);
             oR.setImplicitlyCreated();
-            st = syncRead(true, &oR, false, false);
+            st = syncReadRow(row, &oR, false, false, nullptr);
             r = oe->addRunner(oR, false);
           }
+          updateCounters(st, cr.counter, cr.modified, oe->sqlRunners, maxCounterRunner);
+        }
+      }
+
+      vector<OpFailStatus> cardStatus;
+      syncRead(false, cardsToRead, cardStatus);
+
+      // Evaluate runners again with their updated cards
+      for (size_t k = 0; k < cardsToRead.size(); k++) {
+        pRunner owner = cardsToRead[k]->tOwner;
+        if (owner && cardStatus[k] != opStatusOKSkipped && !owner->changed) {
+          vector<pair<int, pControl>> mp;
+          owner->evaluateCard(true, mp, 0, oBase::ChangeType::Quiet);
+          owner->changed = false;
         }
-        updateCounters(st, counter, modified, oe->sqlRunners, maxCounterRunner);
       }
     }
   }
@@ -3603,6 +3686,77 @@ bool MeosSQL::syncListRunner(oEvent *oe)
   return true;
 }
 
+ResultWrapper MeosSQL::readRows(const char *oTable, const vector<ChangedRow> &changed, 
+                                size_t start, size_t end, map<int, int> &rowIndex) {
+  auto query = con->query();
+  query << "SELECT * FROM " << oTable << " WHERE Id IN (";
+  for (size_t k = start; k < end; k++) {
+    if (k > start)
+      query << ",";
+    query << changed[k].id;
+  }
+  query << ")";
+  auto res = query.store();
+
+  rowIndex.clear();
+  if (res) {
+    const auto nr = res.num_rows();
+    for (int i = 0; i < nr; i++)
+      rowIndex[int(res.at(i)["Id"])] = i;
+  }
+  return res;
+}
+
+void MeosSQL::syncRead(bool forceRead, const vector<oCard *> &cards, vector<OpFailStatus> &status) {
+  status.assign(cards.size(), opStatusFail);
+  if (CmpDataBase.empty() || !con->connected())
+    return;
+
+  // Cards that need to be read from the database
+  vector<ChangedRow> toRead;
+  vector<size_t> toReadIx;
+  set<int> added;
+  for (size_t k = 0; k < cards.size(); k++) {
+    oCard *c = cards[k];
+    if (!c)
+      continue;
+    if (!forceRead) {
+      if (!c->existInDB()) {
+        status[k] = syncUpdate(c, true);
+        continue;
+      }
+      if (!c->changed && skipSynchronize(*c)) {
+        status[k] = opStatusOKSkipped;
+        continue;
+      }
+    }
+    if (added.insert(c->Id).second) {
+      toRead.emplace_back(c->Id, 0, "");
+      toReadIx.push_back(k);
+    }
+    else
+      status[k] = opStatusOK; // Same card read twice
+  }
+
+  try {
+    for (size_t start = 0; start < toRead.size(); start += maxBatchRead) {
+      size_t end = min(toRead.size(), start + maxBatchRead);
+      map<int, int> rowIndex;
+      auto rows = readRows("oCard", toRead, start, end, rowIndex);
+      for (size_t k = start; k < end; k++) {
+        RowWrapper row;
+        auto ix = rowIndex.find(toRead[k].id);
+        if (ix != rowIndex.end())
+          row = rows.at(ix->second);
+        status[toReadIx[k]] = syncReadRow(row, cards[toReadIx[k]]);
+      }
+    }
+  }
+  catch (const Exception& er) {
+    alert(string(er.what()) + " [SYNCREAD oCard]");
+  }
+}
+
 bool MeosSQL::syncListClass(oEvent *oe) {
   errorMessage.clear();
 
@@ -3801,16 +3955,15 @@ bool MeosSQL::syncListCard(oEvent *oe)
     auto res = query.store(selectUpdated("oCard", oe->sqlCards));
 
     if (res) {
+      vector<ChangedRow> changedRows;
       const auto nr = res.num_rows();
       for (int i = 0; i < nr; i++) {
-        OpFailStatus st = OpFailStatus::opUnreachable;
         auto row = res.at(i);
         int counter = row["Counter"];
         string modified(row["Modified"]);
         int Id = row["Id"];
 
         if (int(row["Removed"])) {
-          st = opStatusOK;
           oCard *c = oe->getCard(Id);
           if (c && !c->Removed) {
             c->changedObject();
@@ -3818,25 +3971,50 @@ bool MeosSQL::syncListCard(oEvent *oe)
             c->changed = false;
             oe->dataRevision++;
           }
+          updateCounters(opStatusOK, counter, modified, oe->sqlCards, maxCounter);
         }
         else {
           oCard *c = oe->getCard(Id);
+          if (c && !isOld(counter, modified, c))
+            updateCounters(opStatusOK, counter, modified, oe->sqlCards, maxCounter);
+          else
+            changedRows.emplace_back(Id, counter, modified);
+        }
+      }
 
-          if (c) {
-            if (isOld(counter, modified, c))
-              st = syncRead(false, c);
-            else
-              st = opStatusOK;
-          }
-          else {
-            oCard oc(oe, Id);
-            oc.setImplicitlyCreated();
-            c = oe->addCard(oc);
-            if (c != 0)
-              st = syncRead(true, c);
+      // Existing cards are read as syncRead(false, c), new cards are forced.
+      vector<oCard *> changedCards, newCards;
+      vector<size_t> changedIx, newIx;
+      for (size_t k = 0; k < changedRows.size(); k++) {
+        oCard *c = oe->getCard(changedRows[k].id);
+        if (c) {
+          changedCards.push_back(c);
+          changedIx.push_back(k);
+        }
+        else {
+          oCard oc(oe, changedRows[k].id);
+          oc.setImplicitlyCreated();
+          c = oe->addCard(oc);
+          if (c != 0) {
+            newCards.push_back(c);
+            newIx.push_back(k);
           }
+          else
+            updateCounters(opUnreachable, changedRows[k].counter, changedRows[k].modified, oe->sqlCards, maxCounter);
         }
-        updateCounters(st, counter, modified, oe->sqlCards, maxCounter);
+      }
+
+      vector<OpFailStatus> status;
+      syncRead(false, changedCards, status);
+      for (size_t k = 0; k < changedIx.size(); k++) {
+        const ChangedRow &cr = changedRows[changedIx[k]];
+        updateCounters(status[k], cr.counter, cr.modified, oe->sqlCards, maxCounter);
+      }
+
+      syncRead(true, newCards, status);
+      for (size_t k = 0; k < newIx.size(); k++) {
+        const ChangedRow &cr = changedRows[newIx[k]];
+        updateCounters(status[k], cr.counter, cr.modified, oe->sqlCards, maxCounter);
       }
     }
   }
@@ -3923,17 +4101,15 @@ bool MeosSQL::syncListPunch(oEvent *oe)
     auto res = query.store(selectUpdated("oPunch", oe->sqlPunches) + " ORDER BY Id");
 
     if (res) {
+      vector<ChangedRow> changedRows;
       auto nr = res.num_rows();
       for(int i=0; i<nr; i++){
-        OpFailStatus st = opUnreachable;
-
         auto row=res.at(i);
         int counter = row["Counter"];
         string modified(row["Modified"]);
         int Id=row["Id"];
 
         if (int(row["Removed"])) {
-          st = OpFailStatus::opStatusOK;
           oFreePunch *c=oe->getPunch(Id);
           if (c && !c->Removed) {
             c->Removed=true;
@@ -3946,25 +4122,47 @@ bool MeosSQL::syncListPunch(oEvent *oe)
             c->changed = false;
             oe->dataRevision++;
           }
+          updateCounters(opStatusOK, counter, modified, oe->sqlPunches, maxCounter);
         }
         else {
           oFreePunch *c=oe->getPunch(Id);
+          if (c && !isOld(counter, modified, c))
+            updateCounters(opStatusOK, counter, modified, oe->sqlPunches, maxCounter);
+          else
+            changedRows.emplace_back(Id, counter, modified);
+        }
+      }
+
+      for (size_t start = 0; start < changedRows.size(); start += maxBatchRead) {
+        size_t end = min(changedRows.size(), start + maxBatchRead);
+        map<int, int> rowIndex;
+        auto rows = readRows("oPunch", changedRows, start, end, rowIndex);
+
+        for (size_t k = start; k < end; k++) {
+          const ChangedRow &cr = changedRows[k];
+          RowWrapper row;
+          auto ix = rowIndex.find(cr.id);
+          if (ix != rowIndex.end())
+            row = rows.at(ix->second);
 
+          OpFailStatus st = opUnreachable;
+          oFreePunch *c = oe->getPunch(cr.id);
           if (c) {
-            if (isOld(counter, modified, c))
-              st = syncRead(false, c, true);
+            if (!c->existInDB())
+              st = syncUpdate(c, true);
+            else if (!c->changed && skipSynchronize(*c))
+              st = opStatusOKSkipped;
             else
-              st = opStatusOK;
+              st = syncReadRow(row, c, true);
           }
           else {
-            oFreePunch p(oe, Id);
+            oFreePunch p(oe, cr.id);
             p.setImplicitlyCreated();
-            st = syncRead(true, &p, false);
+            st = syncReadRow(row, &p, false);
             oe->addFreePunch(p);
           }
+          updateCounters(st, cr.counter, cr.modified, oe->sqlPunches, maxCounter);
         }
-
-        updateCounters(st, counter, modified, oe->sqlPunches, maxCounter);
       }
     }
   }
@@ -4484,8 +4682,9 @@ void  MeosSQL::checkAgainstDB(const char *oTable, map<int, oBase *> &existing, v
   }
 }
 
-template<typename T>
-bool MeosSQL::checkTableCheckSum(const char *oTable, const list<T> &def, int p1, int p2, int p3) {
+template<typename C>
+bool MeosSQL::checkTableCheckSum(const char *oTable, const C &def, int p1, int p2, int p3) {
+  typedef typename C::value_type T;
   int csCounter1 = 0;
   int csCounter2 = 0;
   int csCounter3 = 0;
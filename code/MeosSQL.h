@@ -46,6 +46,7 @@ struct SqlUpdated;
 
 namespace sqlwrapper {  
   class ResNSel;
+  class ResultWrapper;
   class RowWrapper;
   class QueryWrapper;
   class ConnectionWrapper;
@@ -103,6 +104,28 @@ protected:
   OpFailStatus syncRead(bool forceRead, oClass *c, bool readCourses);
   OpFailStatus syncReadControls(oEvent *oe, const set<int> &controlIds);
 
+  // Apply a row read from the database (empty if not found). Used both for single
+  // objects and for batched reads in the syncList methods.
+  OpFailStatus syncReadRow(const RowWrapper &row, oRunner *r, bool readClassClub, 
+                           bool readCourseCard, vector<oCard *> *deferredCards);
+  OpFailStatus syncReadRow(const RowWrapper &row, oCard *c);
+  OpFailStatus syncReadRow(const RowWrapper &row, oFreePunch *c, bool rehash);
+
+  // Row header of a changed object in a syncList query
+  struct ChangedRow {
+    int id;
+    int counter;
+    string modified;
+    ChangedRow(int id, int counter, const string &modified) : id(id), counter(counter), modified(modified) {}
+  };
+  // Maximal number of ids in one batched read
+  static const size_t maxBatchRead = 500;
+  // Read complete rows for changed[start..end) with one query. rowIndex maps id to row.
+  ResultWrapper readRows(const char *oTable, const vector<ChangedRow> &changed, 
+                         size_t start, size_t end, map<int, int> &rowIndex);
+  // Read several cards with batched queries
+  void syncRead(bool forceRead, const vector<oCard *> &cards, vector<OpFailStatus> &status);
+
   void storeClub(const RowWrapper &row, oClub &c);
   void storeControl(const RowWrapper &row, oControl &c);
   void storeCard(const RowWrapper &row, oCard &c);
@@ -146,8 +169,8 @@ protected:
 
   void checkAgainstDB(const char *oTable, map<int, oBase *> &existing, vector<pair<int, oBase *>> &idsToUpdate);
 
-  template<typename T>
-  bool checkTableCheckSum(const char *oTable, const list<T> &def, int p1, int p2, int p3);
+  template<typename C>
+  bool checkTableCheckSum(const char *oTable, const C &def, int p1, int p2, int p3);
 
   bool syncListRunner(oEvent *oe);
   bool syncListClass(oEvent *oe);
@@ -316,7 +316,7 @@ RunnerWDBEntry *RunnerDB::addRunner(const wchar_t *name,
     if (!idhash.empty())
       idhash[extId] = rdb.size()-1;
     if (!nhash.empty())
-      nhash.emplace(canonizeName(e.name), rdb.size()-1);
+      addNameHash(e.name, rdb.size()-1);
   }
   return &e;
 }
@@ -348,11 +348,8 @@ RunnerWDBEntry *RunnerDB::addRunner(const char *nameUTF,
       rhash[card]=rdb.size()-1;
     if (!idhash.empty())
       idhash[extId] = rdb.size()-1;
-    if (!nhash.empty()) {
-      wstring wn;
-      e.getName(wn);
-      nhash.emplace(canonizeName(wn.c_str()), rdb.size()-1);
-    }
+    if (!nhash.empty())
+      addNameHash(e.getNameCstr(), rdb.size()-1);
   }
   return &e;
 }
@@ -518,13 +515,7 @@ RunnerWDBEntry *RunnerDB::getRunnerByName(const wstring &name, int clubId,
 
   setupNameHash();
   vector<int> ix;
-  wstring cname(canonizeName(name.c_str()));
-  multimap<wstring, int>::const_iterator it = nhash.find(cname);
-
-  while (it != nhash.end() && cname == it->first) {
-    ix.push_back(it->second);
-    ++it;
-  }
+  lookupName(canonizeName(name.c_str()), ix);
 
   if (ix.empty())
     return 0;
@@ -577,6 +568,7 @@ void RunnerDB::setupIdHash() const
   if (!idhash.empty())
     return;
 
+  idhash.resize(rdb.size());
   for (size_t k=0; k<rdb.size(); k++) {
     if (!rdb[k].isRemoved())
       idhash[rdb[k].getExtId()] = int(k);
@@ -588,14 +580,75 @@ void RunnerDB::setupNameHash() const
   if (!nhash.empty())
     return;
 
+  if (!indexedRunnerFile.empty() && loadNameIndex())
+    return;
+
+  nhash.reserve(rdb.size());
   for (size_t k=0; k<rdb.size(); k++) {
-    if (!rdb[k].isRemoved()) {
-      rwdb[k].initName();
-      nhash.insert(pair<wstring, int>(canonizeName(rwdb[k].name), k));
-    }
+    if (!rdb[k].isRemoved())
+      nhash.emplace_back(nameKey(canonizeName(rwdb[k].getNameCstr())), int(k));
+  }
+  sort(nhash.begin(), nhash.end());
+  nhashSorted = true;
+}
+
+uint64_t RunnerDB::nameKey(const wchar_t *cname) {
+  // FNV-1a. Must be stable, since the name hash is persisted.
+  uint64_t h = 14695981039346656037ull;
+  for (int k = 0; cname[k]; k++) {
+    h ^= uint16_t(cname[k]);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+void RunnerDB::addNameHash(const wchar_t *name, int ix) const {
+  nhash.emplace_back(nameKey(canonizeName(name)), ix);
+  nhashSorted = false;
+}
+
+void RunnerDB::removeNameHash(const wchar_t *name, int ix) {
+  if (nhash.empty())
+    return;
+  if (!nhashSorted) {
+    sort(nhash.begin(), nhash.end());
+    nhashSorted = true;
+  }
+  auto key = make_pair(nameKey(canonizeName(name)), ix);
+  auto it = lower_bound(nhash.begin(), nhash.end(), key);
+  if (it != nhash.end() && *it == key)
+    nhash.erase(it);
+}
+
+void RunnerDB::lookupName(const wstring &cname, vector<int> &ix) const {
+  ix.clear();
+  if (!nhashSorted) {
+    sort(nhash.begin(), nhash.end());
+    nhashSorted = true;
+  }
+  uint64_t key = nameKey(cname.c_str());
+  auto it = lower_bound(nhash.begin(), nhash.end(), make_pair(key, 0));
+  for (; it != nhash.end() && it->first == key; ++it) {
+    // Verify against the entry; keys may collide and the name may have changed
+    const RunnerWDBEntry &re = rwdb[it->second];
+    if (!re.isRemoved() && cname == canonizeName(re.getNameCstr()))
+      ix.push_back(it->second);
   }
 }
 
+wstring RunnerDB::nameIndexFile(const wstring &runnerFile) {
+  return runnerFile + L".index";
+}
+
+bool RunnerDB::getFileStamp(const wstring &file, int64_t &size, int64_t &modified) {
+  struct _stat64 st;
+  if (_wstat64(file.c_str(), &st) != 0)
+    return false;
+  size = st.st_size;
+  modified = st.st_mtime;
+  return true;
+}
+
 void RunnerDB::setupCNHash() const
 {
   if (!cnhash.empty())
@@ -866,10 +919,111 @@ void RunnerDB::saveRunners(const wstring &file)
     if (!rdb.empty())
       _write(f, &rdb[0], rdb.size()*sizeof(RunnerDBEntry));
     _close(f);
+    saveNameIndex(file);
   }
   else throw std::exception("Could not save runner database.");
 }
 
+namespace {
+  const int nameIndexVersion = 2;
+  // Version, number of entries, number of index items, file size and modification time
+  const int nameIndexHeaderSize = 4 + 4 + 4 + 8 + 8;
+  // Key and index
+  const int nameIndexItemSize = 8 + 4;
+
+  // Little endian, independent of struct layout
+  void putInt(string &out, uint64_t value, int bytes) {
+    for (int k = 0; k < bytes; k++)
+      out.push_back(char((value >> (8 * k)) & 0xFF));
+  }
+
+  uint64_t getInt(const unsigned char *&data, int bytes) {
+    uint64_t value = 0;
+    for (int k = 0; k < bytes; k++)
+      value |= uint64_t(data[k]) << (8 * k);
+    data += bytes;
+    return value;
+  }
+}
+
+void RunnerDB::saveNameIndex(const wstring &runnerFile) const {
+  setupNameHash();
+  if (!nhashSorted) {
+    sort(nhash.begin(), nhash.end());
+    nhashSorted = true;
+  }
+
+  int64_t fileSize, fileModified;
+  if (!getFileStamp(runnerFile, fileSize, fileModified))
+    return;
+
+  string data;
+  data.reserve(nameIndexHeaderSize + nhash.size() * nameIndexItemSize);
+  putInt(data, nameIndexVersion, 4);
+  putInt(data, rdb.size(), 4);
+  putInt(data, nhash.size(), 4);
+  putInt(data, fileSize, 8);
+  putInt(data, fileModified, 8);
+  for (auto &h : nhash) {
+    putInt(data, h.first, 8);
+    putInt(data, h.second, 4);
+  }
+
+  int f = -1;
+  _wsopen_s(&f, nameIndexFile(runnerFile).c_str(), _O_BINARY|_O_CREAT|_O_TRUNC|_O_WRONLY,
+            _SH_DENYWR, _S_IREAD|_S_IWRITE);
+  if (f == -1)
+    return; // The index is optional
+
+  _write(f, data.c_str(), data.size());
+  _close(f);
+}
+
+bool RunnerDB::loadNameIndex() const {
+  wstring runnerFile;
+  swap(runnerFile, indexedRunnerFile); // Only try once
+
+  int f = -1;
+  _wsopen_s(&f, nameIndexFile(runnerFile).c_str(), _O_BINARY|_O_RDONLY,
+            _SH_DENYWR, _S_IREAD|_S_IWRITE);
+  if (f == -1)
+    return false;
+
+  int len = _filelength(f);
+  vector<unsigned char> data(max(len, 0));
+  bool ok = len >= nameIndexHeaderSize && _read(f, data.data(), len) == len;
+  _close(f);
+  if (!ok)
+    return false;
+
+  const unsigned char *ptr = data.data();
+  int version = int(getInt(ptr, 4));
+  int numEntry = int(getInt(ptr, 4));
+  int numIndex = int(getInt(ptr, 4));
+  int64_t fileSize = int64_t(getInt(ptr, 8));
+  int64_t fileModified = int64_t(getInt(ptr, 8));
+
+  // Only trust the index if it was saved with the loaded runner file
+  if (version != nameIndexVersion || numEntry != int(rdb.size()) ||
+      fileSize != runnerFileSize || fileModified != runnerFileModified ||
+      numIndex < 0 || numIndex > numEntry ||
+      len != nameIndexHeaderSize + numIndex * nameIndexItemSize)
+    return false;
+
+  nhash.resize(numIndex);
+  for (int k = 0; k < numIndex; k++) {
+    nhash[k].first = getInt(ptr, 8);
+    nhash[k].second = int(getInt(ptr, 4));
+    if (nhash[k].second < 0 || nhash[k].second >= numEntry || (k > 0 && nhash[k] < nhash[k-1]))
+      ok = false;
+  }
+
+  if (!ok)
+    nhash.clear();
+  nhashSorted = true;
+  return ok;
+}
+
 void RunnerDB::loadClubs(const wstring &file)
 {
   xmlparser xml;
@@ -1051,6 +1205,10 @@ void RunnerDB::loadRunners(const wstring &file)
         rhash[rdb[k].cardNo]=k;
       }
     }
+
+    // A saved name index is read on first lookup
+    if (getFileStamp(file, runnerFileSize, runnerFileModified))
+      indexedRunnerFile = file;
   }
   else throw meosException(ex);
 }
@@ -1110,16 +1268,14 @@ void RunnerDB::updateAdd(const oRunner &r, map<int, int> &clubIdMap)
     // Lookup by name
     setupNameHash();
     vector<int> ix;
-    wstring cname(canonizeName(r.getName().c_str()));
-    auto it = nhash.find(cname);
+    lookupName(canonizeName(r.getName().c_str()), ix);
 
-    while (it != nhash.end() && cname == it->first) {
-      auto &dbr = rwdb[it->second];
+    for (int i : ix) {
+      auto &dbr = rwdb[i];
       if (dbr.dbe().clubNo == localClubId) {
         dbe = &dbr;
         break;
       }
-      ++it;
     }
   }
 
@@ -1168,6 +1324,8 @@ void RunnerDB::clearClubs()
 void RunnerDB::clearRunners()
 {
   nhash.clear();
+  nhashSorted = true;
+  indexedRunnerFile.clear();
   idhash.clear();
   rhash.clear();
   runnerHash.clear(); // Autocomplete
@@ -1601,16 +1759,7 @@ void oDBRunnerEntry::remove() {
   RunnerWDBEntry &r = db->rwdb[index];
   r.remove();
   db->idhash.remove(r.dbe().getExtId());
-  wstring cname(canonizeName(r.name));
-  multimap<wstring, int>::const_iterator it = db->nhash.find(cname);
-
-  while (it != db->nhash.end() && cname == it->first) {
-    if (it->second == index) {
-      db->nhash.erase(it);
-      break;
-    }
-    ++it;
-  }
+  db->removeNameHash(r.getNameCstr(), index);
 
   if (r.dbe().cardNo > 0) {
     int ix = -1;
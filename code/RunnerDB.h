@@ -217,8 +217,28 @@ private:
   // Last known free index
   int freeCIx;
 
-  // Name hash
-  mutable multimap<wstring, int> nhash;
+  // Name hash. Sorted pairs of (key of canonized name, index)
+  mutable vector<pair<uint64_t, int>> nhash;
+  mutable bool nhashSorted = true;
+
+  static uint64_t nameKey(const wchar_t *canonizedName);
+  void addNameHash(const wchar_t *name, int ix) const;
+  void removeNameHash(const wchar_t *name, int ix);
+  /** Get indices of (non-removed) runners with the given canonized name*/
+  void lookupName(const wstring &cname, vector<int> &ix) const;
+
+  /** The name hash is persisted next to the runner file. It is read on the first
+      name lookup, if the runner file has the same size and modification time as when
+      the index was saved. */
+  static wstring nameIndexFile(const wstring &runnerFile);
+  static bool getFileStamp(const wstring &file, int64_t &size, int64_t &modified);
+  void saveNameIndex(const wstring &runnerFile) const;
+  bool loadNameIndex() const;
+
+  // Loaded runner file that may have a saved name index, and its size and modification time
+  mutable wstring indexedRunnerFile;
+  int64_t runnerFileSize = 0;
+  int64_t runnerFileModified = 0;
 
   // Club name hash
   mutable multimap<wstring, int> cnhash;
@@ -787,6 +787,56 @@ struct SIOnlinePunch {
   DWORD CodeTime;  //Time
 };
 
+size_t SportIdent::parseTCPPunches(const BYTE *data, size_t len) {
+  const size_t headerSize = 15;
+  size_t consumed = 0;
+  SIOnlinePunch op;
+
+  while (len - consumed >= headerSize) {
+    const BYTE *temp = data + consumed;
+    //BYTE c[15]={0, 0x64,0,0x48, 0xa4, 0x07, 00, 0x05, 00, 00, 00, 0x8d, 0x16, 0x06, 0x00};
+    //memcpy(temp, c, 15);
+    op.Type = temp[0];
+    op.CodeNo = *(WORD*)(&temp[1]);
+    op.SICardNo = *(DWORD *)(&temp[3]);
+    op.CodeDay = *(DWORD *)(&temp[7]);
+    op.CodeTime = *(DWORD *)(&temp[11]);
+
+    if (op.Type == 64 && op.CodeNo > 1 && op.CodeNo <= 192 && op.CodeTime == 0) {
+      // Recieved card
+      int nPunch = op.CodeNo;
+      size_t frameSize = headerSize + sizeof(SIPunch) * nPunch;
+      if (len - consumed < frameSize)
+        break; // Wait for the rest of the card
+
+      SICard card(ConvertedTimeStatus::Hour24);
+      card.CheckPunch.Code = -1;
+      card.StartPunch.Code = -1;
+      card.FinishPunch.Code = -1;
+      card.CardNumber = op.SICardNo;
+      for (int k = 0; k < nPunch; k++) {
+        SIPunch punch;
+        memcpy(&punch, temp + headerSize + k * sizeof(SIPunch), sizeof(SIPunch));
+        if (punch.Code == oPunch::PunchStart)
+          card.StartPunch = punch;
+        else if (punch.Code == oPunch::PunchFinish)
+          card.FinishPunch = punch;
+        else if (punch.Code == oPunch::PunchCheck)
+          card.CheckPunch = punch;
+        else
+          card.Punch[card.nPunch++] = punch;
+      }
+      addCard(card);
+      consumed += frameSize;
+    }
+    else {
+      addPunch(op.CodeTime, op.CodeNo, op.SICardNo, 0);
+      consumed += headerSize;
+    }
+  }
+  return consumed;
+}
+
 int SportIdent::MonitorTCPSI(WORD port, int localZeroTime)
 {
   tcpPortOpen=0;
@@ -846,107 +896,117 @@ int SportIdent::MonitorTCPSI(WORD port, int localZeroTime)
     closesocket(server);
     return 0;
   }
-  //we will need variables to hold the client socket.
-  //thus we declare them here.
 
-  SOCKET client;
-  sockaddr_in from;
-  int fromlen=sizeof(from);
-
-  SIOnlinePunch op;
+  // Each gateway connection has its own buffer for incomplete punches and cards.
+  struct Connection {
+    SOCKET s;
+    vector<BYTE> buffer;
+    size_t used = 0;
+    Connection(SOCKET s) : s(s) {}
+  };
+  // A card with 192 punches is the largest frame
+  const size_t maxFrameSize = 15 + 192 * sizeof(SIPunch);
+  // Read at most this much from one connection per round, so that a fast
+  // gateway cannot starve the others.
+  const size_t maxReadPerRound = 4096;
+  const size_t maxConnections = FD_SETSIZE - 1;
+  list<Connection> connections;
 
   tcpPortOpen=port;
   serverSocket=server;
 
-  while (tcpPortOpen) {
-    client=accept(server, (sockaddr*)&from, &fromlen);
-
-    if (client != INVALID_SOCKET) {
-
-      char temp[15];
+  bool serverClosed = false;
+  while (tcpPortOpen && !serverClosed) {
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    if (connections.size() < maxConnections)
+      FD_SET(server, &readSet);
+    for (auto &c : connections)
+      FD_SET(c.s, &readSet);
+
+    // Wake up regularly to check if the port has been closed
+    timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 500 * 1000;
+    int nReady = select(0, &readSet, nullptr, nullptr, &timeout);
+    if (nReady == SOCKET_ERROR) {
+      int err = WSAGetLastError();
+      if (err == WSAENOTSOCK || err == WSAEINTR || !tcpPortOpen)
+        break;
+      Sleep(100);
+      continue;
+    }
+    if (nReady == 0)
+      continue;
 
-      int r=0;
-      while (r!=-1 && tcpPortOpen) {
+    if (FD_ISSET(server, &readSet)) {
+      //we will need variables to hold the client socket.
+      //thus we declare them here.
+      sockaddr_in from;
+      int fromlen=sizeof(from);
+      SOCKET client=accept(server, (sockaddr*)&from, &fromlen);
+      if (client != INVALID_SOCKET) {
+        connections.emplace_back(client);
+        connections.back().buffer.resize(maxFrameSize);
+      }
+      else {
+        int err=WSAGetLastError();
+        if (err==WSAESHUTDOWN || err==WSAECONNABORTED || err==WSAENOTSOCK || err==WSAEINVAL)
+          serverClosed = true;
+      }
+    }
 
-        uint64_t timeout = GetTickCount64() + 1000;
-        int iter = 0;
-        while(r!=SOCKET_ERROR && r<15 && tcpPortOpen) {
-          r=recv(client, temp, 15, MSG_PEEK);
-          iter++;
-          if (iter > 10) {
-            if (GetTickCount64() > timeout) {
-              break;
-            }
-            else
-              iter = 0;
+    for (auto it = connections.begin(); it != connections.end();) {
+      Connection &c = *it;
+      bool closed = false;
+      if (FD_ISSET(c.s, &readSet)) {
+        size_t readThisRound = 0;
+        while (readThisRound < maxReadPerRound) {
+          int r = recv(c.s, (char *)c.buffer.data() + c.used, int(c.buffer.size() - c.used), 0);
+          if (r <= 0) {
+            closed = true;
+            break;
           }
-          Sleep(0);
-        }
-
-        r=recv(client, temp, 15, 0);
-
-        if (r==15) {
-          //BYTE c[15]={0, 0x64,0,0x48, 0xa4, 0x07, 00, 0x05, 00, 00, 00, 0x8d, 0x16, 0x06, 0x00};
-          //memcpy(temp, c, 15);
-          op.Type=temp[0];
-          op.CodeNo=*(WORD*)(&temp[1]);
-          op.SICardNo=*(DWORD *)(&temp[3]);
-          op.CodeDay=*(DWORD *)(&temp[7]);
-          op.CodeTime=*(DWORD *)(&temp[11]);
-
-          if (op.Type == 64 &&  op.CodeNo>1 &&  op.CodeNo<=192 && op.CodeTime == 0) {
-            // Recieved card
-            int nPunch = op.CodeNo;
-            vector<SIPunch> punches(nPunch);
-            r = recv(client, (char*)&punches[0], 8 * nPunch, 0);
-            if (r == 8 * nPunch) {
-              SICard card(ConvertedTimeStatus::Hour24);
-              card.CheckPunch.Code = -1;
-              card.StartPunch.Code = -1;
-              card.FinishPunch.Code = -1;
-              card.CardNumber = op.SICardNo;
-              for (int k = 0; k < nPunch; k++) {
-                if (punches[k].Code == oPunch::PunchStart)
-                  card.StartPunch = punches[k];
-                else if (punches[k].Code == oPunch::PunchFinish)
-                  card.FinishPunch = punches[k];
-                else if (punches[k].Code == oPunch::PunchCheck)
-                  card.CheckPunch = punches[k];
-                else
-                  card.Punch[card.nPunch++] = punches[k];
-              }
-              addCard(card);
-            }
+          c.used += r;
+          readThisRound += r;
+          size_t consumed = parseTCPPunches(c.buffer.data(), c.used);
+          if (consumed > 0) {
+            memmove(c.buffer.data(), c.buffer.data() + consumed, c.used - consumed);
+            c.used -= consumed;
           }
-          else
-            addPunch(op.CodeTime, op.CodeNo, op.SICardNo, 0);
-        }
-        else r=-1;
 
+          // Continue only if more data is already available
+          u_long avail = 0;
+          if (ioctlsocket(c.s, FIONREAD, &avail) != 0 || avail == 0)
+            break;
+        }
       }
-      //close the client socket
-      closesocket(client);
-    }
-    else {
-      int err=WSAGetLastError();
-
-      if (err==WSAESHUTDOWN || err==WSAECONNABORTED) {
-        tcpPortOpen=0;
-        serverSocket=0;
-        closesocket(server);
-        //MessageBox(0, "TCP CLOSE", 0, MB_OK);
-        return 0;
+
+      if (closed) {
+        //close the client socket
+        closesocket(c.s);
+        it = connections.erase(it);
       }
+      else
+        ++it;
     }
   }
 
-  //MessageBox(0, "TCP CLOSE BYE", 0, MB_OK);
+  for (auto &c : connections)
+    closesocket(c.s);
+  connections.clear();
 
-  //closesocket() closes the socket and releases the socket descriptor
-  closesocket(server);
+  EnterCriticalSection(&SyncObj);
+  if (serverSocket == server) {
+    tcpPortOpen=0;
+    serverSocket=0;
+    //closesocket() closes the socket and releases the socket descriptor
+    closesocket(server);
+  }
+  LeaveCriticalSection(&SyncObj);
 
   WSACleanup();
-  return 1;
+  return serverClosed ? 0 : 1;
 }
 
 bool SportIdent::MonitorTEST(SI_StationInfo &si)
@@ -2038,11 +2098,14 @@ void SportIdent::EnumrateSerialPorts(list<int>& ports)
 
 
 
-void SportIdent::addCard(const SICard &sic)
-{
+void SportIdent::enqueue(QueuedReadout &&item) {
+  bool notify = false;
   EnterCriticalSection(&SyncObj);
   try {
-    ReadCards.push_front(sic);
+    readQueue.push_back(std::move(item));
+    // Only notify once until the main thread has taken the queued readouts
+    notify = !readQueueNotified;
+    readQueueNotified = true;
   }
   catch(...) {
     LeaveCriticalSection(&SyncObj);
@@ -2050,18 +2113,26 @@ void SportIdent::addCard(const SICard &sic)
   }
   LeaveCriticalSection(&SyncObj);
 
-  PostMessage(hWndNotify, WM_USER, ClassId, 0);
+  if (notify)
+    PostMessage(hWndNotify, WM_USER, ClassId, 0);
+}
+
+void SportIdent::addCard(const SICard &sic)
+{
+  QueuedReadout item;
+  item.kind = QueuedReadout::Kind::Card;
+  item.cardNo = sic.CardNumber;
+  item.card = make_unique<SICard>(sic);
+  enqueue(std::move(item));
 }
 
 void SportIdent::addPunch(DWORD Time, int Station, int Card, int Mode) {
   if (!useSubsecondMode)
     Time -= (Time % timeConstSecond);
 
-  SICard sic(ConvertedTimeStatus::Hour24);
-  sic.CardNumber = Card;
-  sic.StartPunch.Code = -1;
-  sic.CheckPunch.Code = -1;
-  sic.FinishPunch.Code = -1;
+  QueuedReadout item;
+  item.cardNo = Card;
+  item.punch.Time = Time;
 
   auto mapPunch = [this](int code) {
     if (code > 0 && code < punchMap.size() && punchMap[code] > 0)
@@ -2085,63 +2156,96 @@ void SportIdent::addPunch(DWORD Time, int Station, int Card, int Mode) {
     }
 
     if (mappedCode > 30) {
-      sic.Punch[0].Code = Station;
-      sic.Punch[0].Time = Time;
-      sic.nPunch = 1;
+      item.kind = QueuedReadout::Kind::Punch;
+      item.punch.Code = Station;
     }
     else if (mappedCode == oPunch::PunchStart) {
-      sic.StartPunch.Time = Time;
-      sic.StartPunch.Code = unit;
+      item.kind = QueuedReadout::Kind::Start;
+      item.punch.Code = unit;
     }
     else if (mappedCode == oPunch::PunchCheck) {
-      sic.CheckPunch.Time = Time;
-      sic.CheckPunch.Code = unit;
+      item.kind = QueuedReadout::Kind::Check;
+      item.punch.Code = unit;
     }
     else {
-      sic.FinishPunch.Time = Time;
-      sic.FinishPunch.Code = unit;
+      item.kind = QueuedReadout::Kind::Finish;
+      item.punch.Code = unit;
     }
   }
   else {
-    if (Mode == 0x02 || Mode == 50) {
-      sic.Punch[0].Code = Station;
-      sic.Punch[0].Time = Time;
-      sic.nPunch = 1;
-    }
-    else if (Mode == 3) {
-      sic.StartPunch.Time = Time;
-      sic.StartPunch.Code = Station;
-    }
-    else if (Mode == 10 || Mode == 7) { // Treat clear as check
-      sic.CheckPunch.Time = Time;
-      sic.CheckPunch.Code = Station;
-    }
-    else {
-      sic.FinishPunch.Time = Time;
-      sic.FinishPunch.Code = Station;
-    }
+    item.punch.Code = Station;
+    if (Mode == 0x02 || Mode == 50)
+      item.kind = QueuedReadout::Kind::Punch;
+    else if (Mode == 3)
+      item.kind = QueuedReadout::Kind::Start;
+    else if (Mode == 10 || Mode == 7) // Treat clear as check
+      item.kind = QueuedReadout::Kind::Check;
+    else
+      item.kind = QueuedReadout::Kind::Finish;
   }
-  sic.punchOnly = true;
 
-  addCard(sic);
+  enqueue(std::move(item));
 }
 
 
 bool SportIdent::getCard(SICard &sic)
 {
-  bool ret=false;
-
-  EnterCriticalSection(&SyncObj);
+  if (readBatch.empty()) {
+    // Take all queued readouts at once
+    EnterCriticalSection(&SyncObj);
+    readBatch.swap(readQueue);
+    readQueueNotified = false;
+    LeaveCriticalSection(&SyncObj);
 
-  if (!ReadCards.empty()) {
-    sic=ReadCards.front();
-    ReadCards.pop_front();
-    ret=true;
+    if (readBatch.empty())
+      return false;
   }
 
-  LeaveCriticalSection(&SyncObj);
+  QueuedReadout &item = readBatch.front();
+  if (item.kind == QueuedReadout::Kind::Card) {
+    sic = *item.card;
+  }
+  else {
+    sic.clear(nullptr);
+    sic.convertedTime = ConvertedTimeStatus::Hour24;
+    sic.CardNumber = item.cardNo;
+    sic.StartPunch.Code = -1;
+    sic.CheckPunch.Code = -1;
+    sic.FinishPunch.Code = -1;
+    switch (item.kind) {
+    case QueuedReadout::Kind::Punch:
+      sic.Punch[0] = item.punch;
+      sic.nPunch = 1;
+      break;
+    case QueuedReadout::Kind::Start:
+      sic.StartPunch = item.punch;
+      break;
+    case QueuedReadout::Kind::Check:
+      sic.CheckPunch = item.punch;
+      break;
+    default:
+      sic.FinishPunch = item.punch;
+    }
+    sic.punchOnly = true;
+  }
+  readBatch.pop_front();
+  return true;
+}
 
-  return ret;
+void SportIdent::processReadouts(const std::function<void(SICard &)> &process) {
+  SICard sic(ConvertedTimeStatus::Unknown);
+  std::exception_ptr error;
+  while (getCard(sic)) {
+    try {
+      process(sic);
+    }
+    catch (...) {
+      if (!error)
+        error = std::current_exception();
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
 }
 
 void start_si_thread(void *ptr)
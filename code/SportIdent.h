@@ -3,6 +3,7 @@
 //////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <functional>
 #include <set>
 #include <vector>
 #include "oPunch.h"
@@ -201,8 +202,30 @@ protected:
   bool analysePunch(BYTE *data, DWORD &time, DWORD &control, bool subSecond);
   void analyseTPunch(BYTE *data, DWORD &time, DWORD &control);
 
-  //Card read waiting to be processed.
-  list<SICard> ReadCards;
+  /** A punch or card waiting to be processed. Punches are stored compactly,
+      a full card is only allocated for card readouts. */
+  struct QueuedReadout {
+    enum class Kind : BYTE {
+      Punch,
+      Start,
+      Check,
+      Finish,
+      Card
+    };
+    Kind kind = Kind::Punch;
+    DWORD cardNo = 0;
+    SIPunch punch = {};
+    unique_ptr<SICard> card;
+  };
+
+  //Cards and punches waiting to be processed, in the order received.
+  deque<QueuedReadout> readQueue;
+  // True if the main window has been notified about readQueue
+  bool readQueueNotified = false;
+  // Readouts taken from readQueue by the main thread but not yet processed
+  deque<QueuedReadout> readBatch;
+
+  void enqueue(QueuedReadout &&item);
   HWND hWndNotify;
   DWORD ClassId;
 
@@ -212,6 +235,8 @@ protected:
   bool MonitorTEST(SI_StationInfo &si);
   bool MonitorSI(SI_StationInfo &si);
   int MonitorTCPSI(WORD port, int localZeroTime);
+  /** Parse complete punches and cards received from a TCP gateway. Returns the number of bytes used. */
+  size_t parseTCPPunches(const BYTE *data, size_t len);
 
   struct TestCard {
     int cardNo;
@@ -256,6 +281,9 @@ public:
 
   void startMonitorThread(const wchar_t *com);
   bool getCard(SICard &sic);
+  /** Take and process all queued readouts. If process throws, the rest of the
+      readouts are still processed and the first exception is rethrown afterwards. */
+  void processReadouts(const std::function<void(SICard &)> &process);
   void addCard(const SICard &sic);
   void addPunch(DWORD Time, int Station, int Card, int Mode=0);
 
@@ -3693,7 +3693,7 @@ FlowOperation TabCompetition::checkStageFilter(gdioutput & gdi,
                                                set<int>& filter,
                                                pair<string, string> &preferredIdProvider) {
   xmlparser xml;
-  xml.read(fname);
+  xml.openStream(fname);
   xmlobject xo = xml.getObject("EntryList");
   set<int> scanFilter;
   IOF30Interface reader(oe, false, false);
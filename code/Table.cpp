@@ -173,18 +173,32 @@ TableRow *Table::getRowById(int rowId) {
   return 0;
 }
 
-void Table::addRow(int rowId, oBase *object)
+bool Table::addRow(int rowId, oBase *object)
 {
   int ix;
   if (rowId>0 && idToRow.lookup(rowId, ix)) {
     dataPointer = ix;
-    return;
+    TableRow &row = Data[ix];
+    row.updated = updateRound;
+    row.order = generatedRows++;
+    if (row.ob == object && object && generatedRevision >= 0 &&
+        !object->isRowChangedSince(generatedRevision))
+      return false;
+
+    row.ob = object;
+    return true;
   }
 
+  if (rowId <= 0)
+    hasUnkeyedRows = true;
+
   dataRowToIndex.clear();
   TableRow tr(nTitles, object);
   tr.height=rowHeight;
   tr.id = rowId;
+  tr.updated = updateRound;
+  tr.changed = true;
+  tr.order = generatedRows++;
   TableSortIndex tsi;
 
   if (Data.empty()) {
@@ -198,8 +212,8 @@ void Table::addRow(int rowId, oBase *object)
     Data.resize(2, tr);
 
     for (unsigned i=0;i<nTitles;i++) {
-      Data[0].cells[i].contents=Titles[i].name;
-      Data[1].cells[i].contents = L"...";
+      Data[0].cells[i].setContents(Titles[i].name);
+      Data[1].cells[i].setContents(L"...");
 
       Data[0].cells[i].canEdit=false;
       Data[0].cells[i].type=cellEdit;
@@ -220,6 +234,7 @@ void Table::addRow(int rowId, oBase *object)
   dataPointer = Data.size();
   sortIndex.push_back(tsi);
   Data.push_back(tr);
+  return true;
 }
 
 void Table::set(int column, oBase &owner, int id, const wstring &data, bool canEdit, CellType type)
@@ -229,8 +244,14 @@ void Table::set(int column, oBase &owner, int id, const wstring &data, bool canE
 
   TableRow &row=Data[dataPointer];
   TableCell &cell=row.cells[column];
-  cell.contents=data;
-  cell.ownerRef = owner.getReference();
+  if (cell.contents != data) {
+    cell.setContents(data);
+    row.changed = true;
+    if (size_t(column) < changedColumns.size())
+      changedColumns[column] = true;
+  }
+  if (cell.ownerRef != owner.getReference())
+    cell.ownerRef = owner.getReference();
   cell.id=id;
   cell.canEdit=canEdit;
   cell.type=type;
@@ -284,16 +305,76 @@ void Table::filter(int col, const wstring &filt, bool forceFilter)
   }
 }
 
+void TableCell::computeKeys() const {
+  const wchar_t *str = contents.c_str();
+
+  int i = 0;
+  while (str[i] != 0 && str[i] != ':' && str[i] != ',' && str[i] != '.')
+    i++;
+  hasSeparator = str[i] != 0;
+
+  i = 0;
+  while (str[i] != 0 && (str[i] < '0' || str[i] > '9'))
+    i++;
+
+  numKey = _wtoi(str + i);
+
+  // Times etc. Digits followed by up to four decimals
+  int key = 0;
+  while (str[i] >= '0' && str[i] <= '9') {
+    key = key * 10 + (str[i] - '0');
+    i++;
+  }
+
+  if (str[i] == ':' || str[i]==',' || str[i] == '.' || (str[i] == '-' && key != 0)) {
+    bool valid = true;
+    for (int j = 1; j <= 4; j++) {
+      if (valid && str[i+j] >= '0' && str[i+j] <= '9')
+        key = key * 10 + (str[i+j] - '0');
+      else {
+        key *= 10;
+        valid = false;
+      }
+    }
+  }
+  else {
+    key *= 10000;
+  }
+  timeKey = key;
+
+  // Upper case prefix of (at most) two ASCII characters
+  wchar_t prefix[2] = {0, 0};
+  int len = min<int>(contents.length(), 2);
+  for (int j = 0; j < len; j++)
+    prefix[j] = str[j];
+  if (len > 0)
+    CharUpperBuff(prefix, len);
+
+  if (((prefix[0]|prefix[1]) & ~127) == 0) {
+    prefixKey = unsigned(prefix[0])<<16;
+    if (len > 1)
+      prefixKey |= unsigned(prefix[1])<<8;
+  }
+  else {
+    prefixKey = 0xFEFEFEFE;
+  }
+
+  keysValid = true;
+}
+
 bool Table::compareRow(int indexA, int indexB) const {
   const TableRow &a = Data[indexA];
   const TableRow &b = Data[indexB];
   if (a.intKey != b.intKey && (a.intKey != 0xFEFEFEFE && b.intKey != 0xFEFEFEFE))
     return a.intKey < b.intKey;
-  else
-    return CompareString( LOCALE_USER_DEFAULT, 0, Data[indexA].key.c_str(), Data[indexA].key.length(),
-                                                  Data[indexB].key.c_str(), Data[indexB].key.length()) == CSTR_LESS_THAN;
-    //return Data[indexA].key < Data[indexB].key;
-    //return Data[indexA].key < Data[indexB].key;
+  else {
+    // Text columns without a copied key are compared on the contents of the sort column.
+    // Numeric rows with equal nonzero keys have empty keys and keep their order.
+    const wstring &ka = sortIgnoreCase ? a.cells[currentSortColumn].contents : a.key;
+    const wstring &kb = sortIgnoreCase ? b.cells[currentSortColumn].contents : b.key;
+    return CompareString(LOCALE_USER_DEFAULT, sortIgnoreCase ? NORM_IGNORECASE : 0,
+                         ka.c_str(), ka.length(), kb.c_str(), kb.length()) == CSTR_LESS_THAN;
+  }
 }
 
 void Table::sort(int col, bool forceDirection)
@@ -310,66 +391,26 @@ void Table::sort(int col, bool forceDirection)
 
   currentSortColumn=col;
   if (forceDirection || (PrevSort!=col && PrevSort!=-(10+col))) {
+    sortIgnoreCase = false;
     if (Titles[col].isnumeric) {
+      // Use times (with decimals) if any row has a separator, otherwise integers
       bool hasDeci = false;
       for(size_t k=2; k<sortIndex.size(); k++){
-        Data[sortIndex[k].index].key.clear();
-        const wchar_t *str = Data[sortIndex[k].index].cells[col].contents.c_str();
-
-        int i = 0;
-        while (str[i] != 0 && str[i] != ':' && str[i] != ',' && str[i] != '.')
-          i++;
-
-        if (str[i]) {
+        const TableCell &cell = Data[sortIndex[k].index].cells[col];
+        if (!cell.keysValid)
+          cell.computeKeys();
+        if (cell.hasSeparator)
           hasDeci = true;
-          break;
-        }
-
-        i = 0;
-        while (str[i] != 0 && (str[i] < '0' || str[i] > '9'))
-          i++;
-
-        int key = _wtoi(str + i);
-        Data[sortIndex[k].index].intKey = key;
-        if (key == 0)
-          Data[sortIndex[k].index].key = Data[sortIndex[k].index].cells[col].contents; 
       }
 
-      if (hasDeci) { // Times etc.
-       for(size_t k=2; k<sortIndex.size(); k++){
-          Data[sortIndex[k].index].key.clear();
-          const wchar_t *str = Data[sortIndex[k].index].cells[col].contents.c_str();
-
-          int i = 0;
-          while (str[i] != 0 && (str[i] < '0' || str[i] > '9'))
-            i++;
-
-          int key = 0;
-
-          while (str[i] >= '0' && str[i] <= '9') {
-            key = key * 10 + (str[i] - '0');
-            i++;
-          }
-
-          if (str[i] == ':' || str[i]==',' || str[i] == '.' || (str[i] == '-' && key != 0)) {
-            bool valid = true;
-            for (int j = 1; j <= 4; j++) {
-              if (valid && str[i+j] >= '0' && str[i+j] <= '9')
-                key = key * 10 + (str[i+j] - '0');
-              else {
-                key *= 10;
-                valid = false;
-              }
-            }
-          }
-          else {
-            key *= 10000;
-          }
-
-          Data[sortIndex[k].index].intKey = key;
-          if (key == 0)
-            Data[sortIndex[k].index].key = Data[sortIndex[k].index].cells[col].contents; 
-        }
+      for(size_t k=2; k<sortIndex.size(); k++){
+        TableRow &row = Data[sortIndex[k].index];
+        const TableCell &cell = row.cells[col];
+        row.intKey = hasDeci ? cell.timeKey : cell.numKey;
+        if (row.intKey == 0)
+          row.key = cell.contents;
+        else
+          row.key.clear();
       }
     }
     else {
@@ -399,24 +440,15 @@ void Table::sort(int col, bool forceDirection)
         }
       }
       else {
+        // Compare the contents directly, ignoring case, without copying
+        sortIgnoreCase = true;
         for (size_t k=2; k<sortIndex.size(); k++) {
-          wstring &key = Data[sortIndex[k].index].key;
-          key = Data[sortIndex[k].index].cells[col].contents;
-          const wchar_t *strBuff = (const wchar_t *)key.c_str();
-          CharUpperBuff(LPWSTR(strBuff), key.size());
-
-          int &intKey = Data[sortIndex[k].index].intKey;
-          
-          if ( ((strBuff[0]|strBuff[1]) & ~127) == 0) {
-            intKey = unsigned(strBuff[0])<<16;
-            if (key.length() > 1) {
-              intKey |= unsigned(strBuff[1])<<8;
-              //intKey |= unsigned(strBuff[2]);
-            }
-          }
-          else {
-            intKey = 0xFEFEFEFE;
-          }
+          TableRow &row = Data[sortIndex[k].index];
+          const TableCell &cell = row.cells[col];
+          if (!cell.keysValid)
+            cell.computeKeys();
+          row.key.clear();
+          row.intKey = cell.prefixKey;
         }
       }
     }
@@ -762,6 +794,7 @@ bool Table::keyCommand(gdioutput &gdi, KeyCommandCode code) {
     }
     else if (code == KC_REFRESH) {
       gdi.setWaitCursor(true);
+      generatedRevision = -1; // Regenerate all rows
       update();
       autoAdjust(gdi);
       gdi.refresh();
@@ -828,6 +861,7 @@ void Table::clear() {
   Data.clear();
   sortIndex.clear();
   idToRow.clear();
+  hasUnkeyedRows = false;
 }
 
 bool Table::destroyEditControl(gdioutput &gdi) {
@@ -1810,7 +1844,7 @@ void Table::setTableText(gdioutput &gdi, int editRow, int editCol, const wstring
   TableCell &cell=Data[editRow].cells[editCol];
   if (cell.hasOwner())
     cell.getOwner()->inputData(cell.id, bf, 0, output, false);
-  cell.contents = output;
+  cell.setContents(output);
   if (hEdit != 0)
     DestroyWindow(hEdit);
   hEdit=0;
@@ -1948,7 +1982,10 @@ void Table::reloadRow(int rowId)
     TableUpdateInfo tui;
     tui.object = obj;
     tui.id = rowId;
+    long revision = generatedRevision;
+    generatedRevision = -1; // Always generate the reloaded row
     oe->generateTableData(internalName, *this, tui);
+    generatedRevision = revision;
   }
 }
 
@@ -2019,16 +2056,13 @@ void Table::resetColumns()
   doAutoSelectColumns = false;
 }
 
-void Table::update()
+void Table::rebuild()
 {
-  for (auto &dd : dataDefiners)
-    dd.second->prepare(oe);
   int oldSort = PrevSort;
   Data.clear();
   sortIndex.clear();
   idToRow.clear();
-
-  clearCellSelection(0);
+  hasUnkeyedRows = false;
 
   if (generator == 0) {
     TableUpdateInfo tui;
@@ -2045,6 +2079,148 @@ void Table::update()
   PrevSort = -1;
   if (oldSort != -1)
     sort(oldSort, false);
+}
+
+void Table::removeUntouchedRows()
+{
+  vector<int> newIndex(Data.size(), -1);
+  vector<TableRow> kept;
+  kept.reserve(Data.size());
+  for (size_t k = 0; k < Data.size(); k++) {
+    if (k < 2 || Data[k].updated == updateRound) {
+      newIndex[k] = kept.size();
+      kept.push_back(Data[k]);
+    }
+  }
+  swap(Data, kept);
+
+  idToRow.clear();
+  for (size_t k = 2; k < Data.size(); k++)
+    idToRow[Data[k].id] = k;
+
+  size_t j = 0;
+  for (size_t k = 0; k < sortIndex.size(); k++) {
+    int ix = newIndex[sortIndex[k].index];
+    if (ix >= 0) {
+      sortIndex[j] = sortIndex[k];
+      sortIndex[j++].index = ix;
+    }
+  }
+  sortIndex.resize(j);
+}
+
+void Table::update()
+{
+  for (auto &dd : dataDefiners)
+    dd.second->prepare(oe);
+
+  clearCellSelection(0);
+  updateRound++;
+  generatedRows = 0;
+  long revision = oe->getRevision();
+
+  if (Data.size() <= 2 || hasUnkeyedRows) {
+    rebuild();
+    generatedRevision = revision;
+    commandLock = false; // Reset lock
+    return;
+  }
+
+  // Regenerate the rows in place. Rows are matched by id; only cells with new
+  // contents are assigned, and only changed rows need to be filtered again.
+  // Rows of objects that report no change since the last update (including the
+  // objects the cells depend on, such as places) are not regenerated.
+  changedColumns.assign(nTitles, false);
+  for (size_t k = 2; k < Data.size(); k++)
+    Data[k].changed = false;
+
+  size_t oldIndexSize = sortIndex.size();
+  if (generator == 0) {
+    TableUpdateInfo tui;
+    oe->generateTableData(internalName, *this, tui);
+  }
+  else {
+    generator(*this, generatorPtr);
+  }
+  bool addedRows = sortIndex.size() != oldIndexSize;
+  generatedRevision = revision;
+
+  for (size_t k = 2; k < Data.size(); k++) {
+    if (Data[k].updated != updateRound) {
+      removeUntouchedRows();
+      break;
+    }
+  }
+
+  vector<pair<int, wstring>> filters;
+  for (size_t k = 0; k < nTitles; k++) {
+    if (!Titles[k].filter.empty()) {
+      wstring filt_lc = Titles[k].filter;
+      prepareMatchString(&filt_lc[0], filt_lc.length());
+      filters.emplace_back(k, filt_lc);
+    }
+  }
+
+  if (!filters.empty()) {
+    vector<bool> inIndex(Data.size());
+    for (size_t k = 2; k < sortIndex.size(); k++)
+      inIndex[sortIndex[k].index] = true;
+
+    bool removed = false;
+    for (size_t k = 2; k < Data.size(); k++) {
+      if (!Data[k].changed)
+        continue;
+      bool match = true;
+      for (auto &f : filters) {
+        int score;
+        if (!filterMatchString(Data[k].cells[f.first].contents, f.second.c_str(), score)) {
+          match = false;
+          break;
+        }
+      }
+      if (match && !inIndex[k]) {
+        TableSortIndex tsi;
+        tsi.index = k;
+        sortIndex.push_back(tsi);
+        inIndex[k] = true;
+        addedRows = true;
+      }
+      else if (!match && inIndex[k]) {
+        inIndex[k] = false;
+        removed = true;
+      }
+    }
+
+    if (removed) {
+      size_t j = 2;
+      for (size_t k = 2; k < sortIndex.size(); k++) {
+        if (inIndex[sortIndex[k].index])
+          sortIndex[j++] = sortIndex[k];
+      }
+      sortIndex.resize(j);
+    }
+  }
+
+  dataRowToIndex.clear();
+
+  if (PrevSort != -1) {
+    int sortCol = PrevSort < 0 ? -(10 + PrevSort) : PrevSort;
+    if (addedRows || changedColumns[sortCol]) {
+      int oldSort = PrevSort;
+      PrevSort = -1;
+      sort(oldSort, false);
+    }
+  }
+  else {
+    // An unsorted table is shown in generated order. New rows are appended,
+    // and existing rows may have been generated in another order.
+    auto generatedOrder = [this](const TableSortIndex &a, const TableSortIndex &b) {
+      return Data[a.index].order < Data[b.index].order;
+    };
+    if (!is_sorted(sortIndex.begin() + 2, sortIndex.end(), generatedOrder))
+      std::sort(sortIndex.begin() + 2, sortIndex.end(), generatedOrder);
+  }
+
   commandLock = false; // Reset lock
 }
 
@@ -2363,12 +2539,12 @@ void Table::importClipboard(gdioutput &gdi)
           if (index != -1) {
             if (cell.hasOwner())
               cell.getOwner()->inputData(cell.id, table[k][j], index, output, false);
-            cell.contents = output;
+            cell.setContents(output);
           }
           else /*if (cell.type == cellCombo)*/ {
             if (cell.hasOwner())
              cell.getOwner()->inputData(cell.id, table[k][j], index, output, false);
-            cell.contents = output;
+            cell.setContents(output);
           }
         }
         catch (const meosException &ex) {
@@ -54,6 +54,20 @@ class TableCell
   bool canEdit;
   CellType type;
 
+  // Sort keys parsed from contents. Computed on demand and reset when contents change.
+  mutable int numKey = 0;
+  mutable int timeKey = 0;
+  mutable int prefixKey = 0;
+  mutable bool hasSeparator = false;
+  mutable bool keysValid = false;
+
+  void setContents(const wstring &str) {
+    contents = str;
+    keysValid = false;
+  }
+
+  void computeKeys() const;
+
 
   friend class TableRow;
   friend class Table;
@@ -61,7 +75,7 @@ class TableCell
 
 public:
   void update(CellType t, const wstring &str) {
-    contents = str;
+    setContents(str);
     type = t;
   }
 };
@@ -82,6 +96,12 @@ protected:
   int height;
   oBase *ob;
 
+  // Update round in which the row was last generated, and if any cell was changed
+  int updated = 0;
+  bool changed = false;
+  // Position when the rows were last generated
+  int order = 0;
+
 public:
   oBase *getObject() const {return ob;}
   void setObject(oBase &obj);
@@ -105,6 +125,8 @@ public:
     SortString=&cells[0].contents;
     ob = t.ob;
     id = t.id;
+    updated = t.updated;
+    changed = t.changed;
   }
   friend class Table;
   friend struct TableSortIndex;
@@ -160,6 +182,16 @@ protected:
   vector<int> columns;
   mutable vector<int> dataRowToIndex;
   inthashmap idToRow;
+
+  // State for updating the table in place, see update()
+  int updateRound = 0;
+  bool hasUnkeyedRows = false;
+  // Data revision when the rows were last generated, -1 if all rows must be generated
+  long generatedRevision = -1;
+  int generatedRows = 0;
+  vector<bool> changedColumns;
+  void rebuild();
+  void removeUntouchedRows();
   int highRow;
   int highCol;
 
@@ -275,6 +307,8 @@ protected:
   void getRowRect(int row, RECT &rc) const;
 
   bool compareRow(int indexA, int indexB) const;
+  // Compare the contents of the sort column ignoring case instead of the row keys
+  bool sortIgnoreCase = false;
 
   map<string, const oDataDefiner *> dataDefiners;
 public:
@@ -377,7 +411,9 @@ public:
   void reserve(size_t siz);
 
   TableRow *getRowById(int rowId);
-  void addRow(int rowId, oBase *object);
+  /** Add a row, or mark an existing row with the same id as present. Returns false if the
+      existing row of the object is unchanged, so that its cells need not be set again. */
+  bool addRow(int rowId, oBase *object);
   void set(int column, oBase &owner, int id, const wstring &data,
            bool canEdit=true, CellType type=cellEdit);
 
@@ -54,7 +54,7 @@ void AutoTask::autoSave() {
       if (oe.getNumRunners() > 500)
         gdi.setWaitCursor(true);
 
-      oe.save();
+      oe.autoSave();
     }
     catch (meosException &ex) {
       msg = ex.wwhat();
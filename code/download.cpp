@@ -275,6 +275,17 @@ bool Download::successful()
 
 void Download::postFile(const wstring &url, const wstring &file, const wstring &fileOut,
                         const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw) {
+  post(url, &file, nullptr, &fileOut, nullptr, headers, pw);
+}
+
+void Download::postData(const wstring &url, const string &data, string &response,
+                        const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw) {
+  post(url, nullptr, &data, nullptr, &response, headers, pw);
+}
+
+void Download::post(const wstring &url, const wstring *upFile, const string *upData,
+                    const wstring *outFile, string *outData,
+                    const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw) {
   SetLastError(0);
   DWORD_PTR dw = 0;
   URL_COMPONENTS uc;
@@ -302,7 +313,7 @@ void Download::postFile(const wstring &url, const wstring &file, const wstring &
   bool vsuccess = false;
   int errorCode = 0;
   try {
-    vsuccess = httpSendReqEx(hConnect, https, path, headers, file, fileOut, pw, errorCode);
+    vsuccess = httpSendReqEx(hConnect, https, path, headers, upFile, upData, outFile, outData, pw, errorCode);
   }
   catch (std::exception &) {
     InternetCloseHandle(hConnect);
@@ -323,7 +334,8 @@ void Download::postFile(const wstring &url, const wstring &file, const wstring &
 
 bool Download::httpSendReqEx(HINTERNET hConnect, bool https, const wstring &dest,
                              const vector< pair<wstring, wstring> > &headers,
-                             const wstring &upFile, const wstring &outFile, 
+                             const wstring *upFile, const string *upData,
+                             const wstring *outFile, string *outData,
                              ProgressWindow &pw, 
                              int &errorCode) const {
   errorCode = 0;
@@ -358,56 +370,76 @@ bool Download::httpSendReqEx(HINTERNET hConnect, bool https, const wstring &dest
   int retry = 5;
   while (retry>0) {
 
-    HANDLE hFile = CreateFile(upFile.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    HANDLE hFile = NULL;
+    if (upFile) {
+      hFile = CreateFile(upFile->c_str(), GENERIC_READ, FILE_SHARE_READ,
+                         NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
 
-    if (hFile == HANDLE(-1))
-      return false;
+      if (hFile == HANDLE(-1))
+        return false;
 
+      BufferIn.dwBufferTotal = GetFileSize (hFile, NULL);
+    }
+    else
+      BufferIn.dwBufferTotal = DWORD(upData->size());
 
-    BufferIn.dwBufferTotal = GetFileSize (hFile, NULL);
     BufferIn.dwHeadersLength = hdr.length();
     BufferIn.lpcszHeader = hdr.c_str();
 
     double totSize = BufferIn.dwBufferTotal;
 
     if (!HttpSendRequestEx( hRequest, &BufferIn, NULL, 0, 0)) {
-      CloseHandle(hFile);
+      if (hFile)
+        CloseHandle(hFile);
       InternetCloseHandle(hRequest);
       return false;
     }
 
     DWORD sum = 0;
     do {
-      if (!ReadFile (hFile, pBuffer, sizeof(pBuffer), &dwBytesRead, NULL)) {
-        errorCode = GetLastError();
-        CloseHandle(hFile);
-        InternetCloseHandle(hRequest);
-        return false;
+      const BYTE *src = pBuffer;
+      if (hFile) {
+        if (!ReadFile (hFile, pBuffer, sizeof(pBuffer), &dwBytesRead, NULL)) {
+          errorCode = GetLastError();
+          CloseHandle(hFile);
+          InternetCloseHandle(hRequest);
+          return false;
+        }
+      }
+      else {
+        // Send directly from the memory buffer, in the same block size as for files
+        dwBytesRead = DWORD(min<size_t>(sizeof(pBuffer), upData->size() - sum));
+        src = (const BYTE *)upData->data() + sum;
       }
 
       if (dwBytesRead > 0) {
-        if (!InternetWriteFile(hRequest, pBuffer, dwBytesRead, &dwBytesWritten)) {
+        if (!InternetWriteFile(hRequest, src, dwBytesRead, &dwBytesWritten)) {
           errorCode = GetLastError();
-          CloseHandle(hFile);
+          if (hFile)
+            CloseHandle(hFile);
           InternetCloseHandle(hRequest);
           return false;
         }
       }
+      else
+        dwBytesWritten = 0;
       sum += dwBytesWritten;
 
       try {
-        pw.setProgress(int(1000 * double(sum) / totSize));
+        if (totSize > 0)
+          pw.setProgress(int(1000 * double(sum) / totSize));
       }
       catch (std::exception &) {
-        CloseHandle(hFile);
+        if (hFile)
+          CloseHandle(hFile);
         InternetCloseHandle(hRequest);
         throw;
       }
     }
     while (dwBytesRead == sizeof(pBuffer)) ;
 
-    CloseHandle(hFile);
+    if (hFile)
+      CloseHandle(hFile);
 
     if (!HttpEndRequest(hRequest, NULL, 0, 0)) {
       DWORD error = GetLastError();
@@ -463,12 +495,24 @@ bool Download::httpSendReqEx(HINTERNET hConnect, bool https, const wstring &dest
     }
   }
 
+  if (outData) {
+    outData->clear();
+    do {
+      dwBytesRead=0;
+      if (InternetReadFile(hRequest, pBuffer, sizeof(pBuffer), &dwBytesRead))
+        outData->append((const char *)pBuffer, dwBytesRead);
+    } while(dwBytesRead>0);
+
+    InternetCloseHandle(hRequest);
+    return true;
+  }
+
 //  int rfileno = _wopen(outFile.c_str(), O_BINARY|O_CREAT|O_WRONLY|O_TRUNC, S_IREAD|S_IWRITE);
   int rfileno;
-  errno_t err = _wsopen_s(&rfileno, outFile.c_str(), _O_BINARY | _O_CREAT | _O_WRONLY | _O_TRUNC, _SH_DENYWR, _S_IREAD | _S_IWRITE);
+  errno_t err = _wsopen_s(&rfileno, outFile->c_str(), _O_BINARY | _O_CREAT | _O_WRONLY | _O_TRUNC, _SH_DENYWR, _S_IREAD | _S_IWRITE);
   if (err != 0) {
     InternetCloseHandle(hRequest);
-    throw meosException(L"Failed to open + " + outFile);
+    throw meosException(L"Failed to open + " + *outFile);
   }
 
   do {
@@ -60,13 +60,23 @@ private:
   bool success;
   void initThread();
 
+  /** Upload from either upFile or upData, and store the response in either outFile or outData. */
   bool httpSendReqEx(HINTERNET hConnect, bool https, const wstring &dest, const vector< pair<wstring, wstring> > &headers,
-                     const wstring &upFile, const wstring &outFile, ProgressWindow &pw, int &errroCode) const;
+                     const wstring *upFile, const string *upData,
+                     const wstring *outFile, string *outData, ProgressWindow &pw, int &errroCode) const;
+
+  void post(const wstring &url, const wstring *upFile, const string *upData,
+            const wstring *outFile, string *outData,
+            const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw);
 
 public:
 
   void postFile(const wstring &url, const wstring &file, const wstring &fileOut,
                 const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw);
+
+  /** Post a memory buffer and return the response in memory. */
+  void postData(const wstring &url, const string &data, string &response,
+                const vector< pair<wstring, wstring> > &headers, ProgressWindow &pw);
   int processMessages();
   bool successful();
   bool isWorking();
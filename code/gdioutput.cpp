@@ -147,7 +147,7 @@ void gdioutput::constructor(double _scale)
 
   manualUpdate = false;
 
-  itTL = TL.end();
+  invalidateTextIndex();
 
   hWndTarget = 0;
   hWndToolTip = 0;
@@ -211,6 +211,7 @@ void gdioutput::scaleSize(double scale_, bool allowSmallScale, ScaleOperation op
     it->xp = transformX(it->xp, scale_);
     it->yp = int(it->yp * scale_ + 0.5);
   }
+  invalidateTextIndex();
   int w, h;
   OffsetY = int (OffsetY * scale_ + 0.5);
   OffsetX = int (OffsetX * scale_ + 0.5);
@@ -302,6 +303,7 @@ void gdioutput::initCommon(double _scale, const wstring &font) {
   Background=CreateSolidBrush(GetSysColor(COLOR_WINDOW));
 
   fontHeightCache.clear();
+  textSizeCache.clear();
   fonts[currentFont].init(scale, currentFont, L"");
   
   lineHeight = getFontHeight(0, currentFont) + scaleLength(0.2);
@@ -672,10 +674,9 @@ void gdioutput::draw(HDC hDC, RECT& rc, RECT& drawArea) {
     }
 
   resetLast();
-  TIList::iterator it;
+  updateTextIndex();
 
-  int BoundYup = OffsetY - maxTextBlockHeight - 2 + drawArea.top;
-  int BoundYupTight = OffsetY - 2 + drawArea.top;
+  int BoundYup = OffsetY - max(maxTextBlockHeight, textIndexMaxHeight) - 2 + drawArea.top;
   int BoundYdown = OffsetY + drawArea.bottom + 2;
 
   for (auto imgTL : imageReferences) {
@@ -685,38 +686,15 @@ void gdioutput::draw(HDC hDC, RECT& rc, RECT& drawArea) {
   if (renderMap)
     renderMap->renderDecoration(hDC, *this);
 
-  if (!renderOptimize || itTL == TL.end()) {
 #ifdef DEBUGRENDER
-    //if (breakRender)
-    //  DebugBreak();
-    OutputDebugString(("Raw render" + itos(size_t(this)) + "\n").c_str());
+  OutputDebugString((itos(++counterRender) + " render " + itos(size_t(this)) + "\n").c_str());
 #endif
-    for (it = TL.begin(); it != TL.end(); ++it) {
-      TextInfo& ti = *it;
-      if ((ti.format & 0xFF) == textImage)
-        continue;
-      if ((ti.yp > BoundYup || ti.textRect.bottom > BoundYupTight) && ti.yp < BoundYdown)
-        RenderString(*it, hDC);
-    }
-  }
-  else {
-#ifdef DEBUGRENDER
-    OutputDebugString((itos(++counterRender) + " opt render " + itos(size_t(this)) + "\n").c_str());
-#endif
-
-    while (itTL != TL.end() && itTL->yp < BoundYup)
-      ++itTL;
 
-    if (itTL != TL.end())
-      while (itTL != TL.begin() && itTL->yp > BoundYup)
-        --itTL;
-
-    it = itTL;
-    while (it != TL.end() && it->yp < BoundYdown) {
-      if ((it->format & 0xFF) != textImage)
-        RenderString(*it, hDC);
-      ++it;
-    }
+  vector<TextInfo*> visible;
+  getTextsInRange(BoundYup, BoundYdown, visible);
+  for (TextInfo* ti : visible) {
+    if ((ti->format & 0xFF) != textImage)
+      RenderString(*ti, hDC);
   }
 
   updateStringPosCache();
@@ -759,43 +737,83 @@ void gdioutput::updateStringPosCache() {
   GetClientRect(hWndTarget, &rc);
   int BoundYup = OffsetY-100;
   int BoundYdown = OffsetY+rc.bottom+10;
-  shownStrings.clear();
-  TIList::iterator it;
-
-  if (!renderOptimize || itTL == TL.end()) {
-    for (it=TL.begin();it!=TL.end(); ++it) {
-      TextInfo &ti=*it;
-      if ( ti.yp > BoundYup && ti.yp < BoundYdown) {
-        if (ti.textRect.top != ti.yp - OffsetY) {
-          int diff = it->textRect.top - (ti.yp - OffsetY);
-          ti.textRect.top -= diff;
-          ti.textRect.bottom -= diff;
-        }
-        shownStrings.push_back(&ti);
-      }
+
+  updateTextIndex();
+  getTextsInRange(BoundYup, BoundYdown, shownStrings);
+  for (TextInfo *ti : shownStrings) {
+    if (ti->textRect.top != ti->yp - OffsetY) {
+      int diff = ti->textRect.top - (ti->yp - OffsetY);
+      ti->textRect.top -= diff;
+      ti->textRect.bottom -= diff;
     }
   }
-  else {
-    TIList::iterator itC = itTL;
-
-    while( itC != TL.end() && itC->yp < BoundYup)
-      ++itC;
-
-    if (itC!=TL.end())
-      while( itC != TL.begin() && itC->yp > BoundYup)
-        --itC;
-
-    it=itC;
-    while( it != TL.end() && it->yp < BoundYdown) {
-      shownStrings.push_back(&*it);
-      if (it->textRect.top != it->yp - OffsetY) {
-        int diff = it->textRect.top - (it->yp - OffsetY);
-        it->textRect.top -= diff;
-        it->textRect.bottom -= diff;
-      }
-      ++it;
+}
+
+void gdioutput::updateTextIndex() {
+  int numText = TL.size();
+  if (textIndexSize == numText)
+    return;
+
+  if (textIndexSize >= 0 && textIndexSize < numText) {
+    // Texts are normally added with increasing y-coordinate. Then they can
+    // be appended to the index.
+    size_t oldSize = textIndex.size();
+    int oldMaxHeight = textIndexMaxHeight;
+    int lastY = textIndex.empty() ? numeric_limits<int>::min() : textIndex.back().yp;
+    int order = textIndexSize;
+    auto it = std::prev(TL.end(), numText - textIndexSize);
+    for (; it != TL.end(); ++it, ++order) {
+      if (it->yp < lastY)
+        break;
+      lastY = it->yp;
+      textIndex.push_back({ it->yp, order, &*it });
+      if ((it->format & 0xFF) != textImage)
+        textIndexMaxHeight = max<int>(textIndexMaxHeight, it->textRect.bottom - it->textRect.top);
+    }
+
+    if (it == TL.end()) {
+      textIndexSize = numText;
+      return;
     }
+    textIndex.resize(oldSize);
+    textIndexMaxHeight = oldMaxHeight;
   }
+
+  textIndex.clear();
+  textIndex.reserve(numText);
+  textIndexMaxHeight = 0;
+  int order = 0;
+  for (auto it = TL.begin(); it != TL.end(); ++it, ++order) {
+    textIndex.push_back({ it->yp, order, &*it });
+    if ((it->format & 0xFF) != textImage)
+      textIndexMaxHeight = max<int>(textIndexMaxHeight, it->textRect.bottom - it->textRect.top);
+  }
+  auto byY = [](const TextIndexEntry &a, const TextIndexEntry &b) { return a.yp < b.yp; };
+  textIndexInOrder = is_sorted(textIndex.begin(), textIndex.end(), byY);
+  if (!textIndexInOrder)
+    stable_sort(textIndex.begin(), textIndex.end(), byY);
+  textIndexSize = numText;
+}
+
+void gdioutput::getTextsInRange(int yFrom, int yTo, vector<TextInfo*> &out) {
+  out.clear();
+  auto it = upper_bound(textIndex.begin(), textIndex.end(), yFrom,
+                        [](int y, const TextIndexEntry &e) { return y < e.yp; });
+
+  if (textIndexInOrder) {
+    for (; it != textIndex.end() && it->yp < yTo; ++it)
+      out.push_back(it->ti);
+    return;
+  }
+
+  // Keep the order of TL, since it is the order of drawing overlapping texts
+  vector<pair<int, TextInfo*>> inRange;
+  for (; it != textIndex.end() && it->yp < yTo; ++it)
+    inRange.emplace_back(it->order, it->ti);
+  sort(inRange.begin(), inRange.end());
+  out.reserve(inRange.size());
+  for (auto &ir : inRange)
+    out.push_back(ir.second);
 }
 
 TextInfo& gdioutput::addTimer(int yp, int xp, int format, int zeroTime, const wstring &textFormat, 
@@ -939,10 +957,8 @@ TextInfo& gdioutput::addImage(const string& id, int yp, int xp, int format,
   bool skipBBCalc = (format & skipBoundingBox) == skipBoundingBox;
   format &= ~skipBoundingBox;
 
-  int oldYP = TL.empty() ? -1 : TL.back().yp;
   TL.emplace_back();
   TextInfo& TI = TL.back();
-  itTL = TL.begin();
 
   imageReferences.push_back(&TI);
 
@@ -1033,9 +1049,6 @@ TextInfo& gdioutput::addImage(const string& id, int yp, int xp, int format,
   
   flowDirection = oldDir;
 
-  if (oldYP > TI.yp)
-    renderOptimize = false;
-  
   return TL.back();
 }
 
@@ -1074,11 +1087,8 @@ TextInfo& gdioutput::addStringUT(int yp, int xp, int format, const wstring& text
 {
   bool skipBBCalc = (format & skipBoundingBox) == skipBoundingBox;
   format &= ~skipBoundingBox;
-  int oldYP = TL.empty() ? -1 : TL.back().yp;
-
   TL.emplace_back();
   TextInfo& TI = TL.back();
-  itTL = TL.begin();
 
   if ((format & 0xFF) == textImage)
     imageReferences.push_back(&TI);
@@ -1128,9 +1138,6 @@ TextInfo& gdioutput::addStringUT(int yp, int xp, int format, const wstring& text
       ReleaseDC(hWndTarget, hDC);
       maxTextBlockHeight = max<int>(maxTextBlockHeight, 1 + TI.textRect.bottom - TI.textRect.top);
     }
-
-    if (oldYP > TI.yp)
-      renderOptimize = false;
   }
   else {
     TI.textRect.left = xp;
@@ -1151,10 +1158,7 @@ TextInfo &gdioutput::addString(const char *id, int yp, int xp, int format, const
 TextInfo& gdioutput::addString(const char* id, int yp, int xp, int format, const wstring& text,
   int xlimit, GUICALLBACK cb, const wchar_t* fontFace)
 {
-  int oldYP = TL.empty() ? -1 : TL.back().yp;
-
   TL.emplace_back();
-  itTL = TL.begin();
   TextInfo& TI = TL.back();
 
   if ((format & 0xFF) == textImage)
@@ -1196,9 +1200,6 @@ TextInfo& gdioutput::addString(const char* id, int yp, int xp, int format, const
     ReleaseDC(hWndTarget, hDC);
 
     maxTextBlockHeight = max<int>(maxTextBlockHeight, TI.textRect.bottom - TI.textRect.top + 1);
-
-    if (oldYP > TI.yp)
-      renderOptimize = false;
   }
   else {
     TI.textRect.left = xp;
@@ -3414,7 +3415,7 @@ void gdioutput::clearPage(bool autoRefresh, bool keepToolbar) {
   FocusList.clear();
   currentFocus = 0;
   TL.clear();
-  itTL = TL.end();
+  invalidateTextIndex();
   updateImageReferences();
 
   listDescription.clear();
@@ -3489,14 +3490,11 @@ void gdioutput::clearPage(bool autoRefresh, bool keepToolbar) {
   OffsetX = 0;
   OffsetY = 0;
 
-  renderOptimize = true;
-
   backgroundColor1 = -1;
   backgroundColor2 = -1;
   foregroundColor = -1;
   backgroundImage = -1;
 
-
   setRestorePoint();
 
   if (autoRefresh)
@@ -4587,7 +4585,7 @@ void gdioutput::removeString(string id) {
     if (it->id == id) {
       InvalidateRect(hWndTarget, &it->textRect, true);
       TL.erase(it);
-      itTL = TL.end();
+      invalidateTextIndex();
       shownStrings.clear();
 
       updateImageReferences();
@@ -4702,6 +4700,8 @@ void gdioutput::fadeOut(string Id, int ms)
       fi->hWnd=hWndTarget;
       _beginthread(TextFader, 0, fi);
       TL.erase(it);
+      invalidateTextIndex();
+      shownStrings.clear();
       return;
     }
   }
@@ -4781,7 +4781,7 @@ void gdioutput::RenderString(TextInfo &ti, HDC hDC) {
   else if (format != 10 && (breakLines&ti.format) == 0) {
     if (ti.xlimit == 0) {
       if (ti.format&textRight) {
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CALCRECT | DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_NOPREFIX);
         int dx = rc.right - rc.left;
         ti.realWidth = dx;
         rc.right -= dx;
@@ -4790,7 +4790,7 @@ void gdioutput::RenderString(TextInfo &ti, HDC hDC) {
         DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_RIGHT | DT_NOCLIP | DT_NOPREFIX);
       }
       else if (ti.format&textCenter) {
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CENTER | DT_CALCRECT | DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_CENTER | DT_NOPREFIX);
         int dx = rc.right - rc.left;
         ti.realWidth = dx;
         rc.right -= dx / 2;
@@ -4799,7 +4799,7 @@ void gdioutput::RenderString(TextInfo &ti, HDC hDC) {
         DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CENTER | DT_NOCLIP | DT_NOPREFIX);
       }
       else {
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_LEFT | DT_CALCRECT | DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_LEFT | DT_NOPREFIX);
         ti.textRect = rc;
         ti.realWidth = rc.right - rc.left;
         DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_LEFT | DT_NOCLIP | DT_NOPREFIX);
@@ -4810,7 +4810,7 @@ void gdioutput::RenderString(TextInfo &ti, HDC hDC) {
       if (ti.format & textLimitEllipsis)
         flags = DT_END_ELLIPSIS;
 
-      DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CALCRECT | flags);
+      calcTextRect(ti, ti.text, hDC, rc, flags);
       ti.realWidth = rc.right - rc.left;
       if (ti.format&textRight) {
         rc.right = rc.left + ti.xlimit - (rc.bottom - rc.top) / 2;
@@ -4833,7 +4833,7 @@ void gdioutput::RenderString(TextInfo &ti, HDC hDC) {
     rc.right = width;
     int dx = format != 10 ? 0 : scaleLength(20);
     ti.realWidth = width + dx;
-    DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CALCRECT|DT_LEFT|DT_NOPREFIX|DT_WORDBREAK);
+    calcTextRect(ti, ti.text, hDC, rc, DT_LEFT | DT_NOPREFIX | DT_WORDBREAK);
     ti.textRect=rc;
     ti.textRect.right+=ti.xp+dx;
     ti.textRect.left+=ti.xp;
@@ -4932,7 +4932,7 @@ void gdioutput::RenderString(TextInfo &ti, const wstring &text, HDC hDC)
 
   if (ti.xlimit==0){
     if (ti.format&textRight) {
-      DrawText(hDC, text.c_str(), text.length(), &rc, DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, text, hDC, rc, DT_NOPREFIX);
       int dx=rc.right-rc.left;
       rc.right-=dx;
       rc.left-=dx;
@@ -4940,7 +4940,7 @@ void gdioutput::RenderString(TextInfo &ti, const wstring &text, HDC hDC)
       DrawText(hDC, text.c_str(), text.length(), &rc, DT_RIGHT|DT_NOCLIP|DT_NOPREFIX);
     }
     else if (ti.format&textCenter) {
-      DrawText(hDC, text.c_str(), text.length(), &rc, DT_CENTER|DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, text, hDC, rc, DT_CENTER | DT_NOPREFIX);
       int dx=rc.right-rc.left;
       rc.right-=dx/2;
       rc.left-=dx/2;
@@ -4948,20 +4948,20 @@ void gdioutput::RenderString(TextInfo &ti, const wstring &text, HDC hDC)
       DrawText(hDC, text.c_str(), text.length(), &rc, DT_CENTER|DT_NOCLIP|DT_NOPREFIX);
     }
     else{
-      DrawText(hDC, text.c_str(), text.length(), &rc, DT_LEFT|DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, text, hDC, rc, DT_LEFT | DT_NOPREFIX);
       ti.textRect=rc;
       DrawText(hDC, text.c_str(), text.length(), &rc, DT_LEFT|DT_NOCLIP|DT_NOPREFIX);
     }
   }
   else{
     if (ti.format&textRight) {
-      DrawText(hDC, text.c_str(), text.length(), &rc, DT_LEFT|DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, text, hDC, rc, DT_LEFT | DT_NOPREFIX);
       rc.right = rc.left + ti.xlimit;
       ti.textRect = rc;
       DrawText(hDC, text.c_str(), text.length(), &rc, DT_RIGHT|DT_NOPREFIX);
     }
     else {
-      DrawText(hDC, text.c_str(), text.length(), &rc, DT_LEFT|DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, text, hDC, rc, DT_LEFT | DT_NOPREFIX);
       rc.right=rc.left+ti.xlimit;
       DrawText(hDC, text.c_str(), text.length(), &rc, DT_LEFT|DT_NOPREFIX);
       ti.textRect=rc;
@@ -4989,6 +4989,53 @@ void gdioutput::getFontInfo(const TextInfo &ti, FontInfo &fi) const {
 }
 
 
+gdioutput::TextDevice::TextDevice(HDC hDC) {
+  technology = GetDeviceCaps(hDC, TECHNOLOGY);
+  mapMode = GetMapMode(hDC);
+  logPixelsX = GetDeviceCaps(hDC, LOGPIXELSX);
+  logPixelsY = GetDeviceCaps(hDC, LOGPIXELSY);
+  if (mapMode != MM_TEXT) {
+    GetWindowExtEx(hDC, &windowExt);
+    GetViewportExtEx(hDC, &viewportExt);
+  }
+}
+
+size_t gdioutput::TextSizeKeyHash::operator()(const TextSizeKey &k) const {
+  size_t h = std::hash<wstring>()(k.text);
+  h = h * 31 + std::hash<wstring>()(k.font);
+  h = h * 31 + size_t(k.format);
+  h = h * 31 + size_t(k.flags);
+  h = h * 31 + size_t(k.device.technology);
+  h = h * 31 + size_t(k.device.mapMode);
+  h = h * 31 + size_t(k.device.logPixelsY);
+  h = h * 31 + size_t(k.device.viewportExt.cx);
+  return h * 31 + size_t(k.width);
+}
+
+void gdioutput::calcTextRect(const TextInfo &ti, const wstring &text, HDC hDC, RECT &rc, int flags) const {
+  int width = (flags & DT_WORDBREAK) ? rc.right - rc.left : 0;
+  TextSizeKey key = { text, ti.font, ti.format & 0xFF, flags, width, TextDevice(hDC) };
+  auto res = textSizeCache.find(key);
+  if (res == textSizeCache.end()) {
+    RECT mrc = rc;
+    DrawText(hDC, text.c_str(), text.length(), &mrc, DT_CALCRECT | flags);
+    mrc.left -= rc.left;
+    mrc.right -= rc.left;
+    mrc.top -= rc.top;
+    mrc.bottom -= rc.top;
+    if (textSizeCache.size() > 100000)
+      textSizeCache.clear();
+    res = textSizeCache.emplace(std::move(key), mrc).first;
+  }
+
+  const RECT &mrc = res->second;
+  int left = rc.left, top = rc.top;
+  rc.left = left + mrc.left;
+  rc.right = left + mrc.right;
+  rc.top = top + mrc.top;
+  rc.bottom = top + mrc.bottom;
+}
+
 void gdioutput::formatString(const TextInfo &ti, HDC hDC) const
 {
   int format=ti.format&0xFF;
@@ -5065,7 +5112,7 @@ void gdioutput::calcStringSize(TextInfo &ti, HDC hDC_in) const {
   if (format != 10 && (breakLines&ti.format) == 0) {
     if (ti.xlimit==0){
       if (ti.format&textRight) {
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CALCRECT|DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_NOPREFIX);
         int dx=rc.right-rc.left;
         ti.realWidth = dx;
         rc.right-=dx;
@@ -5073,7 +5120,7 @@ void gdioutput::calcStringSize(TextInfo &ti, HDC hDC_in) const {
         ti.textRect=rc;
       }
       else if (ti.format&textCenter) {
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CENTER|DT_CALCRECT|DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_CENTER | DT_NOPREFIX);
         int dx=rc.right-rc.left;
         ti.realWidth = dx;
         rc.right-=dx/2;
@@ -5081,13 +5128,13 @@ void gdioutput::calcStringSize(TextInfo &ti, HDC hDC_in) const {
         ti.textRect=rc;
       }
       else{
-        DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_LEFT|DT_CALCRECT|DT_NOPREFIX);
+        calcTextRect(ti, ti.text, hDC, rc, DT_LEFT | DT_NOPREFIX);
         ti.realWidth = rc.right - rc.left;
         ti.textRect=rc;
       }
     }
     else {
-      DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_LEFT|DT_CALCRECT|DT_NOPREFIX);
+      calcTextRect(ti, ti.text, hDC, rc, DT_LEFT | DT_NOPREFIX);
       ti.realWidth = rc.right - rc.left;
       rc.right=rc.left+ti.xlimit;
       ti.textRect=rc;
@@ -5098,7 +5145,7 @@ void gdioutput::calcStringSize(TextInfo &ti, HDC hDC_in) const {
     rc.right = scaleLength( (breakLines&ti.format) ? ti.xlimit : 450 );
     int dx = format != 10 ? 0 : scaleLength(20);
     ti.realWidth = rc.right + dx;
-    DrawText(hDC, ti.text.c_str(), ti.text.length(), &rc, DT_CALCRECT|DT_LEFT|DT_NOPREFIX|DT_WORDBREAK);
+    calcTextRect(ti, ti.text, hDC, rc, DT_LEFT | DT_NOPREFIX | DT_WORDBREAK);
     ti.textRect=rc;
     ti.textRect.right+=ti.xp+dx;
     ti.textRect.left+=ti.xp;
@@ -5829,6 +5876,7 @@ void gdioutput::setWidgetRestorePoint(const string& id, const string& restorePoi
       int numNew = rpTarget.nTL;
       advance(itNew, numNew);
       TL.splice(itNew, TL, it);
+      invalidateTextIndex();
       for (auto& rp : restorePoints) {
         if (rp.second.nTL >= numNew) {
           rp.second.nTL++;
@@ -5869,7 +5917,7 @@ void gdioutput::restoreInternal(const RestoreInfo &ri)
     TL.pop_back();
     tlRemove--;
   }
-  itTL=TL.begin();
+  invalidateTextIndex();
   updateImageReferences();
 
   // Clear cache of shown strings
@@ -120,12 +120,26 @@ protected:
 
   shared_ptr<MouseHandler> mouseHandler;
 
-  //True if textlist has increasing y-values so
-  //that we can optimize rendering.
-  bool renderOptimize;
-  //Stored iterator used to optimize rendering
-  //by avoiding to loop through complete TL.
-  list<TextInfo>::iterator itTL;
+  struct TextIndexEntry {
+    int yp;
+    int order; // Position in TL
+    TextInfo* ti;
+  };
+
+  // The texts of TL sorted on y-coordinate. Used to find the visible
+  // texts by binary search, without looping through complete TL.
+  vector<TextIndexEntry> textIndex;
+  // Number of texts in TL covered by textIndex, or -1 if it must be rebuilt.
+  int textIndexSize = -1;
+  // Maximum height of an indexed text block.
+  int textIndexMaxHeight = 0;
+  // True if the index order is the same as the order of TL.
+  bool textIndexInOrder = true;
+
+  void invalidateTextIndex() { textIndexSize = -1; }
+  void updateTextIndex();
+  // Get the texts with yFrom < yp < yTo, in the order of TL.
+  void getTextsInRange(int yFrom, int yTo, vector<TextInfo*>& out);
 
   // References into TL for all images
   vector<TextInfo*> imageReferences;
@@ -180,6 +194,50 @@ protected:
 
   mutable map<pair<int, wstring>, int> fontHeightCache;
 
+  // Metrics of the device a text is measured on (screen, printer, scaled mapping mode)
+  struct TextDevice {
+    int technology = 0;
+    int mapMode = 0;
+    int logPixelsX = 0;
+    int logPixelsY = 0;
+    SIZE windowExt = { 0, 0 };
+    SIZE viewportExt = { 0, 0 };
+
+    explicit TextDevice(HDC hDC);
+
+    bool operator==(const TextDevice& d) const {
+      return technology == d.technology && mapMode == d.mapMode &&
+             logPixelsX == d.logPixelsX && logPixelsY == d.logPixelsY &&
+             windowExt.cx == d.windowExt.cx && windowExt.cy == d.windowExt.cy &&
+             viewportExt.cx == d.viewportExt.cx && viewportExt.cy == d.viewportExt.cy;
+    }
+  };
+
+  struct TextSizeKey {
+    wstring text;
+    wstring font;
+    int format;
+    int flags;
+    int width;
+    TextDevice device;
+
+    bool operator==(const TextSizeKey& k) const {
+      return format == k.format && flags == k.flags && width == k.width &&
+             device == k.device && text == k.text && font == k.font;
+    }
+  };
+
+  struct TextSizeKeyHash {
+    size_t operator()(const TextSizeKey& k) const;
+  };
+
+  // Measured text rectangles, relative to the top left corner
+  mutable unordered_map<TextSizeKey, RECT, TextSizeKeyHash> textSizeCache;
+
+  // Same as DrawText with DT_CALCRECT, but cached per font, format, text and device.
+  // The font of ti must be selected in hDC.
+  void calcTextRect(const TextInfo& ti, const wstring& text, HDC hDC, RECT& rc, int flags) const;
+
   map<wstring, GDIImplFontSet> fonts;
   const GDIImplFontSet& getCurrentFont() const;
   const GDIImplFontSet& getFont(const wstring& font) const;
@@ -95,12 +95,7 @@ public:
       if (place != o.place)
         return place < o.place;
 
-      const wstring &name = src->getName();
-      const wstring &oname = o.src->getName();
-
-      return CompareString(LOCALE_USER_DEFAULT, 0,
-        name.c_str(), name.length(),
-        oname.c_str(), oname.length()) == CSTR_LESS_THAN;
+      return src->getNameSortKey() < o.src->getNameSortKey();
     }
 
     bool operator<(const GeneralResultInfo &o) const {
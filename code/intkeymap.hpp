@@ -22,6 +22,10 @@
 ************************************************************************/
 
 
+/** Hash map with integer keys. Open addressing with linear probing in a
+    flat table. Each slot has a control byte (seven bits of the hash, or
+    empty) and the control bytes are probed 16 at a time. Removal moves later
+    elements of the probe sequence back, so there are no deleted markers. */
 template<class T, class KEY = int> class intkeymap {
 private:
   const static KEY NoKey = -1013;
@@ -30,24 +34,24 @@ private:
     KEY key;
     T value;
   };
-  T dummy;
-  T tmp;
+
   keypair *keys;
+  unsigned char *ctrl;
   unsigned siz;
   unsigned used;
-  intkeymap *next;
-  intkeymap *parent;
-  double allocFactor;
+  int shift;
   T noValue;
-  unsigned hash1;
-  unsigned hash2;
-  int level;
-  static int optsize(int arg);
 
-  T &rehash(int size, KEY key, const T &value);
+  void allocate(unsigned capacity);
+  void rehash(unsigned capacity);
+  static unsigned capacityFor(unsigned numElem);
+  unsigned homeSlot(KEY key) const;
+  void setCtrl(unsigned ix, unsigned char c);
+  unsigned findEmpty(KEY key) const;
+
   T &get(const KEY key);
 
-  void *lookup(KEY key) const;
+  keypair *lookup(KEY key) const;
 public:
   virtual ~intkeymap();
   intkeymap(int size);
@@ -61,16 +65,18 @@ public:
   void clear();
 
   void resize(int size);
-  int count(KEY key) {
-    return lookup(key, dummy) ? 1:0;
+  int count(KEY key) const {
+    return lookup(key) ? 1:0;
   }
   bool lookup(KEY key, T &value) const;
 
   void insert(KEY key, const T &value);
   void remove(KEY key);
   void erase(KEY key) {remove(key);}
-  const T operator[](KEY key) const
-    {if (lookup(key,tmp)) return tmp; else return T();}
+  const T operator[](KEY key) const {
+    const keypair *ptr = lookup(key);
+    return ptr ? ptr->value : T();
+  }
 
   T &operator[](KEY key) {
     return get(key);
@@ -26,87 +26,125 @@
 #include "stdafx.h"
 #include "intkeymap.hpp"
 
+#include <cstring>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INTKEYMAP_SSE2
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#define INTKEYMAP_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/** Control bytes of 16 consecutive slots. */
+class IntKeyMapGroup {
+public:
+  static const int Size = 16;
+  static const unsigned char Empty = 0x80;
+
+  explicit IntKeyMapGroup(const unsigned char *pos) {
+#if defined(INTKEYMAP_SSE2)
+    ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+#elif defined(INTKEYMAP_NEON)
+    ctrl = vld1q_u8(pos);
+#else
+    ctrl = pos;
+#endif
+  }
+
+  /** Bit mask of the slots with the given control byte. */
+  uint32_t match(unsigned char c) const {
+#if defined(INTKEYMAP_SSE2)
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(c)))));
+#elif defined(INTKEYMAP_NEON)
+    return toMask(vceqq_u8(ctrl, vdupq_n_u8(c)));
+#else
+    uint32_t m = 0;
+    for (int k = 0; k < Size; k++) {
+      if (ctrl[k] == c)
+        m |= 1u << k;
+    }
+    return m;
+#endif
+  }
+
+  /** Bit mask of the empty slots. */
+  uint32_t matchEmpty() const {
+#if defined(INTKEYMAP_SSE2)
+    return uint32_t(_mm_movemask_epi8(ctrl));
+#elif defined(INTKEYMAP_NEON)
+    return toMask(vtstq_u8(ctrl, vdupq_n_u8(Empty)));
+#else
+    return match(Empty);
+#endif
+  }
+
+  static int lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long ix;
+    _BitScanForward(&ix, mask);
+    return int(ix);
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+private:
+#if defined(INTKEYMAP_SSE2)
+  __m128i ctrl;
+#elif defined(INTKEYMAP_NEON)
+  uint8x16_t ctrl;
 
+  static uint32_t toMask(uint8x16_t m) {
+    static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t b = vandq_u8(m, vld1q_u8(bits));
+    return uint32_t(vaddv_u8(vget_low_u8(b))) | (uint32_t(vaddv_u8(vget_high_u8(b))) << 8);
+  }
+#else
+  const unsigned char *ctrl;
+#endif
+};
 
 template <class T, class KEY> intkeymap<T, KEY>::intkeymap()  {
-  siz = 17;
-  allocFactor = 1.5;
-  keys = new keypair[siz];
-  hash1 = siz / 2 + 3;
-  hash2 = siz / 3 + 2;
-  used = 0;
-  next = 0;
-  level = 0;
-  parent = 0;
-  dummy = 0;
-  noValue = 0;
-  clear();
+  keys = 0;
+  ctrl = 0;
+  noValue = T();
+  allocate(IntKeyMapGroup::Size);
 }
 
 template <class T, class KEY> intkeymap<T, KEY>::intkeymap(int _size)
 {
-  allocFactor = 1.3;
-  siz = optsize(_size);
-  keys = new keypair[siz];
-  hash1 = siz / 2 + 3;
-  hash2 = siz / 3 + 2;
-  used = 0;
-  next = 0;
-  level = 0;
-  parent = 0;
-  dummy = T();
+  keys = 0;
+  ctrl = 0;
   noValue = T();
-  clear();
+  allocate(capacityFor(_size > 0 ? _size : 0));
 }
 
 template <class T, class KEY> intkeymap<T, KEY>::intkeymap(const intkeymap &co)
 {
-  allocFactor =  co.allocFactor;
-  siz = co.siz;
-  keys = new keypair[siz];
-  hash1 = co.hash1;
-  hash2 = co.hash2;
-  used = co.used;
-  level = co.level;
-  dummy = co.dummy;
-  noValue = co.noValue;
-
-  for (unsigned k=0; k<siz; k++)
-    keys[k] = co.keys[k];
-
-  parent = 0;
-  next = 0;
-
-  if (co.next) {
-    next = new intkeymap<T, KEY>(*co.next);
-    next->parent = this;
-  }
+  keys = 0;
+  ctrl = 0;
+  *this = co;
 }
 
 template <class T, class KEY>
 const intkeymap<T, KEY> &intkeymap<T, KEY>::operator=(const intkeymap<T, KEY> &co) {
-  clear();
-  delete[] keys;
+  if (this == &co)
+    return *this;
 
-  allocFactor = co.allocFactor;
-  siz = co.siz;
-  keys = new keypair[siz];
-  hash1 = co.hash1;
-  hash2 = co.hash2;
+  allocate(co.siz);
   used = co.used;
-  level = co.level;
-  dummy = co.dummy;
   noValue = co.noValue;
 
-  for (unsigned k = 0; k<siz; k++)
-    keys[k] = co.keys[k];
-
-  parent = 0;
-  next = 0;
-
-  if (co.next) {
-    next = new intkeymap<T, KEY>(*co.next);
-    next->parent = this;
+  memcpy(ctrl, co.ctrl, siz + IntKeyMapGroup::Size - 1);
+  for (unsigned k = 0; k < siz; k++) {
+    if (ctrl[k] != IntKeyMapGroup::Empty)
+      keys[k] = co.keys[k];
   }
   return *this;
 }
@@ -114,214 +152,174 @@ const intkeymap<T, KEY> &intkeymap<T, KEY>::operator=(const intkeymap<T, KEY> &c
 template <class T, class KEY> intkeymap<T, KEY>::~intkeymap()
 {
   delete[] keys;
-  if (next)
-    delete next;
+  delete[] ctrl;
 }
 
-template <class T, class KEY> void intkeymap<T, KEY>::clear()
+template <class T, class KEY> void intkeymap<T, KEY>::allocate(unsigned capacity)
 {
-  for (unsigned k=0;k<siz;k++)
-    keys[k].key = NoKey;
+  delete[] keys;
+  delete[] ctrl;
 
+  siz = capacity;
+  shift = 64;
+  while (capacity > 1) {
+    capacity >>= 1;
+    shift--;
+  }
+  keys = new keypair[siz];
+  // The first group is repeated after the end so that any
+  // slot can start a group without wrapping around.
+  ctrl = new unsigned char[siz + IntKeyMapGroup::Size - 1];
+  memset(ctrl, IntKeyMapGroup::Empty, siz + IntKeyMapGroup::Size - 1);
   used = 0;
-  delete next;
-  next = 0;
 }
 
-template <class T, class KEY> void intkeymap<T, KEY>::insert(KEY key, const T &value)
+template <class T, class KEY> unsigned intkeymap<T, KEY>::capacityFor(unsigned numElem)
 {
-  if (key == NoKey) {
-    noValue = value;
-    return;
-  }
-
-  keypair *ptr = (keypair *)lookup(key);
-  if (ptr) {
-    ptr->key = key;
-    ptr->value = value;
-    return;
-  }
+  // Maximum load is 7/8
+  unsigned capacity = IntKeyMapGroup::Size;
+  while (capacity - capacity / 8 < numElem + 1)
+    capacity *= 2;
+  return capacity;
+}
 
-  unsigned hk = unsigned(key) % siz;
+template <class T, class KEY> unsigned intkeymap<T, KEY>::homeSlot(KEY key) const
+{
+  return unsigned((uint64_t(key) * 0x9E3779B97F4A7C15ull) >> shift);
+}
 
-  if (keys[hk].key == NoKey)
-    used++;
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    keys[hk].value = value;
-    return;
-  }
+/** Seven bits of the hash, independent of the home slot. */
+template <class KEY> inline unsigned char intKeyMapTag(KEY key)
+{
+  return (unsigned char)((uint64_t(key) * 0xC2B2AE3D27D4EB4Full) >> 57);
+}
 
-  hk = unsigned(key + hash1) % siz;
+template <class T, class KEY> void intkeymap<T, KEY>::setCtrl(unsigned ix, unsigned char c)
+{
+  ctrl[ix] = c;
+  if (ix < IntKeyMapGroup::Size - 1)
+    ctrl[siz + ix] = c;
+}
 
-  if (keys[hk].key == NoKey)
-    used++;
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    keys[hk].value = value;
-    return;
-  }
+template <class T, class KEY> void intkeymap<T, KEY>::clear()
+{
+  memset(ctrl, IntKeyMapGroup::Empty, siz + IntKeyMapGroup::Size - 1);
+  used = 0;
+}
 
-  hk = unsigned(key + hash2) % siz;
+template <class T, class KEY> typename intkeymap<T, KEY>::keypair *intkeymap<T, KEY>::lookup(KEY key) const
+{
+  if (key == NoKey)
+    return 0;
 
-  if (keys[hk].key == NoKey)
-    used++;
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    keys[hk].value = value;
-    return;
+  const unsigned mask = siz - 1;
+  const unsigned char tag = intKeyMapTag(key);
+  unsigned pos = homeSlot(key);
+  while (true) {
+    IntKeyMapGroup g(ctrl + pos);
+    for (uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+      unsigned ix = (pos + IntKeyMapGroup::lowestBit(m)) & mask;
+      if (keys[ix].key == key)
+        return &keys[ix];
+    }
+    if (g.matchEmpty())
+      return 0;
+    pos = (pos + IntKeyMapGroup::Size) & mask;
   }
+}
 
-  if (next) {
-    next->insert(key, value);
-    return;
-  }
-  else if (level < 3) {
-    next = new intkeymap<T, KEY>(siz/2);
-    next->level = level + 1;
-    next->parent = this;
-    next->insert(key, value);
-    return;
+template <class T, class KEY> unsigned intkeymap<T, KEY>::findEmpty(KEY key) const
+{
+  const unsigned mask = siz - 1;
+  unsigned pos = homeSlot(key);
+  while (true) {
+    uint32_t m = IntKeyMapGroup(ctrl + pos).matchEmpty();
+    if (m)
+      return (pos + IntKeyMapGroup::lowestBit(m)) & mask;
+    pos = (pos + IntKeyMapGroup::Size) & mask;
   }
+}
 
-  rehash(0, key, value);
+template <class T, class KEY> void intkeymap<T, KEY>::insert(KEY key, const T &value)
+{
+  get(key) = value;
 }
 
 template <class T, class KEY> T &intkeymap<T, KEY>::get(KEY key)
 {
-  keypair *ptr = (keypair *)lookup(key);
-  if (ptr)
-    return ptr->value;
-
   if (key == NoKey)
     return noValue;
 
-  unsigned hk = unsigned(key) % siz;
-
-  if (keys[hk].key == NoKey) {
-    used++;
-    keys[hk].value = T();
-  }
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    return keys[hk].value;
-  }
-
-  hk = unsigned(key + hash1) % siz;
-
-  if (keys[hk].key == NoKey) {
-    used++;
-    keys[hk].value = T();
-  }
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    return keys[hk].value;
-  }
-
-  hk = unsigned(key + hash2) % siz;
-
-  if (keys[hk].key == NoKey) {
-    keys[hk].value = T();
-    used++;
-  }
-  if (keys[hk].key == NoKey || keys[hk].key == key) {
-    keys[hk].key = key;
-    return keys[hk].value;
-  }
+  keypair *ptr = lookup(key);
+  if (ptr)
+    return ptr->value;
 
-  if (next) {
-    return next->get(key);
-  }
-  else if (level < 3) {
-    next = new intkeymap<T, KEY>(siz/2);
-    next->level = level + 1;
-    next->parent = this;
-    return next->get(key);
-  }
+  if (used + 1 > siz - siz / 8)
+    rehash(siz * 2);
 
-  return rehash(0, key, T());
+  unsigned ix = findEmpty(key);
+  setCtrl(ix, intKeyMapTag(key));
+  used++;
+  keys[ix].key = key;
+  keys[ix].value = T();
+  return keys[ix].value;
 }
 
-
 template <class T, class KEY> void intkeymap<T, KEY>::remove(KEY key)
 {
-  unsigned hk = unsigned(key) % siz;
-  if (keys[hk].key == key) {
-    keys[hk].key = NoKey;
-    used--;
+  keypair *ptr = lookup(key);
+  if (!ptr)
     return;
-  }
-
-  hk = unsigned(key + hash1) % siz;
-  if (keys[hk].key == key) {
-    keys[hk].key = NoKey;
-    used--;
-    return;
-  }
-
-  hk = unsigned(key + hash2) % siz;
-  if (keys[hk].key == key) {
-    keys[hk].key = NoKey;
-    used--;
-    return;
-  }
 
-  if (next) {
-    next->remove(key);
-    return;
+  // Move back later elements that would otherwise not be reachable
+  // from their home slot.
+  const unsigned mask = siz - 1;
+  unsigned hole = unsigned(ptr - keys);
+  unsigned ix = hole;
+  while (true) {
+    ix = (ix + 1) & mask;
+    if (ctrl[ix] == IntKeyMapGroup::Empty)
+      break;
+
+    unsigned home = homeSlot(keys[ix].key);
+    bool inPlace = hole <= ix ? (hole < home && home <= ix) : (hole < home || home <= ix);
+    if (!inPlace) {
+      keys[hole] = keys[ix];
+      setCtrl(hole, ctrl[ix]);
+      hole = ix;
+    }
   }
+  setCtrl(hole, IntKeyMapGroup::Empty);
+  keys[hole].value = T();
+  used--;
 }
 
-template <class T, class KEY> T &intkeymap<T, KEY>::rehash(int _siz, KEY key, const T &value)
+template <class T, class KEY> void intkeymap<T, KEY>::rehash(unsigned capacity)
 {
-  if (parent)
-    return parent->rehash(_siz+used, key, value);
-  else {
-    intkeymap<T, KEY> nm(int((_siz+used)*allocFactor));
-    if (key != NoKey)
-      nm.insert(key, value);
-
-    intkeymap<T, KEY> *tmap = this;
-    while (tmap) {
-      int tsize = tmap->siz;
-      keypair *tkeys = tmap->keys;
-      for (int k=0; k<tsize; k++) {
-        if (tkeys[k].key != NoKey)
-          nm.insert(tkeys[k].key, tkeys[k].value);
-      }
-      tmap = tmap->next;
+  keypair *oldKeys = keys;
+  unsigned char *oldCtrl = ctrl;
+  unsigned oldSiz = siz;
+
+  keys = 0;
+  ctrl = 0;
+  allocate(capacity);
+
+  for (unsigned k = 0; k < oldSiz; k++) {
+    if (oldCtrl[k] != IntKeyMapGroup::Empty) {
+      unsigned ix = findEmpty(oldKeys[k].key);
+      setCtrl(ix, oldCtrl[k]);
+      keys[ix] = oldKeys[k];
+      used++;
     }
-
-    // Swap
-    keypair *oldkeys = keys;
-
-    //Take next
-    delete next;
-    next = nm.next;
-    nm.next = 0;
-    if (next)
-      next->parent = this;
-
-    //Take keys
-    keys = nm.keys;
-    nm.keys = 0;
-    delete[] oldkeys;
-
-    // Copy relevant data
-    siz = nm.siz;
-    used = nm.used;
-    hash1 = nm.hash1;
-    hash2 = nm.hash2;
-
-    if (key!=NoKey)
-      return get(key);
-    return dummy;
   }
+
+  delete[] oldKeys;
+  delete[] oldCtrl;
 }
 
 template <class T, class KEY> bool intkeymap<T, KEY>::lookup(KEY key, T &value) const
 {
-  keypair *ptr = (keypair *)lookup(key);
+  const keypair *ptr = lookup(key);
   if (ptr) {
     value = ptr->value;
     return true;
@@ -332,72 +330,19 @@ template <class T, class KEY> bool intkeymap<T, KEY>::lookup(KEY key, T &value)
   }
 }
 
-template <class T, class KEY> void *intkeymap<T, KEY>::lookup(KEY key) const
-{
-  if (key == NoKey) {
-    return 0;
-  }
-
-  unsigned hk = unsigned(key) % siz;
-  if (keys[hk].key == key) {
-    return (void *)&keys[hk];
-  }
-
-  hk = unsigned(key + hash1) % siz;
-  if (keys[hk].key == key) {
-    return (void *)&keys[hk];
-  }
-
-  hk = unsigned(key + hash2) % siz;
-  if (keys[hk].key == key) {
-    return (void *)&keys[hk];
-  }
-
-  if (next)
-    return next->lookup(key);
-  else
-    return 0;
-}
-
-template <class T, class KEY> int intkeymap<T, KEY>::optsize(int a) {
-  if (a<5)
-    a = 5;
-
-  if ((a&1) == 0)
-    a++;
-
-  while (true)  {
-    if (a%3 == 0)
-      a+=2;
-    else if (a%5 == 0)
-      a+=2;
-    else if (a%7 == 0)
-      a+=2;
-    else if (a%11 == 0)
-      a+=2;
-    else if (a%13 == 0)
-      a+=2;
-    else
-      return a;
-  }
-}
-
 template <class T, class KEY> int intkeymap<T, KEY>::size() const
 {
-  if (next)
-    return used + next->size();
-  else
-    return used;
+  return used;
 }
 
 template <class T, class KEY> bool intkeymap<T, KEY>::empty() const
 {
-  return used==0 && (next==0 || next->empty());
+  return used == 0;
 }
 
 template <class T, class KEY> void intkeymap<T, KEY>::resize(int size)
 {
-  allocFactor = 1.0;
-  rehash(size, NoKey, 0);
-  allocFactor = 1.3;
+  unsigned capacity = capacityFor(used + (size > 0 ? size : 0));
+  if (capacity > siz)
+    rehash(capacity);
 }
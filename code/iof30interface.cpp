@@ -1049,16 +1049,11 @@ void IOF30Interface::readClubList(gdioutput &gdi, const xmlobject &xo, int &club
 void IOF30Interface::prescanEntryList(xmlobject &xo, set<int> &definedStages) {
   definedStages.clear();
 
-  xmlList pEntries, work;
-  xo.getObjects("PersonEntry", pEntries);
-  for (size_t k = 0; k < pEntries.size(); k++) {
-    prescanEntry(pEntries[k], definedStages, work);
-  }
-
-  xo.getObjects("TeamEntry", pEntries);
-  for (size_t k = 0; k < pEntries.size(); k++) {
-    prescanEntry(pEntries[k], definedStages, work);
-  }
+  xmlList work;
+  xo.forEach(nullptr, [&](xmlobject &xEntry) {
+    if (xEntry.is("PersonEntry") || xEntry.is("TeamEntry"))
+      prescanEntry(xEntry, definedStages, work);
+  });
 }
 
 void IOF30Interface::readEntryList(gdioutput &gdi, xmlobject &xo, bool removeNonexiting, 
@@ -1072,15 +1067,10 @@ void IOF30Interface::readEntryList(gdioutput &gdi, xmlobject &xo, bool removeNon
   if (!ver.empty() && ver > "3.0")
     gdi.addString("", 0, "Varning, okänd XML-version X#" + ver);
 
-  xmlobject xEvent = xo.getObject("Event");
   map<int, vector<LegInfo> > teamClassConfig;
   map<int, pair<wstring, int> > bibPatterns;
   oClass::extractBibPatterns(oe, bibPatterns);
 
-  if (xEvent) {
-    readEvent(gdi, xEvent, teamClassConfig);
-  }
-
   vector<pRunner> allR;
   vector<pTeam> allT;
   oe.getRunners(0, 0, allR, false);
@@ -1107,25 +1097,27 @@ void IOF30Interface::readEntryList(gdioutput &gdi, xmlobject &xo, bool removeNon
     }
   }
 
-  xmlList pEntries;
-  xo.getObjects("PersonEntry", pEntries);
+  // The list may be streamed from file; read it in document order (Event, PersonEntry, TeamEntry)
   map<int, vector< pair<int, int> > > personId2TeamLeg;
-  for (size_t k = 0; k < pEntries.size(); k++) {
-    if (readPersonEntry(gdi, pEntries[k], 0, teamClassConfig, stageFilter, personId2TeamLeg))
-      entRead++;
-    else
-      entFail++;
-  }
-  
-  xo.getObjects("TeamEntry", pEntries);
-  for (size_t k = 0; k < pEntries.size(); k++) {
-    xmlList races;
-    pEntries[k].getObjects("Race", races);
-    if (!matchStageFilter(stageFilter, races))
-      continue; // Skip teams belonging to other stage
-
-    setupClassConfig(0, pEntries[k], teamClassConfig);
-  }
+  bool hasTeams = false;
+  xo.forEach(nullptr, [&](xmlobject &xChild) {
+    if (xChild.is("Event")) {
+      readEvent(gdi, xChild, teamClassConfig);
+    }
+    else if (xChild.is("PersonEntry")) {
+      if (readPersonEntry(gdi, xChild, 0, teamClassConfig, stageFilter, personId2TeamLeg))
+        entRead++;
+      else
+        entFail++;
+    }
+    else if (xChild.is("TeamEntry")) {
+      hasTeams = true;
+      xmlList races;
+      xChild.getObjects("Race", races);
+      if (matchStageFilter(stageFilter, races)) // Skip teams belonging to other stage
+        setupClassConfig(0, xChild, teamClassConfig);
+    }
+  });
 
   // Get all classes, and use existing leg info  
   vector<pClass> allCls;
@@ -1151,11 +1143,13 @@ void IOF30Interface::readEntryList(gdioutput &gdi, xmlobject &xo, bool removeNon
 
   setupRelayClasses(teamClassConfig);
 
-  for (size_t k = 0; k < pEntries.size(); k++) {
-    if (readTeamEntry(gdi, pEntries[k], stageFilter, bibPatterns, teamClassConfig, personId2TeamLeg))
-      entRead++;
-    else
-      entFail++;
+  if (hasTeams) {
+    xo.forEach("TeamEntry", [&](xmlobject &xTeam) {
+      if (readTeamEntry(gdi, xTeam, stageFilter, bibPatterns, teamClassConfig, personId2TeamLeg))
+        entRead++;
+      else
+        entFail++;
+    });
   }
 
   oe.updateStartGroups(); // Store any updated start groups
@@ -1543,14 +1537,6 @@ void IOF30Interface::readResultList(gdioutput &gdi, xmlobject &xo, int &entRead,
 
   map<int, vector<LegInfo> > teamClassConfig;
 
-  xmlobject xEvent = xo.getObject("Event");
-  if (xEvent) {
-    readEvent(gdi, xEvent, teamClassConfig);
-  }
-
-  xmlList cResults;
-  xo.getObjects("ClassResult", cResults);
-
   struct RaceInfo {
     int courseId;
     int length;
@@ -1558,8 +1544,7 @@ void IOF30Interface::readResultList(gdioutput &gdi, xmlobject &xo, int &entRead,
     wstring startName;
   };
 
-  for (xmlobject &xClassResult : cResults) {
-     
+  auto readClassResult = [&](xmlobject &xClassResult) {
     pClass pc = readClass(xClassResult.getObject("Class"),
                           teamClassConfig);
     int classId = pc ? pc->getId() : 0;
@@ -1625,7 +1610,15 @@ void IOF30Interface::readResultList(gdioutput &gdi, xmlobject &xo, int &entRead,
     }
     */
     pc->synchronize();
-  }
+  };
+
+  // The list may be streamed from file; read it in document order
+  xo.forEach(nullptr, [&](xmlobject &xChild) {
+    if (xChild.is("Event"))
+      readEvent(gdi, xChild, teamClassConfig);
+    else if (xChild.is("ClassResult"))
+      readClassResult(xChild);
+  });
 }
 
 
@@ -0,0 +1,301 @@
+﻿/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License fro more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+
+#include "StdAfx.h"
+
+#include <random>
+#include <chrono>
+#include <io.h>
+
+#include "journal.h"
+#include "oEvent.h"
+#include "xmlparser.h"
+#include "meos_util.h"
+
+namespace {
+  const char journalMagic[] = "MeOSJournal1";
+  constexpr size_t journalMagicLen = sizeof(journalMagic) - 1;
+
+  // Make a full save when the journal grows larger than this
+  constexpr size_t maxJournalSize = 4 * 1024 * 1024;
+  // Make a full save at least every n:th automatic save
+  constexpr int maxCheckpoints = 5;
+
+  /** Flush the stream and the operating system buffers, so that a record survives a power loss. */
+  bool flushToDisk(FILE *f) {
+    if (fflush(f) != 0)
+      return false;
+    return _commit(_fileno(f)) == 0;
+  }
+
+  bool writeObject(oBase &ob, xmlparser &xml) {
+    if (auto r = dynamic_cast<oRunner *>(&ob))
+      return r->getMainRunner()->Write(xml);
+    if (auto t = dynamic_cast<oTeam *>(&ob))
+      return t->write(xml);
+    if (auto c = dynamic_cast<oCard *>(&ob))
+      return c->Write(xml);
+    if (auto p = dynamic_cast<oFreePunch *>(&ob))
+      return p->Write(xml);
+    if (auto c = dynamic_cast<oClass *>(&ob))
+      return c->Write(xml);
+    if (auto c = dynamic_cast<oCourse *>(&ob))
+      return c->Write(xml);
+    if (auto c = dynamic_cast<oControl *>(&ob))
+      return c->write(xml);
+    if (auto c = dynamic_cast<oClub *>(&ob))
+      return c->write(xml);
+    return false;
+  }
+
+  const char *getTag(const oBase &ob) {
+    if (dynamic_cast<const oRunner *>(&ob))
+      return "Runner";
+    if (dynamic_cast<const oTeam *>(&ob))
+      return "Team";
+    if (dynamic_cast<const oCard *>(&ob))
+      return "Card";
+    if (dynamic_cast<const oFreePunch *>(&ob))
+      return "Punch";
+    if (dynamic_cast<const oClass *>(&ob))
+      return "Class";
+    if (dynamic_cast<const oCourse *>(&ob))
+      return "Course";
+    if (dynamic_cast<const oControl *>(&ob))
+      return "Control";
+    if (dynamic_cast<const oClub *>(&ob))
+      return "Club";
+    return nullptr;
+  }
+
+  void writeLength(FILE *f, uint32_t len) {
+    uint8_t bf[4] = { uint8_t(len), uint8_t(len >> 8), uint8_t(len >> 16), uint8_t(len >> 24) };
+    fwrite(bf, 4, 1, f);
+  }
+
+  bool readLength(FILE *f, uint32_t &len) {
+    uint8_t bf[4];
+    if (fread(bf, 4, 1, f) != 1)
+      return false;
+    len = bf[0] | (bf[1] << 8) | (bf[2] << 16) | (uint32_t(bf[3]) << 24);
+    return true;
+  }
+
+  /** Read snapshot id and records. Stops at an incomplete (interrupted) record. */
+  bool readJournal(const wstring &file, string &snapshotId, vector<string> *records) {
+    FILE *f = nullptr;
+    _wfopen_s(&f, file.c_str(), L"rb");
+    if (f == nullptr)
+      return false;
+
+    char magic[journalMagicLen];
+    uint32_t len = 0;
+    if (fread(magic, journalMagicLen, 1, f) != 1 || memcmp(magic, journalMagic, journalMagicLen) != 0 ||
+        !readLength(f, len) || len > 1024) {
+      fclose(f);
+      return false;
+    }
+    snapshotId.resize(len);
+    if (len > 0 && fread(&snapshotId[0], len, 1, f) != 1) {
+      fclose(f);
+      return false;
+    }
+
+    if (records) {
+      string rec;
+      while (readLength(f, len) && len < maxJournalSize * 4) {
+        rec.resize(len);
+        if (len > 0 && fread(&rec[0], len, 1, f) != 1)
+          break;
+        records->push_back(rec);
+      }
+    }
+    fclose(f);
+    return true;
+  }
+}
+
+EventJournal::~EventJournal() {
+  stop();
+}
+
+wstring EventJournal::getJournalFile(const wstring &competitionFile) {
+  return competitionFile + L".journal";
+}
+
+string EventJournal::newSnapshotId() {
+  static std::mt19937_64 gen(std::random_device{}() ^ 
+                             std::chrono::high_resolution_clock::now().time_since_epoch().count());
+  char bf[32];
+  sprintf_s(bf, "%016llX", (unsigned long long)gen());
+  return bf;
+}
+
+void EventJournal::start(const wstring &competitionFile, const string &id) {
+  stop();
+  journalFileName = getJournalFile(competitionFile);
+  snapshotId = id;
+  snapshotRequested = false;
+  numCheckpoints = 0;
+
+  string existingId;
+  if (readJournal(journalFileName, existingId, nullptr) && existingId == snapshotId) {
+    _wfopen_s(&journalFile, journalFileName.c_str(), L"ab");
+    if (journalFile) {
+      fseek(journalFile, 0, SEEK_END);
+      journalSize = ftell(journalFile);
+    }
+  }
+  else {
+    _wfopen_s(&journalFile, journalFileName.c_str(), L"wb");
+    if (journalFile) {
+      fwrite(journalMagic, journalMagicLen, 1, journalFile);
+      writeLength(journalFile, snapshotId.size());
+      if (!snapshotId.empty())
+        fwrite(snapshotId.c_str(), snapshotId.size(), 1, journalFile);
+      flushToDisk(journalFile);
+      journalSize = journalMagicLen + 4 + snapshotId.size();
+    }
+  }
+}
+
+void EventJournal::stop() {
+  if (journalFile) {
+    fclose(journalFile);
+    journalFile = nullptr;
+  }
+}
+
+void EventJournal::writeRecord(const string &record) {
+  writeLength(journalFile, record.size());
+  bool ok = fwrite(record.c_str(), record.size(), 1, journalFile) == 1;
+  ok = flushToDisk(journalFile) && ok;
+  journalSize += record.size() + 4;
+  if (!ok) {
+    // Fall back to ordinary saving
+    stop();
+    snapshotRequested = true;
+  }
+}
+
+void EventJournal::changed(oBase &ob) {
+  if (!journalFile)
+    return;
+
+  if (ob.isRemoved()) {
+    removed(ob);
+    return;
+  }
+
+  xmlparser xml;
+  xml.openMemoryOutput(true);
+  if (!writeObject(ob, xml)) {
+    snapshotRequested = true;
+    return;
+  }
+  xml.closeOut();
+  string record;
+  xml.getMemoryOutput(record);
+
+  // Remove xml declaration
+  size_t start = record.find("?>");
+  start = start == string::npos ? 0 : record.find_first_not_of(" \r\n\t", start + 2);
+  if (start == string::npos)
+    return;
+
+  writeRecord(record.substr(start));
+}
+
+void EventJournal::removed(const oBase &ob) {
+  if (!journalFile)
+    return;
+
+  const char *tag = getTag(ob);
+  if (tag == nullptr) {
+    snapshotRequested = true;
+    return;
+  }
+
+  string record = "<Removed type=\"" + string(tag) + "\">" + itos(ob.getId()) + "</Removed>";
+  writeRecord(record);
+}
+
+bool EventJournal::checkpoint() {
+  if (!journalFile || snapshotRequested || journalSize > maxJournalSize)
+    return true;
+
+  return ++numCheckpoints >= maxCheckpoints;
+}
+
+bool JournalOverlay::load(const wstring &competitionFile, const string &snapshotId) {
+  string journalId;
+  vector<string> recs;
+  if (!readJournal(EventJournal::getJournalFile(competitionFile), journalId, &recs) || journalId != snapshotId)
+    return false;
+
+  if (recs.empty())
+    return false;
+
+  string doc = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Journal>\n";
+  for (const string &r : recs)
+    doc += r;
+  doc += "</Journal>\n";
+
+  xml = make_shared<xmlparser>();
+  xml->readMemory(doc, 0);
+  xmlobject root = xml->getObject("Journal");
+  if (!root)
+    return false;
+
+  root.getObjects(records);
+  for (size_t k = 0; k < records.size(); k++) {
+    const xmlobject &rec = records[k];
+    if (rec.is("Removed")) {
+      string type;
+      rec.getObjectString("type", type);
+      lastRecord[make_pair(type, rec.getInt())] = -1;
+    }
+    else {
+      lastRecord[make_pair(string(rec.getName()), rec.getObjectInt("Id"))] = k;
+    }
+  }
+  return true;
+}
+
+void JournalOverlay::merge(const char *tag, xmlList &objects) const {
+  xmlList merged;
+  merged.reserve(objects.size());
+  for (auto &obj : objects) {
+    if (obj.is(tag) && lastRecord.count(make_pair(string(tag), obj.getObjectInt("Id"))))
+      continue; // Replaced or removed
+    merged.push_back(obj);
+  }
+
+  for (size_t k = 0; k < records.size(); k++) {
+    if (!records[k].is(tag))
+      continue;
+    auto res = lastRecord.find(make_pair(string(tag), records[k].getObjectInt("Id")));
+    if (res != lastRecord.end() && res->second == int(k))
+      merged.push_back(records[k]);
+  }
+  objects.swap(merged);
+}
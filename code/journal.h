@@ -0,0 +1,96 @@
+﻿#pragma once
+/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License fro more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+
+#include <string>
+#include <map>
+#include <vector>
+#include <cstdio>
+#include "xmlparser.h"
+
+class oBase;
+class oEvent;
+
+/** Append-only journal of changed objects. Between full saves of a competition,
+    each synchronized object is appended to the journal, so that the competition
+    can be restored from the last saved file and the journal. */
+class EventJournal {
+  FILE *journalFile = nullptr;
+  wstring journalFileName;
+  string snapshotId;
+
+  size_t journalSize = 0;
+  int numCheckpoints = 0;
+  bool snapshotRequested = false;
+
+  void writeRecord(const string &record);
+
+public:
+  EventJournal() = default;
+  ~EventJournal();
+
+  EventJournal(const EventJournal &) = delete;
+  EventJournal &operator=(const EventJournal &) = delete;
+
+  /** The journal file for a competition file */
+  static wstring getJournalFile(const wstring &competitionFile);
+
+  /** Create a new unique id for a saved competition file */
+  static string newSnapshotId();
+
+  /** Start journaling changes of a competition saved with the specified snapshot id.
+      An existing journal for the same snapshot is continued, otherwise it is replaced. */
+  void start(const wstring &competitionFile, const string &snapshotId);
+
+  /** Stop journaling (the journal is kept) */
+  void stop();
+
+  bool isActive() const { return journalFile != nullptr; }
+
+  /** Append the current state of a changed object */
+  void changed(oBase &ob);
+
+  /** Append that an object was removed */
+  void removed(const oBase &ob);
+
+  /** Request a full save on next checkpoint, for changes not represented in the journal. */
+  void requestSnapshot() { snapshotRequested = true; }
+
+  /** Called on automatic save. Returns true if a full save should be made. */
+  bool checkpoint();
+};
+
+/** Journal entries for a saved competition, applied when opening the competition. */
+class JournalOverlay {
+  shared_ptr<xmlparser> xml;
+  // Last journaled state for each object, by tag and id. Removed objects map to -1.
+  map<pair<string, int>, int> lastRecord;
+  xmlList records;
+public:
+  /** Load the journal for a competition file. Returns false if there is no journal for the snapshot. */
+  bool load(const wstring &competitionFile, const string &snapshotId);
+
+  bool empty() const { return lastRecord.empty(); }
+
+  /** Replace objects with tag in the list with their journaled state. */
+  void merge(const char *tag, xmlList &objects) const;
+};
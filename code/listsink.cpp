@@ -0,0 +1,311 @@
+﻿/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+
+#include "stdafx.h"
+#include "listsink.h"
+#include "metalist.h"
+#include "meos_util.h"
+
+namespace {
+  enum class Escape {
+    None,
+    CSV,
+    JSON,
+    HTML,
+  };
+
+  void appendCodePoint(string &out, unsigned c) {
+    if (c < 0x80)
+      out.push_back(char(c));
+    else if (c < 0x800) {
+      out.push_back(char(0xC0 | (c >> 6)));
+      out.push_back(char(0x80 | (c & 0x3F)));
+    }
+    else if (c < 0x10000) {
+      out.push_back(char(0xE0 | (c >> 12)));
+      out.push_back(char(0x80 | ((c >> 6) & 0x3F)));
+      out.push_back(char(0x80 | (c & 0x3F)));
+    }
+    else {
+      out.push_back(char(0xF0 | (c >> 18)));
+      out.push_back(char(0x80 | ((c >> 12) & 0x3F)));
+      out.push_back(char(0x80 | ((c >> 6) & 0x3F)));
+      out.push_back(char(0x80 | (c & 0x3F)));
+    }
+  }
+
+  /** Append text as UTF-8, escaped for the output format. */
+  void appendText(string &out, const wstring &in, Escape esc) {
+    for (size_t k = 0; k < in.length(); k++) {
+      unsigned c = unsigned(in[k]);
+      if (c >= 0xD800 && c < 0xDC00 && k + 1 < in.length()) {
+        unsigned low = unsigned(in[k + 1]);
+        if (low >= 0xDC00 && low < 0xE000) {
+          appendCodePoint(out, 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00));
+          k++;
+          continue;
+        }
+      }
+
+      switch (esc) {
+      case Escape::CSV:
+        if (c == '"') {
+          out += "\"\"";
+          continue;
+        }
+        break;
+      case Escape::JSON:
+        if (c == '"' || c == '\\') {
+          out.push_back('\\');
+          out.push_back(char(c));
+          continue;
+        }
+        else if (c == '\n') {
+          out += "\\n";
+          continue;
+        }
+        else if (c < 0x20) {
+          char bf[8];
+          sprintf_s(bf, "\\u%04x", c);
+          out += bf;
+          continue;
+        }
+        break;
+      case Escape::HTML:
+        if (c == '<') {
+          out += "&lt;";
+          continue;
+        }
+        else if (c == '>') {
+          out += "&gt;";
+          continue;
+        }
+        else if (c == '&') {
+          out += "&amp;";
+          continue;
+        }
+        else if (c == '"') {
+          out += "&quot;";
+          continue;
+        }
+        else if (c == '\n') {
+          out += "<br>";
+          continue;
+        }
+        break;
+      default:
+        break;
+      }
+      appendCodePoint(out, c);
+    }
+  }
+
+  void appendCSVField(string &out, const wstring &in) {
+    if (in.find_first_of(L";\"\n\r") == wstring::npos)
+      appendText(out, in, Escape::None);
+    else {
+      out.push_back('"');
+      appendText(out, in, Escape::CSV);
+      out.push_back('"');
+    }
+  }
+}
+
+const char *ListSink::rowTypeName(RowType type) {
+  switch (type) {
+  case RowType::Head:
+    return "Head";
+  case RowType::SubHead:
+    return "SubHead";
+  case RowType::Post:
+    return "Post";
+  case RowType::SubPost:
+    return "SubPost";
+  }
+  return "";
+}
+
+void CSVListSink::beginSection(const wstring &title) {
+  section.clear();
+  appendCSVField(section, title);
+}
+
+void CSVListSink::addRow(RowType type, const vector<ListCell> &cells) {
+  if (type == RowType::Head || type == RowType::SubHead)
+    return;
+
+  line = section;
+  for (const ListCell &cell : cells) {
+    line.push_back(';');
+    appendCSVField(line, cell.text);
+  }
+  line.push_back('\n');
+  out.write(line.data(), line.size());
+}
+
+void JSONListSink::beginList(const wstring &name) {
+  buffer = "{\"name\":\"";
+  appendText(buffer, name, Escape::JSON);
+  buffer += "\",\"sections\":[";
+  out.write(buffer.data(), buffer.size());
+  inSection = false;
+  firstSection = true;
+}
+
+void JSONListSink::endList() {
+  buffer.clear();
+  if (inSection)
+    buffer = "]}";
+  buffer += "]}\n";
+  out.write(buffer.data(), buffer.size());
+  inSection = false;
+}
+
+void JSONListSink::beginSection(const wstring &title) {
+  buffer.clear();
+  if (inSection)
+    buffer = "]}";
+  if (!firstSection)
+    buffer.push_back(',');
+  buffer += "{\"title\":\"";
+  appendText(buffer, title, Escape::JSON);
+  buffer += "\",\"rows\":[";
+  out.write(buffer.data(), buffer.size());
+  inSection = true;
+  firstSection = false;
+  firstRow = true;
+}
+
+void JSONListSink::ensureSection() {
+  if (!inSection)
+    beginSection(L"");
+}
+
+void JSONListSink::addRow(RowType type, const vector<ListCell> &cells) {
+  ensureSection();
+  buffer.clear();
+  if (!firstRow)
+    buffer.push_back(',');
+  firstRow = false;
+  buffer += "{\"type\":\"";
+  buffer += rowTypeName(type);
+  buffer += "\",\"cells\":[";
+  for (size_t k = 0; k < cells.size(); k++) {
+    const ListCell &cell = cells[k];
+    if (k > 0)
+      buffer.push_back(',');
+    buffer += "{\"type\":\"";
+    appendText(buffer, MetaList::getTypeSymbol(cell.type), Escape::JSON);
+    buffer += "\",";
+    if (cell.line > 0) {
+      buffer += "\"line\":";
+      buffer += itos(cell.line);
+      buffer.push_back(',');
+    }
+    if (cell.idType == 'R') {
+      buffer += "\"runner\":";
+      buffer += itos(cell.id);
+      buffer.push_back(',');
+    }
+    else if (cell.idType == 'T') {
+      buffer += "\"team\":";
+      buffer += itos(cell.id);
+      buffer.push_back(',');
+    }
+    buffer += "\"text\":\"";
+    appendText(buffer, cell.text, Escape::JSON);
+    buffer += "\"}";
+  }
+  buffer += "]}";
+  out.write(buffer.data(), buffer.size());
+}
+
+void HTMLListSink::beginList(const wstring &name) {
+  buffer = "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"UTF-8\">\n<title>";
+  appendText(buffer, name, Escape::HTML);
+  buffer += "</title>\n</head>\n<body>\n";
+  out.write(buffer.data(), buffer.size());
+  inTable = false;
+}
+
+void HTMLListSink::endList() {
+  buffer.clear();
+  if (inTable)
+    buffer = "</table>\n";
+  buffer += "</body>\n</html>\n";
+  out.write(buffer.data(), buffer.size());
+  inTable = false;
+}
+
+void HTMLListSink::beginSection(const wstring &title) {
+  buffer.clear();
+  if (inTable)
+    buffer = "</table>\n";
+  inTable = false;
+  if (!title.empty()) {
+    buffer += "<h2>";
+    appendText(buffer, title, Escape::HTML);
+    buffer += "</h2>\n";
+  }
+  out.write(buffer.data(), buffer.size());
+}
+
+void HTMLListSink::ensureTable() {
+  if (!inTable) {
+    buffer += "<table>\n";
+    inTable = true;
+  }
+}
+
+void HTMLListSink::addRow(RowType type, const vector<ListCell> &cells) {
+  buffer.clear();
+  if (type == RowType::Head) {
+    if (inTable)
+      buffer = "</table>\n";
+    inTable = false;
+    buffer += "<div class=\"head\">";
+    for (size_t k = 0; k < cells.size(); k++) {
+      if (k > 0)
+        buffer += cells[k].line != cells[k - 1].line ? "<br>" : " ";
+      appendText(buffer, cells[k].text, Escape::HTML);
+    }
+    buffer += "</div>\n";
+  }
+  else {
+    ensureTable();
+    const char *cellTag = type == RowType::SubHead ? "th" : "td";
+    buffer += "<tr class=\"";
+    buffer += rowTypeName(type);
+    buffer += "\">";
+    for (const ListCell &cell : cells) {
+      buffer += "<";
+      buffer += cellTag;
+      buffer += ">";
+      appendText(buffer, cell.text, Escape::HTML);
+      buffer += "</";
+      buffer += cellTag;
+      buffer += ">";
+    }
+    buffer += "</tr>\n";
+  }
+  out.write(buffer.data(), buffer.size());
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+
+#include <ostream>
+#include "oListInfo.h"
+
+/** A formatted list cell, independent of any rendering. */
+struct ListCell {
+  EPostType type = lNone;
+  /** Line within the row, increased by line breaks in the list definition */
+  int line = 0;
+  /** Horizontal position in list units (not scaled) */
+  int x = 0;
+  /** Text format (font and alignment) */
+  int format = 0;
+  /** Id of the runner ('R') or team ('T') the cell refers to. */
+  char idType = 0;
+  int id = 0;
+  wstring text;
+};
+
+/** Receives formatted list rows from oEvent::generateList. */
+class ListSink {
+public:
+  enum class RowType {
+    Head,
+    SubHead,
+    Post,
+    SubPost,
+  };
+
+  virtual ~ListSink() = default;
+
+  virtual void beginList(const wstring &name) {}
+  virtual void endList() {}
+
+  /** A new part of the list, typically a class. */
+  virtual void beginSection(const wstring &title) {}
+
+  /** A row of cells. The cells are only valid during the call. */
+  virtual void addRow(RowType type, const vector<ListCell> &cells) = 0;
+
+  static const char *rowTypeName(RowType type);
+};
+
+/** Writes one line per list row, with the section title as first field.
+    Fields are separated by semicolon. Header rows are not written. */
+class CSVListSink : public ListSink {
+  std::ostream &out;
+  string line;
+  string section;
+public:
+  CSVListSink(std::ostream &out) : out(out) {}
+  void beginSection(const wstring &title) override;
+  void addRow(RowType type, const vector<ListCell> &cells) override;
+};
+
+/** Writes the list as a JSON object with sections of rows. */
+class JSONListSink : public ListSink {
+  std::ostream &out;
+  string buffer;
+  bool inSection = false;
+  bool firstRow = true;
+  bool firstSection = true;
+  void ensureSection();
+public:
+  JSONListSink(std::ostream &out) : out(out) {}
+  void beginList(const wstring &name) override;
+  void endList() override;
+  void beginSection(const wstring &title) override;
+  void addRow(RowType type, const vector<ListCell> &cells) override;
+};
+
+/** Writes the list as a plain HTML document with one table per section. */
+class HTMLListSink : public ListSink {
+  std::ostream &out;
+  string buffer;
+  bool inTable = false;
+  void ensureTable();
+public:
+  HTMLListSink(std::ostream &out) : out(out) {}
+  void beginList(const wstring &name) override;
+  void endList() override;
+  void beginSection(const wstring &title) override;
+  void addRow(RowType type, const vector<ListCell> &cells) override;
+};
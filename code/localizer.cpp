@@ -25,7 +25,7 @@
 #include "localizer.h"
 #include <fstream>
 #include <vector>
-#include "random.h"
+#include <mutex>
 #include "oFreeImport.h"
 #include "meos_util.h"
 
@@ -51,21 +51,44 @@ const wstring &fromUTF(const string &input) {
 class LocalizerImpl
 {
   wstring language;
-  map<wstring, wstring> table;
+  // Translation table. Keys are interned as ids (sorted by key) into the flat
+  // arrays keys/values. The table is immutable between loads, so lookups may
+  // run concurrently and return references into values.
+  vector<wstring> keys;
+  vector<wstring> values;
+  // Open addressing hash table of ids, -1 for empty. Size is a power of two.
+  vector<int> index;
+  // Translations composed from several parts, kept until the next load so that
+  // returned references stay valid. Grows with the number of distinct strings.
+  unordered_set<wstring> composed;
+  std::mutex composedLock;
   map<wstring, wstring> unknown;
+  std::mutex unknownLock;
   void loadTable(const vector<string> &raw, const wstring &language);
+  void setTable(map<wstring, wstring> &&table);
   mutable oWordList *givenNames;
 
   void addUnknown(const wstring& var);
 
+  template<typename T>
+  int find(const T *str, size_t len) const;
+
 public:
 
+  /** Return translation if str has a direct entry in the table
+      and needs no prefix processing, otherwise null. Thread safe. */
+  template<typename T>
+  const wstring *lookup(const T *str, size_t len) const;
+
   const oWordList &getGivenNames() const;
 
   void translateAll(const LocalizerImpl &all);
 
   const wstring &translate(const wstring &str, bool &found);
 
+  /** Keep a composed translation. Thread safe. */
+  const wstring &intern(wstring &&str);
+
   void saveUnknown(const wstring &file);
   void saveTable(const wstring &file);
   void saveTranslation(const wstring &file);
@@ -147,6 +170,14 @@ const wstring &Localizer::LocalizerInternal::tl(const wstring &str) const {
   return *ret;
 }
 
+const wstring *Localizer::LocalizerInternal::lookup(const string &str) const {
+  return impl->lookup(str.c_str(), str.length());
+}
+
+const wstring &Localizer::LocalizerInternal::intern(wstring &&str) const {
+  return impl->intern(std::move(str));
+}
+
 bool Localizer::LocalizerInternal::has(const string &str) const {
   wstring strw(str.begin(), str.end());
   bool found;
@@ -154,29 +185,105 @@ bool Localizer::LocalizerInternal::has(const string &str) const {
   return found;
 }
 
+namespace {
+  bool isDigit(wchar_t c) {
+    return c >= '0' && c <= '9';
+  }
+
+  /** True if a string starting with c is split into a prefix and a translated part */
+  bool isPrefixStart(wchar_t c) {
+    return c==',' || c==' ' || c=='.'
+       || c==':'  || c==';' || c=='<' || c=='>' 
+       || c=='-' || c==0x96 || c=='×' || isDigit(c) || c == '(';
+  }
+
+  inline wchar_t keyChar(wchar_t c) {
+    return c;
+  }
+
+  inline wchar_t keyChar(char c) {
+    return 0xFF & c;
+  }
+
+  template<typename T>
+  size_t keyHash(const T *str, size_t len) {
+    size_t h = 2166136261u;
+    for (size_t k = 0; k < len; k++)
+      h = (h ^ size_t(keyChar(str[k]))) * 16777619u;
+    return h;
+  }
+}
+
+template<typename T>
+int LocalizerImpl::find(const T *str, size_t len) const {
+  if (index.empty())
+    return -1;
+  size_t mask = index.size() - 1;
+  for (size_t ix = keyHash(str, len) & mask;; ix = (ix + 1) & mask) {
+    int id = index[ix];
+    if (id == -1)
+      return -1;
+    const wstring &key = keys[id];
+    if (key.length() != len)
+      continue;
+    size_t k = 0;
+    while (k < len && key[k] == keyChar(str[k]))
+      k++;
+    if (k == len)
+      return id;
+  }
+}
+
+template<typename T>
+const wstring *LocalizerImpl::lookup(const T *str, size_t len) const {
+  if (len == 0 || keyChar(str[0]) == '#' || isPrefixStart(keyChar(str[0])))
+    return nullptr;
+  int id = find(str, len);
+  return id >= 0 ? &values[id] : nullptr;
+}
+
+const wstring &LocalizerImpl::intern(wstring &&str) {
+  std::lock_guard<std::mutex> lock(composedLock);
+  return *composed.insert(std::move(str)).first;
+}
+
+void LocalizerImpl::setTable(map<wstring, wstring> &&table) {
+  composed.clear();
+  keys.clear();
+  values.clear();
+  keys.reserve(table.size());
+  values.reserve(table.size());
+  for (auto &kv : table) {
+    keys.push_back(kv.first);
+    values.push_back(std::move(kv.second));
+  }
+  table.clear();
+
+  size_t size = 16;
+  while (size < keys.size() * 2)
+    size *= 2;
+  index.assign(size, -1);
+  for (size_t id = 0; id < keys.size(); id++) {
+    size_t ix = keyHash(keys[id].c_str(), keys[id].length()) & (size - 1);
+    while (index[ix] != -1)
+      ix = (ix + 1) & (size - 1);
+    index[ix] = int(id);
+  }
+}
+
 const wstring &LocalizerImpl::translate(const wstring &str, bool &found) {
   found = false;
-  static int i = 0;
-  const int bsize = 17;
-  static wstring value[bsize];
   int len = str.length();
 
   if (len==0)
     return _EmptyWString;
 
   if (str[0]=='#') {
-    i = (i + 1)%bsize;
-    value[i] = str.substr(1);
     found = true;
-    return value[i];
+    return intern(str.substr(1));
   }
-  auto isDigit = [](wchar_t c) {
-    return c >= '0' && c <= '9';
-  };
 
-  if (str[0]==',' || str[0]==' ' || str[0]=='.'
-       || str[0]==':'  || str[0]==';' || str[0]=='<' || str[0]=='>' 
-       || str[0]=='-' || str[0]==0x96 || str[0]=='×' || isDigit(str[0]) || str[0] == '(') {
+  if (isPrefixStart(str[0])) {
     unsigned k=1;
     while(str[k] && (str[k]==' ' || str[k]=='.' || str[k]==':' || str[k]=='<' || str[k]=='>'
            || str[k]=='-' || str[k]==0x96 || str[k] == '×' || isDigit(str[k]) || str[k] == '('))
@@ -184,16 +291,17 @@ const wstring &LocalizerImpl::translate(const wstring &str, bool &found) {
 
     if (k<str.length()) {
       wstring sub = str.substr(k);
-      i = (i + 1)%bsize;
-      value[i] = str.substr(0, k) + translate(sub, found);
-      return value[i];
+      const wstring &tsub = translate(sub, found);
+      wstring res = str.substr(0, k);
+      res += tsub;
+      return intern(std::move(res));
     }
   }
 
-  map<wstring, wstring>::const_iterator it = table.find(str);
-  if (it != table.end()) {
+  int id = find(str.c_str(), str.length());
+  if (id >= 0) {
     found = true;
-    return it->second;
+    return values[id];
   }
 
   int subst = str.find_first_of('#');
@@ -223,16 +331,12 @@ const wstring &LocalizerImpl::translate(const wstring &str, bool &found) {
     if (lastpos<s.size())
       ret += s.substr(lastpos);
 
-    i = (i + 1)%bsize;
-    swap(value[i], ret);
-    return value[i];
+    return intern(std::move(ret));
   }
   else if (str[0] == '@') {
     // Untranslated string with substitution
-    i = (i + 1) % bsize;
-    value[i] = str.substr(1);
     found = true;
-    return value[i];
+    return intern(str.substr(1));
   }
 
   
@@ -245,9 +349,7 @@ const wstring &LocalizerImpl::translate(const wstring &str, bool &found) {
       addUnknown(str);
 #endif
     found = false;
-    i = (i + 1)%bsize;
-    value[i] = str;
-    return value[i];
+    return intern(wstring(str));
   }
 
   wstring suffix;
@@ -265,26 +367,24 @@ const wstring &LocalizerImpl::translate(const wstring &str, bool &found) {
 
   suffix = str.substr(pos+1);
 
-  wstring key = str.substr(0, str.length()-suffix.length());
-  it = table.find(key);
-  if (it != table.end()) {
-    i = (i + 1)%bsize;
-    value[i] = it->second + suffix;
+  size_t keyLen = str.length()-suffix.length();
+  id = find(str.c_str(), keyLen);
+  if (id >= 0) {
     found = true;
-    return value[i];
+    return intern(values[id] + suffix);
   }
 #ifdef _DEBUG
+  wstring key = str.substr(0, keyLen);
   if (key.length() > 1 && _wtoi(key.c_str()) == 0)
     addUnknown(key);
 #endif
 
   found = false;
-  i = (i + 1)%bsize;
-  value[i] = str;
-  return value[i];
+  return intern(wstring(str));
 }
 
 void LocalizerImpl::addUnknown(const wstring& key) {
+  std::lock_guard<std::mutex> lock(unknownLock);
   if (unknown.emplace(key, L"").second) {
     OutputDebugString((L"Missing resource: " + key).c_str());
   }
@@ -372,12 +472,11 @@ void Localizer::LocalizerInternal::debugDump(const wstring &untranslated, const
 }
 
 void LocalizerImpl::translateAll(const LocalizerImpl &all) {
-  map<wstring, wstring>::const_iterator it;
   bool f;
-  for (it = all.table.begin(); it != all.table.end(); ++it) {
-    translate(it->first, f);
+  for (size_t id = 0; id < all.keys.size(); id++) {
+    translate(all.keys[id], f);
     if (!f) {
-      unknown[it->first] = it->second;
+      unknown[all.keys[id]] = all.values[id];
     }
   }
 }
@@ -385,21 +484,21 @@ void LocalizerImpl::translateAll(const LocalizerImpl &all) {
 void LocalizerImpl::saveTable(const wstring &file) {
   const wstring newline = L"\n";
   ofstream fout(language+L"_"+file, ios::trunc|ios::out);
-  for (map<wstring, wstring>::iterator it = table.begin(); it!=table.end(); ++it) {
-    wstring value = it->second;
+  for (size_t id = 0; id < keys.size(); id++) {
+    wstring value = values[id];
     int nl = value.find(newline);
     while (nl!=string::npos) {
       value.replace(nl, newline.length(), L"\\n");
       nl = value.find(newline);
     }
-    fout << toUTF8(it->first) << " = " << toUTF8(value) << endl;
+    fout << toUTF8(keys[id]) << " = " << toUTF8(value) << endl;
   }
 }
 
 void LocalizerImpl::saveTranslation(const wstring &file) {
   ofstream fout(language + L"_" + file, ios::trunc | ios::out);
-  for (map<wstring, wstring>::iterator it = table.begin(); it != table.end(); ++it) {
-    fout << toUTF8(it->second) << endl;
+  for (const wstring &value : values) {
+    fout << toUTF8(value) << endl;
   }
 }
 
@@ -474,18 +573,11 @@ void LocalizerImpl::loadTable(const wstring &file, const wstring &language)
 
 void LocalizerImpl::loadTable(const vector<string> &raw, const wstring &language)
 {
-  vector<int> order(raw.size());
-  for (size_t k = 0; k<raw.size(); k++)
-    order[k] = k;
-
-  // Optimize insertation order
-  permute(order);
-
-  table.clear();
+  map<wstring, wstring> table;
   this->language = language;
   string nline = "\n";
   for (size_t k=0;k<raw.size();k++) {
-    const string &s = raw[order[k]];
+    const string &s = raw[k];
     size_t pos = s.find_first_of('=');
 
     if (pos==string::npos)
@@ -552,13 +644,17 @@ void LocalizerImpl::loadTable(const vector<string> &raw, const wstring &language
         table[wkey.substr(1, wkey.length() - 2)] = wvalue.substr(1, wvalue.length() - 2);
     }
   }
+  setTable(std::move(table));
 }
 
 #endif
 
 void LocalizerImpl::clear()
 {
-  table.clear();
+  composed.clear();
+  keys.clear();
+  values.clear();
+  index.clear();
   unknown.clear();
   language.clear();
 }
@@ -570,9 +666,14 @@ bool Localizer::capitalizeWords() const {
 const wstring &Localizer::tl(const string &str) const {
   if (str.length() == 0)
     return _EmptyWString;
-  wstring key(str.begin(), str.end());
+  const wstring *direct = linternal->lookup(str);
+  if (direct)
+    return *direct;
+
+  thread_local wstring key;
+  key.resize(str.length());
   for (size_t k = 0; k < key.size(); k++) {
-    key[k] = 0xFF&key[k];
+    key[k] = 0xFF&str[k];
   }
   return linternal->tl(key);
 }
@@ -580,10 +681,9 @@ const wstring &Localizer::tl(const string &str) const {
 const wstring &Localizer::tl(const wstring &str, bool cap) const {
   const wstring &w = linternal->tl(str);
   if (cap && capitalizeWords()) {
-    wstring &wres = StringCache::getInstance().wget();
-    wres = w;
+    wstring wres = w;
     ::capitalizeWords(wres);
-    return wres;
+    return linternal->intern(std::move(wres));
   }
   return w;
 }
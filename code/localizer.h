@@ -48,6 +48,13 @@ class Localizer {
 
     /** Translate string */
     const wstring &tl(const wstring &str) const;
+
+    /** Direct table lookup without allocation. Returns null if the string 
+        needs the general translation. */
+    const wstring *lookup(const string &str) const;
+
+    /** Keep a string composed from a translation until the next language load. */
+    const wstring &intern(wstring &&str) const;
     
     // Return if translation exists
     bool has(const string &str) const;
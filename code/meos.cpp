@@ -1223,12 +1223,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     case WM_USER:
       //The card has been read and posted to a synchronized
       //queue by different thread. Read and process this card.
-      {
-        SICard sic(ConvertedTimeStatus::Unknown);
-        while (gSI && gSI->getCard(sic))
-          InsertSICard(*gdi_main, sic);
-        break;
-      }
+      if (gSI)
+        gSI->processReadouts([](SICard &sic) { InsertSICard(*gdi_main, sic); });
+      break;
     case WM_USER+1:
       MessageBox(hWnd, lang.tl(L"Kommunikationen med en SI-enhet avbröts.").c_str(), L"SportIdent", MB_OK);
       break;
@@ -2509,6 +2509,21 @@ int compareStringIgnoreCase(const wstring &a, const wstring &b) {
                        b.c_str(), b.length()) - CSTR_EQUAL;
 }
 
+void CollationKey::update(const wstring &str) const {
+  source = str;
+  valid = true;
+  key.clear();
+  if (str.empty())
+    return;
+  int len = LCMapString(LOCALE_USER_DEFAULT, LCMAP_SORTKEY, str.c_str(), str.length(), nullptr, 0);
+  if (len > 0) {
+    key.resize(len);
+    len = LCMapString(LOCALE_USER_DEFAULT, LCMAP_SORTKEY, str.c_str(), str.length(), (LPWSTR)&key[0], len);
+    // The key is zero terminated
+    key.resize(len > 0 ? len - 1 : 0);
+  }
+}
+
 const char* meosException::narrow(const wstring& msg) {
   static string nmsg(msg.begin(), msg.end());
   return nmsg.c_str();
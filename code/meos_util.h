@@ -141,6 +141,22 @@ const T& unsplit(const vector<T>& split_vector, const T& separators, T& line);
 
 // Compare two strings, ignore case. 0 = equal, != zero compares as the integers.
 int compareStringIgnoreCase(const wstring &a, const wstring &b);
+
+/** Cached binary sort key of a string in the user locale. Two keys
+    compare (as byte strings) like CompareString compares the strings.
+    The key is recomputed when the string changes. */
+class CollationKey {
+  mutable wstring source;
+  mutable string key;
+  mutable bool valid = false;
+public:
+  const string &get(const wstring &str) const {
+    if (!valid || source != str)
+      update(str);
+    return key;
+  }
+  void update(const wstring &str) const;
+};
 const wstring &limitText(const wstring& tIn, size_t numChar);
 wstring ensureEndingColon(const wstring &text);
 
@@ -245,6 +261,8 @@ public:
 
 void unzip(const wchar_t *zipfilename, const char *password, vector<wstring> &extractedFiles);
 int zip(const wchar_t *zipfilename, const char *password, const vector<wstring> &files);
+/** Build a zip archive in memory with data stored as a single file.*/
+void zipMemory(const string &fileNameInZip, const string &data, string &zipped);
 
 bool isAscii(const wstring &s);
 bool isNumber(const wstring &s);
@@ -3441,6 +3441,14 @@ EPostType MetaList::getTypeFromSymbol(wstring &symb) noexcept {
   return res->second;
 }
 
+const wstring &MetaList::getTypeSymbol(EPostType type) noexcept {
+  auto res = typeToSymbol.find(type);
+  if (res == typeToSymbol.end())
+    return _EmptyWString;
+
+  return res->second;
+}
+
 void MetaList::fillSymbols(vector < pair<wstring, size_t>> &symb) {
   for (auto s : symbolToType) {
     if (s.second == lAlignNext || s.second == lNone 
@@ -444,6 +444,9 @@ public:
   /** Lookup type from symbol. Return lNone if not found, no exception*/
   static EPostType getTypeFromSymbol(wstring &symb) noexcept;
 
+  /** Lookup symbol from type. Return empty string if not found*/
+  static const wstring &getTypeSymbol(EPostType type) noexcept;
+
   static void fillSymbols(vector < pair<wstring, size_t>> &symb);
 
   static const map<SortOrder, string>& getOrderToSymbol() {
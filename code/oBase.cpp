@@ -68,6 +68,7 @@ oBase::oBase(const oBase &in) {
   sqlUpdated = in.sqlUpdated;
   localObject = in.localObject;
   transientChanged = in.transientChanged;
+  changeRevision = in.changeRevision;
 }
 
 oBase::oBase(oBase &&in) {
@@ -84,6 +85,7 @@ oBase::oBase(oBase &&in) {
   sqlUpdated = std::move(in.sqlUpdated);
   localObject = in.localObject;
   transientChanged = in.transientChanged;
+  changeRevision = in.changeRevision;
   if (in.myReference) {
     myReference.swap(in.myReference);
     myReference->ref = this;
@@ -104,6 +106,7 @@ const oBase &oBase::operator=(const oBase &in) {
   sqlUpdated = in.sqlUpdated;
   localObject = in.localObject;
   transientChanged = in.transientChanged;
+  changeRevision = in.changeRevision;
   return *this;
 }
 
@@ -123,6 +126,11 @@ bool oBase::synchronize(bool writeOnly)
   if (oe && (changed || transientChanged)) {
     changedObject();
     oe->dataRevision++;
+    changeRevision = oe->dataRevision;
+    if (markResultChanged())
+      oe->classLocalRevisions++;
+    if (changed)
+      oe->journalChanged(*this);
   }
   transientChanged = false;
   if (oe && oe->hasDBConnection() && (changed || !writeOnly)) {
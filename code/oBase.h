@@ -87,12 +87,18 @@ private:
   bool changed;
   // Changed in client, silent mode, should not be sent to server
   bool transientChanged;
+  // Data revision of the last synchronized change of this object
+  unsigned long changeRevision = 0;
   bool localObject;
 
 protected:
   /// Mark the object as "changed" (locally or remotely), eg lists and other views may need update
   virtual void changedObject() = 0;
 
+  /** Mark the results of the classes affected by a change of this object as changed.
+      Return false if the change may affect the results of any class. */
+  virtual bool markResultChanged() { return false; }
+
   /** Change the id of the object */
   virtual void changeId(int newId);
 
@@ -142,6 +148,11 @@ public:
   oEvent *getEvent() const {return oe;}
   int getId() const {return Id;}
   bool isChanged() const {return changed;}
+  /** Returns true if the object is changed after the given data revision, or has unsynchronized changes */
+  bool isChangedSince(unsigned long revision) const {return changed || transientChanged || changeRevision > revision;}
+  /** Returns true if a table row of this object may show other contents than at the given data revision.
+      The row may depend on other objects, such as places and club names. */
+  virtual bool isRowChangedSince(unsigned long revision) const {return true;}
   bool isRemoved() const {return Removed;}
   int getAge() const {return Modified.getAge();}
   unsigned int getModificationTime() const {return Modified.getModificationTime();}
@@ -764,6 +764,13 @@ void oCard::changedObject() {
   oe->sqlCards.changed = true;
 }
 
+bool oCard::markResultChanged() {
+  if (tOwner)
+    return tOwner->markResultChanged();
+
+  return false;
+}
+
 int oCard::getNumControlPunches(int startPunchType, int finishPunchType) const {
   int count = 0;
   for(oPunchList::const_iterator it = punches.begin(); it != punches.end(); ++it) {
@@ -65,6 +65,7 @@ protected:
   oDataContainer &getDataBuffers(pvoid &data, pvoid &olddata, pvectorstr &strData) const;
 
   void changedObject();
+  bool markResultChanged();
 
   mutable string punchString;
 
@@ -3977,6 +3977,23 @@ void oClass::clearCache(bool recalculate) {
     oe->reCalculateLeaderTimes(getId());
   clearSplitAnalysis();
   tResultInfo.clear();//Do on competitor remove!
+  tResultCalcRevision.clear();
+}
+
+void oClass::setResultChanged() {
+  tResultChangeRevision = oe->dataRevision;
+}
+
+bool oClass::isResultOld(int resultKey) const {
+  auto res = tResultCalcRevision.find(resultKey);
+  if (res == tResultCalcRevision.end())
+    return true;
+
+  return res->second < max(tResultChangeRevision, oe->getGlobalResultRevision());
+}
+
+void oClass::setResultCalculated(int resultKey, unsigned long revision) const {
+  tResultCalcRevision[resultKey] = revision;
 }
 
 
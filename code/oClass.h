@@ -131,6 +131,32 @@ struct ClassResultInfo {
   int lastStartTime;
 };
 
+/** Partial sums over the runners and teams of one class, for event wide
+    statistics. Only the classes with changes since the last calculation are
+    recounted, see oClass::isResultOld. */
+struct ClassAggregates {
+  struct MapUsage {
+    int used = 0;
+    int usedNoVacant = 0;
+  };
+
+  struct ControlStat {
+    int missedTimeTotal = 0;
+    int missedTimeMax = 0;
+    int numVisitorsActual = 0;
+    int numVisitorsExpected = 0;
+    int numRunnersRemaining = 0;
+    int numMistakes = 0;
+    vector<int> missedTimes;
+  };
+
+  MapUsage classMaps;
+  // Maps by course id
+  vector<pair<int, MapUsage>> courseMaps;
+  // Statistics by control id
+  map<int, ControlStat> controlStat;
+};
+
 class QualificationFinal;
 
 enum ClassType {
@@ -268,6 +294,11 @@ protected:
   mutable ClassStatus tStatus;
   mutable int tStatusRevision;
 
+  // Data revision of the last change of a runner or team in the class
+  unsigned long tResultChangeRevision = 0;
+  // Data revision when the results were last calculated, by result key
+  mutable map<int, unsigned long> tResultCalcRevision;
+
   // A map with places for given times on given legs
   inthashmap *tLegTimeToPlace;
   inthashmap *tLegAccTimeToPlace;
@@ -376,6 +407,8 @@ protected:
   mutable int tMapsUsed;
   mutable int tMapsUsedNoVacant;
 
+  mutable ClassAggregates tAggregates;
+
   // First is data revision, second is key
   mutable pair<int, map<string, int>> tTypeKeyToRunnerCount;
 
@@ -769,6 +802,19 @@ public:
   // Clear cached data
   void clearCache(bool recalculate);
 
+  /** Mark that a runner or team in the class has changed and that results must be recalculated */
+  void setResultChanged();
+  /** Data revision of the last change of a runner or team in the class */
+  unsigned long getResultChangeRevision() const {return tResultChangeRevision;}
+  /** Returns true if the results for the specified result key are not calculated or outdated */
+  bool isResultOld(int resultKey) const;
+  /** Mark results for the specified key as calculated for the given data revision */
+  void setResultCalculated(int resultKey, unsigned long revision) const;
+
+  /** Result keys for the aggregates in tAggregates */
+  static const int ResultKeyMaps = -1;
+  static const int ResultKeyControlStatistics = -2;
+
   // Check if forking is fair
   bool checkForking(vector< vector<int> > &legOrder,
                     vector< vector<int> > &forks,
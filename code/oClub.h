@@ -27,6 +27,7 @@
 
 #include <map>
 #include "oBase.h"
+#include "meos_util.h"
 
 class oEvent;
 
@@ -62,6 +63,7 @@ protected:
   vector<wstring> altNames;
   wstring tPrettyName;
   wstring tCompactName;
+  CollationKey tNameKey;
 
   static map<wstring, wstring> manualCompactNameMap;
   
@@ -188,6 +190,8 @@ public:
   int getDataAmount() const;
 
   const wstring &getName() const {return name;}
+  /** Binary sort key of the name in the user locale. Compare with operator<. */
+  const string &getNameSortKey() const { return tNameKey.get(name); }
 
   const wstring &getDisplayName() const {return tPrettyName.empty() ?  name : tPrettyName;}
 
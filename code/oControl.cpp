@@ -710,8 +710,95 @@ int oControl::getNumRunnersRemaining() const {
   return tNumRunnersRemaining;
 }
 
+/** Add the control statistics of a runner to the aggregates of its class. */
+static void addControlStatistics(const oRunner &r, ClassAggregates &agg, vector<int> &delta) {
+  pCourse pc = r.getCourse(true);
+  if (!pc)
+    return;
+  r.getSplitAnalysis(delta);
+
+  int nc = pc->getNumControls();
+  if (unsigned(nc) < delta.size()) {
+    for (int i = 0; i<nc; i++) {
+      pControl ctrl = pc->getControl(i);
+      if (!ctrl)
+        continue;
+      ClassAggregates::ControlStat &cs = agg.controlStat[ctrl->getId()];
+      if (delta[i] > 0) {
+        if (delta[i] < 10 * timeConstMinute)
+          cs.missedTimeTotal += delta[i];
+        else
+          cs.missedTimeTotal += 10 * timeConstMinute; // Use max 10 minutes
+
+        cs.missedTimeMax = max(cs.missedTimeMax, delta[i]);
+        cs.missedTimes.push_back(delta[i]);
+        ++cs.numMistakes;
+      }
+
+      cs.numVisitorsActual++;
+    }
+  }
+
+  if (!r.isVacant() && r.getStatus() != StatusDNS && r.getStatus() != StatusCANCEL
+                    && r.getStatus() != StatusNotCompeting) {
+    bool foundRadio = false;
+    bool unordered = pc->getCommonControl() != false;
+
+    for (int i = nc - 1; i >= 0; i--) {
+      pControl ctrl = pc->getControl(i);
+      if (!ctrl)
+        continue;
+      ClassAggregates::ControlStat &cs = agg.controlStat[ctrl->getId()];
+      cs.numVisitorsExpected++;
+
+      if (r.getStatus() == StatusUnknown) {
+        if (!foundRadio && r.getPunchTime(i, false, false, false) == -1)
+          cs.numRunnersRemaining++;
+        else if (!unordered) {
+          foundRadio = true;
+        }
+      }
+    }
+  }
+}
+
 void oEvent::setupControlStatistics() const {
-  // Reset all times
+  // Recalculate classes where a runner or team has changed
+  set<int> changedClasses;
+  for (auto &c : Classes) {
+    if (!c.isRemoved() && c.isResultOld(oClass::ResultKeyControlStatistics)) {
+      changedClasses.insert(c.Id);
+      c.tAggregates.controlStat.clear();
+    }
+  }
+
+  vector<int> delta;
+  const unsigned long noClassRevision = max(getGlobalResultRevision(), noClassResultRevision);
+  if (tNoClassStatRevision != noClassRevision) {
+    tNoClassAggregates.controlStat.clear();
+    for (auto &r : Runners) {
+      if (!r.isRemoved() && r.getClassRef(true) == nullptr)
+        addControlStatistics(r, tNoClassAggregates, delta);
+    }
+    tNoClassStatRevision = noClassRevision;
+  }
+
+  if (!changedClasses.empty()) {
+    vector<pRunner> runners;
+    getRunners(changedClasses, runners);
+    for (pRunner r : runners) {
+      pClass cls = r->getClassRef(true);
+      if (cls && changedClasses.count(cls->Id))
+        addControlStatistics(*r, cls->tAggregates, delta);
+    }
+
+    for (auto &c : Classes) {
+      if (changedClasses.count(c.Id))
+        c.setResultCalculated(oClass::ResultKeyControlStatistics, dataRevision);
+    }
+  }
+
+  // Sum up
   for (auto &ctrl : Controls) {
     ctrl.tMissedTimeMax = 0;
     ctrl.tMissedTimeTotal = 0;
@@ -724,55 +811,28 @@ void oEvent::setupControlStatistics() const {
   }
 
   map<int, pair<int, vector<int>>> lostPerControl; // First is "actual" misses,
-  vector<int> delta;
-  for (auto &r : Runners) {
-    if (r.isRemoved())
-      continue;
-    pCourse pc = r.getCourse(true);
-    if (!pc)
-      continue;
-    r.getSplitAnalysis(delta);
-
-    int nc = pc->getNumControls();
-    if (unsigned(nc) < delta.size()) {
-      for (int i = 0; i<nc; i++) {
-        pControl ctrl = pc->getControl(i);
-        if (ctrl && delta[i]>0) {
-          if (delta[i] < 10 * timeConstMinute)
-            ctrl->tMissedTimeTotal += delta[i];
-          else
-            ctrl->tMissedTimeTotal += 10 * timeConstMinute; // Use max 10 minutes
-
-          ctrl->tMissedTimeMax = max(ctrl->tMissedTimeMax, delta[i]);
-        }
-
-        if (delta[i] > 0) {
-          lostPerControl[ctrl->getId()].second.push_back(delta[i]);
-          ++lostPerControl[ctrl->getId()].first;
-        }
-
-        ctrl->tNumVisitorsActual++;
+  auto addStatistics = [this, &lostPerControl](const ClassAggregates &agg) {
+    for (auto &cs : agg.controlStat) {
+      pControl ctrl = getControl(cs.first);
+      if (!ctrl)
+        continue;
+      ctrl->tMissedTimeTotal += cs.second.missedTimeTotal;
+      ctrl->tMissedTimeMax = max(ctrl->tMissedTimeMax, cs.second.missedTimeMax);
+      ctrl->tNumVisitorsActual += cs.second.numVisitorsActual;
+      ctrl->tNumVisitorsExpected += cs.second.numVisitorsExpected;
+      ctrl->tNumRunnersRemaining += cs.second.numRunnersRemaining;
+      if (cs.second.numMistakes > 0) {
+        auto &lost = lostPerControl[cs.first];
+        lost.first += cs.second.numMistakes;
+        lost.second.insert(lost.second.end(), cs.second.missedTimes.begin(), cs.second.missedTimes.end());
       }
     }
+  };
 
-    if (!r.isVacant() && r.getStatus() != StatusDNS && r.getStatus() != StatusCANCEL
-                        && r.getStatus() != StatusNotCompeting) {
-      bool foundRadio = false;
-      bool unordered = pc->getCommonControl() != false;
-      
-      for (int i = nc - 1; i >= 0; i--) {
-        pControl ctrl = pc->getControl(i);
-        ctrl->tNumVisitorsExpected++;
-
-        if (r.getStatus() == StatusUnknown) {
-          if (!foundRadio && r.getPunchTime(i, false, false, false) == -1)
-            ctrl->tNumRunnersRemaining++;
-          else if (!unordered) {
-            foundRadio = true;
-          }
-        }
-      }
-    }
+  addStatistics(tNoClassAggregates);
+  for (auto &c : Classes) {
+    if (!c.isRemoved())
+      addStatistics(c.tAggregates);
   }
 
   for (auto &ctrl : Controls) {
@@ -802,7 +862,34 @@ void oEvent::setupControlStatistics() const {
       }
     }
   }
+
+#ifdef _DEBUG
+  checkControlStatistics();
+#endif
+}
+
+#ifdef _DEBUG
+void oEvent::checkControlStatistics() const {
+  // Calculate from scratch and compare with the aggregated statistics
+  ClassAggregates all;
+  vector<int> delta;
+  for (auto &r : Runners) {
+    if (!r.isRemoved())
+      addControlStatistics(r, all, delta);
+  }
+
+  for (auto &ctrl : Controls) {
+    if (ctrl.isRemoved())
+      continue;
+    ClassAggregates::ControlStat &cs = all.controlStat[ctrl.getId()];
+    assert(ctrl.tMissedTimeTotal == cs.missedTimeTotal);
+    assert(ctrl.tMissedTimeMax == cs.missedTimeMax);
+    assert(ctrl.tNumVisitorsActual == cs.numVisitorsActual);
+    assert(ctrl.tNumVisitorsExpected == cs.numVisitorsExpected);
+    assert(ctrl.tNumRunnersRemaining == cs.numRunnersRemaining);
+  }
 }
+#endif
 
 bool oEvent::hasRogaining() const
 {
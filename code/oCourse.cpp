@@ -722,6 +722,24 @@ const wstring &oCourse::getStart() const {
   return getDCI().getString("StartName");
 }
 
+static void addMapUsage(vector<pair<int, ClassAggregates::MapUsage>> &usage, int courseId, bool vacant) {
+  for (auto &u : usage) {
+    if (u.first == courseId) {
+      u.second.used++;
+      if (!vacant)
+        u.second.usedNoVacant++;
+      return;
+    }
+  }
+  usage.emplace_back(courseId, ClassAggregates::MapUsage());
+  usage.back().second.used = 1;
+  usage.back().second.usedNoVacant = vacant ? 0 : 1;
+}
+
+static bool usesMap(const oRunner &r) {
+  return !r.isRemoved() && r.getStatus() != StatusDNS && r.getStatus() != StatusCANCEL;
+}
+
 void oEvent::calculateNumRemainingMaps(bool forceRecalculate) {
   if (!forceRecalculate) {
     if (dataRevision == tCalcNumMapsDataRevision)
@@ -729,7 +747,80 @@ void oEvent::calculateNumRemainingMaps(bool forceRecalculate) {
   }
 
   synchronizeList({ oListId::oLCourseId, oListId::oLClassId, oListId::oLTeamId, oListId::oLRunnerId });
-  
+
+  // Recount classes where a runner or team has changed
+  set<int> changedClasses;
+  for (auto &cit : Classes) {
+    if (!cit.isRemoved() && (forceRecalculate || cit.isResultOld(oClass::ResultKeyMaps))) {
+      changedClasses.insert(cit.Id);
+      cit.tAggregates.classMaps = ClassAggregates::MapUsage();
+      cit.tAggregates.courseMaps.clear();
+    }
+  }
+
+  const unsigned long noClassRevision = max(getGlobalResultRevision(), noClassResultRevision);
+  bool noClassChanged = forceRecalculate || tNoClassMapsRevision != noClassRevision;
+
+  if (noClassChanged) {
+    tNoClassAggregates.courseMaps.clear();
+    for (auto &r : Runners) {
+      if (usesMap(r) && r.getClassRef(true) == nullptr) {
+        pCourse pc = r.getCourse(false);
+        if (pc)
+          addMapUsage(tNoClassAggregates.courseMaps, pc->getId(), r.isVacant());
+      }
+    }
+    tNoClassMapsRevision = noClassRevision;
+  }
+
+  if (!changedClasses.empty()) {
+    vector<pRunner> runners;
+    getRunners(changedClasses, runners);
+    for (pRunner r : runners) {
+      pClass cls = r->getClassRef(true);
+      if (!cls || !usesMap(*r) || !changedClasses.count(cls->Id))
+        continue;
+
+      ClassAggregates &agg = cls->tAggregates;
+      agg.classMaps.used++;
+      if (!r->isVacant())
+        agg.classMaps.usedNoVacant++;
+
+      pCourse pc = r->getCourse(false);
+      if (pc)
+        addMapUsage(agg.courseMaps, pc->getId(), r->isVacant());
+    }
+
+    // Count maps used for vacant team positions
+    for (oTeamList::const_iterator it = Teams.begin(); it != Teams.end(); ++it) {
+      if (it->isRemoved() || !it->Class || !changedClasses.count(it->Class->Id))
+        continue;
+
+      ClassAggregates &agg = it->Class->tAggregates;
+      for (size_t j = 0; j < it->Runners.size(); j++) {
+        if (it->Runners[j])
+          continue; // Already included
+
+        agg.classMaps.used++;
+        const vector<pCourse> &courses = it->Class->MultiCourse[j];
+        if (courses.size()>0) {
+          int index = it->StartNo;
+          if (index > 0)
+            index = (index-1) % courses.size();
+          pCourse tCrs = courses[index];
+          if (tCrs)
+            addMapUsage(agg.courseMaps, tCrs->getId(), true);
+        }
+      }
+    }
+
+    for (auto &cit : Classes) {
+      if (changedClasses.count(cit.Id))
+        cit.setResultCalculated(oClass::ResultKeyMaps, dataRevision);
+    }
+  }
+
+  // Sum up
   for (auto &cit : Courses) {
     if (cit.isRemoved())
       continue;
@@ -744,78 +835,95 @@ void oEvent::calculateNumRemainingMaps(bool forceRecalculate) {
     cit.tMapsUsedNoVacant = 0;
   }
 
+  auto addCourseMaps = [this](const ClassAggregates &agg) {
+    for (auto &cm : agg.courseMaps) {
+      pCourse pc = getCourse(cm.first);
+      if (pc) {
+        pc->tMapsUsed += cm.second.used;
+        pc->tMapsUsedNoVacant += cm.second.usedNoVacant;
+        if (pc->tMapsRemaining != numeric_limits<int>::min())
+          pc->tMapsRemaining -= cm.second.used;
+      }
+    }
+  };
+
+  addCourseMaps(tNoClassAggregates);
+
   for (auto &cit : Classes) {
     if (cit.isRemoved())
       continue;
 
     int numMaps = cit.getNumberMaps(true);
+    cit.tMapsUsed = cit.tAggregates.classMaps.used;
+    cit.tMapsUsedNoVacant = cit.tAggregates.classMaps.usedNoVacant;
     if (numMaps == 0)
       cit.tMapsRemaining = numeric_limits<int>::min();
     else
-      cit.tMapsRemaining = numMaps;
+      cit.tMapsRemaining = numMaps - cit.tMapsUsed;
 
-    cit.tMapsUsed = 0;
-    cit.tMapsUsedNoVacant = 0;
+    addCourseMaps(cit.tAggregates);
   }
 
-  for (oRunnerList::const_iterator it=Runners.begin(); it != Runners.end(); ++it) {
-    if (!it->isRemoved() && it->getStatus() != StatusDNS && it->getStatus() != StatusCANCEL) {
-      pCourse pc = it->getCourse(false);
-      if (pc) {
-        if (pc->tMapsRemaining != numeric_limits<int>::min())
-          pc->tMapsRemaining--;
+#ifdef _DEBUG
+  checkNumRemainingMaps();
+#endif
 
-        pc->tMapsUsed++;
-        if (!it->isVacant())
-          pc->tMapsUsedNoVacant++;
-      }
-      pClass cls = it->getClassRef(true);
-      if (cls) {
-        if (cls->tMapsRemaining != numeric_limits<int>::min())
-          cls->tMapsRemaining--;
-
-        cls->tMapsUsed++;
-        if (!it->isVacant())
-          cls->tMapsUsedNoVacant++;
-      }
+  tCalcNumMapsDataRevision = dataRevision;
+}
+
+#ifdef _DEBUG
+void oEvent::checkNumRemainingMaps() const {
+  // Count from scratch and compare with the aggregated counts
+  map<int, ClassAggregates::MapUsage> courseUsage, classUsage;
+  for (auto &r : Runners) {
+    if (!usesMap(r))
+      continue;
+    pCourse pc = r.getCourse(false);
+    if (pc) {
+      courseUsage[pc->getId()].used++;
+      if (!r.isVacant())
+        courseUsage[pc->getId()].usedNoVacant++;
+    }
+    pClass cls = r.getClassRef(true);
+    if (cls) {
+      classUsage[cls->getId()].used++;
+      if (!r.isVacant())
+        classUsage[cls->getId()].usedNoVacant++;
     }
   }
 
-  // Count maps used for vacant team positions
-
-  for (oTeamList::const_iterator it=Teams.begin(); it != Teams.end(); ++it) {
-    if (!it->isRemoved()) {
-      for (size_t j = 0; j < it->Runners.size(); j++) {
-        pRunner r = it->Runners[j];
-        if (r)
-          continue; // Already included
-
-        if (it->Class) {
-          it->Class->tMapsUsed++;
-
-          if (it->Class->tMapsRemaining != numeric_limits<int>::min())
-            it->Class->tMapsRemaining--;
-
-          const vector<pCourse> &courses = it->Class->MultiCourse[j];
-          if (courses.size()>0) {
-            int index = it->StartNo;
-            if (index > 0)
-              index = (index-1) % courses.size();
-            pCourse tCrs = courses[index];
-            if (tCrs) {
-              tCrs->tMapsUsed++;
-
-              if (tCrs->tMapsRemaining != numeric_limits<int>::min())
-                tCrs->tMapsRemaining--;
-            }
-          }
-        }
+  for (auto &t : Teams) {
+    if (t.isRemoved() || !t.Class)
+      continue;
+    for (size_t j = 0; j < t.Runners.size(); j++) {
+      if (t.Runners[j])
+        continue;
+      classUsage[t.Class->getId()].used++;
+      const vector<pCourse> &courses = t.Class->MultiCourse[j];
+      if (courses.size() > 0) {
+        int index = t.StartNo;
+        if (index > 0)
+          index = (index - 1) % courses.size();
+        if (courses[index])
+          courseUsage[courses[index]->getId()].used++;
       }
-    }    
+    }
   }
 
-  tCalcNumMapsDataRevision = dataRevision;
+  for (auto &c : Courses) {
+    if (!c.isRemoved()) {
+      assert(c.tMapsUsed == courseUsage[c.getId()].used);
+      assert(c.tMapsUsedNoVacant == courseUsage[c.getId()].usedNoVacant);
+    }
+  }
+  for (auto &c : Classes) {
+    if (!c.isRemoved()) {
+      assert(c.tMapsUsed == classUsage[c.getId()].used);
+      assert(c.tMapsUsedNoVacant == classUsage[c.getId()].usedNoVacant);
+    }
+  }
 }
+#endif
 
 int oCourse::getIdSum(int nC) {
 
@@ -60,6 +60,7 @@
 #include "datadefiners.h"
 #include "maprenderer.h"
 #include "xmlparser.h"
+#include "journal.h"
 
 #include <chrono>
 #include <random>
@@ -858,6 +859,8 @@ bool oEvent::save()
     finalRenameTarget = fn1;
     //rename(CurrentFile, fn1);
   }
+  string previousSnapshotId = journalSnapshotId;
+  journalSnapshotId = EventJournal::newSnapshotId();
   bool res;
   if (finalRenameTarget.empty()) {
     res = save(CurrentFile, true, true);
@@ -877,9 +880,25 @@ bool oEvent::save()
     }
   }
 
+  if (!res)
+    journalSnapshotId = previousSnapshotId;
+  else if (!(hasDBConnection() || hasPendingDBConnection)) {
+    // The saved file contains all changes, start a new journal
+    if (!journal)
+      journal = make_shared<EventJournal>();
+    journal->start(CurrentFile, journalSnapshotId);
+  }
+
   return res;
 }
 
+bool oEvent::autoSave() {
+  if (journal && !journal->checkpoint())
+    return true; // Changes are kept in the journal
+  
+  return save();
+}
+
 bool oEvent::save(const wstring &fileArg, bool internalFormat, bool isAutoSave) {
   if (isAutoSave && gdibase.isTest())
     return true;
@@ -900,6 +919,8 @@ bool oEvent::save(const wstring &fileArg, bool internalFormat, bool isAutoSave)
   xml.write("Annotation", Annotation);
   xml.write("Id", Id);
   xml.write("Updated", getStamp());
+  if (internalFormat && !journalSnapshotId.empty())
+    xml.write("JournalId", journalSnapshotId);
 
   oEventData->write(this, xml);
 
@@ -1205,9 +1226,26 @@ bool oEvent::open(const wstring &file, bool doImport, bool forMerge, bool forceN
     }
     currentNameId = CurrentNameId;
   }
-  bool res = open(xml, file);
-  if (res && !doImport)
+  JournalOverlay overlay;
+  string snapshotId;
+  if (!doImport) {
+    xmlobject xJournal = xml.getObject("JournalId");
+    if (xJournal) {
+      snapshotId = xJournal.getRawStr();
+      overlay.load(file, snapshotId);
+    }
+  }
+
+  bool res = open(xml, file, overlay.empty() ? nullptr : &overlay);
+  if (res && !doImport) {
     openFileLock->lockFile(file);
+    // Continue the journal of the saved state, including changes recovered from the journal
+    journalSnapshotId = snapshotId;
+    journal = make_shared<EventJournal>();
+    journal->start(file, journalSnapshotId);
+    if (journalSnapshotId.empty())
+      journal->requestSnapshot();
+  }
 
   if (forceNew) {
     newNameId.swap(currentNameId);
@@ -1255,6 +1293,8 @@ void oEvent::clearData(bool runnerTeam, bool courses) {
 
   if (runnerTeam) {
     Clubs.clear();
+    bibStartNoToRunnerTeam.clear();
+    runnerSearchIndex.reset();
     Runners.clear();
     Teams.clear();
   }
@@ -1293,7 +1333,7 @@ void oEvent::restoreBackup()
   wcscpy_s(CurrentFile, cfile.c_str());
 }
 
-bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
+bool oEvent::open(const xmlparser &xml, const wstring &fileArg, const JournalOverlay *journalOverlay) {
   xmlobject xo;
   ZeroTime = 0;
 
@@ -1334,9 +1374,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
   toc("event");
   //Get controls
   xo = xml.getObject("ControlList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Control", xl);
 
     xmlList::const_iterator it;
     set<int> knownControls;
@@ -1356,9 +1399,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
 
   //Get courses
   xo=xml.getObject("CourseList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Course", xl);
 
     xmlList::const_iterator it;
     set<int> knownCourse;
@@ -1378,9 +1424,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
 
   //Get classes
   xo=xml.getObject("ClassList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Class", xl);
 
     xmlList::const_iterator it;
     set<int> knownClass;
@@ -1402,9 +1451,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
 
   //Get clubs
   xo=xml.getObject("ClubList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Club", xl);
 
     xmlList::const_iterator it;
 
@@ -1422,9 +1474,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
 
   //Get runners
   xo=xml.getObject("RunnerList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Runner", xl);
 
     xmlList::const_iterator it;
 
@@ -1444,9 +1499,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
 
   //Get teams
   xo=xml.getObject("TeamList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Team", xl);
 
     xmlList::const_iterator it;
 
@@ -1469,9 +1527,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
   toc("team");
 
   xo=xml.getObject("PunchList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Punch", xl);
 
     xmlList::const_iterator it;
     oFreePunch::disableHashing = true;
@@ -1495,9 +1556,12 @@ bool oEvent::open(const xmlparser &xml, const wstring &fileArg) {
   toc("punch");
 
   xo=xml.getObject("CardList");
-  if (xo){
+  {
     xmlList xl;
-    xo.getObjects(xl);
+    if (xo)
+      xo.getObjects(xl);
+    if (journalOverlay)
+      journalOverlay->merge("Card", xl);
     xmlList::const_iterator it;
 
     for(it=xl.begin(); it != xl.end(); ++it){
@@ -2042,6 +2106,7 @@ pRunner oEvent::addRunner(const oRunner &r, bool updateStartNo) {
     pr->Class->tResultInfo.clear();
 
   bibStartNoToRunnerTeam.clear();
+  runnerSearchChanged();
   runnerById[pr->Id] = pr;
 
   // Notify runner database that runner has entered
@@ -2890,6 +2955,7 @@ void oEvent::removeRunner(const vector<int> &ids)
         affectedCls.insert(cr.Class);
       if (hasDBConnection())
         sqlRemove(&cr);
+      journalRemoved(cr);
       toRemove.erase(cr.getId());
       runnerById.erase(cr.getId());
       if (cr.Card) {
@@ -2932,6 +2998,7 @@ void oEvent::removeCourse(int Id)
     if (it->Id==Id){
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
       dataRevision++;
       Courses.erase(it);
       courseIdIndex.erase(Id);
@@ -2955,6 +3022,7 @@ void oEvent::removeClass(int Id)
       }
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
       Classes.erase(it);
       dataRevision++;
       updateTabs();
@@ -2974,6 +3042,7 @@ void oEvent::removeControl(int Id)
     if (it->Id==Id){
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
       Controls.erase(it);
       dataRevision++;
       return;
@@ -2989,6 +3058,7 @@ void oEvent::removeClub(int Id)
     if (it->Id==Id) {
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
       Clubs.erase(it);
       clubIdIndex.erase(Id);
       dataRevision++;
@@ -3011,6 +3081,7 @@ void oEvent::removeCard(int Id) {
       }
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
       Cards.erase(it);
       dataRevision++;
       return;
@@ -4231,6 +4302,9 @@ void oEvent::clear()
   hasPendingDBConnection = false;
   gdibase.setDBErrorState(false);
 
+  journal.reset();
+  journalSnapshotId.clear();
+
   destroyExtraWindows();
 
   tables.clear();
@@ -4240,8 +4314,14 @@ void oEvent::clear()
   getMeOSFeatures().clear(*this);
   Id=0;
   dataRevision = 0;
+  classLocalRevisions = 0;
+  globalResultRevision = 0;
+  globalResultRevisionCount = 0;
+  noClassResultRevision = 0;
   tClubDataRevision = -1;
   tCalcNumMapsDataRevision = -1;
+  tNoClassMapsRevision = -1;
+  tNoClassStatRevision = -1;
 
   ZeroTime=0;
   Name.clear();
@@ -4260,6 +4340,7 @@ void oEvent::clear()
   classIdToRunnerHash.reset();
   runnerById.clear();
   bibStartNoToRunnerTeam.clear();
+  runnerSearchIndex.reset();
   Runners.clear();
   Teams.clear();
   teamById.clear();
@@ -4343,6 +4424,23 @@ void oEvent::setTable(const string &key, const shared_ptr<Table> &table) {
   tables[key] = table;
 }
 
+void oEvent::journalChanged(oBase &ob) {
+  if (!journal || hasDBConnection() || hasPendingDBConnection)
+    return;
+
+  if (&ob == this)
+    journal->requestSnapshot(); // Competition properties are not journaled
+  else
+    journal->changed(ob);
+}
+
+void oEvent::journalRemoved(const oBase &ob) {
+  if (!journal || hasDBConnection() || hasPendingDBConnection)
+    return;
+
+  journal->removed(ob);
+}
+
 bool oEvent::deleteCompetition()
 {
   if (!empty() && !hasDBConnection()) {
@@ -4350,6 +4448,12 @@ bool oEvent::deleteCompetition()
     ::_wremove(removed.c_str()); //Delete old removed file
     openFileLock->unlockFile();
     ::_wrename(CurrentFile, removed.c_str());
+
+    journal.reset();
+    wstring journalFile = EventJournal::getJournalFile(CurrentFile);
+    wstring removedJournal = EventJournal::getJournalFile(removed);
+    ::_wremove(removedJournal.c_str());
+    ::_wrename(journalFile.c_str(), removedJournal.c_str());
     return true;
   }
   else return false;
@@ -4452,47 +4556,41 @@ void oEvent::reEvaluateAll(const set<int> &cls, bool doSync)
       tit->apply(ChangeType::Quiet, nullptr);
     }
   }
-  oRunnerList::iterator it;
 
+  vector<pRunner> runners;
   if (cls.size() < 5) {
-    vector<pRunner> runners;
     getRunners(cls, runners);
-    for (pRunner it : runners) {
-      if (!it->tInTeam || it->Class != it->tInTeam->Class || (it->Class && it->Class->isQualificationFinalBaseClass())) {
-        it->apply(ChangeType::Quiet, nullptr);
-      }
-    }
   }
   else {
-    for (it = Runners.begin(); it != Runners.end(); ++it) {
-      if (!cls.empty() && cls.count(it->getClassId(true)) == 0)
-        continue;
+    runners.reserve(Runners.size());
+    for (auto it = Runners.begin(); it != Runners.end(); ++it) {
+      if (!it->isRemoved() && cls.count(it->getClassId(true)))
+        runners.push_back(&*it);
+    }
+  }
 
-      if (!it->tInTeam || it->Class != it->tInTeam->Class || (it->Class && it->Class->isQualificationFinalBaseClass())) {
-        it->apply(ChangeType::Quiet, nullptr);
-      }
+  for (pRunner r : runners) {
+    if (!r->tInTeam || r->Class != r->tInTeam->Class || (r->Class && r->Class->isQualificationFinalBaseClass())) {
+      r->apply(ChangeType::Quiet, nullptr);
     }
   }
 
-  vector<pair<int, pControl>> mp;
-  bool needupdate = true;
-  int leg = 0;
-  while (needupdate) {
-    needupdate = false;
-    for (it=Runners.begin(); it != Runners.end(); ++it) {
-      if (!cls.empty() && cls.count(it->getClassId(true)) == 0)
-         continue;
+  // Runners by leg. Earlier legs must be evaluated first (team start times).
+  vector<vector<pRunner>> legRunners;
+  for (pRunner r : runners) {
+    if (r->tLeg < 0)
+      continue;
+    if (size_t(r->tLeg) >= legRunners.size())
+      legRunners.resize(r->tLeg + 1);
+    legRunners[r->tLeg].push_back(r);
+  }
 
-      if (!it->isRemoved()) {
-        if (it->tLeg == leg) {
-          it->evaluateCard(false, mp, 0, ChangeType::Quiet); // Must not sync!
-          it->storeTimes();
-        }
-        else if (it->tLeg>leg)
-          needupdate = true;
-      }
+  vector<pair<int, pControl>> mp;
+  for (const vector<pRunner> &lr : legRunners) {
+    for (pRunner r : lr) {
+      r->evaluateCard(false, mp, 0, ChangeType::Quiet); // Must not sync!
+      r->storeTimes();
     }
-    leg++;
   }
 
   // Mark info as complete
@@ -4511,16 +4609,11 @@ void oEvent::reEvaluateAll(const set<int> &cls, bool doSync)
       tit->apply(ChangeType::Quiet, nullptr);
     }
   }
-  for (it=Runners.begin(); it != Runners.end(); ++it) {
-    if (!it->isRemoved()) {
-      if (!cls.empty() && cls.count(it->getClassId(true)) == 0)
-        continue;
-
-      if (!it->tInTeam || it->Class != it->tInTeam->Class || (it->Class && (it->Class->isQualificationFinalBaseClass())))
-        it->apply(ChangeType::Quiet, nullptr);
-      it->storeTimes();
-      it->clearOnChangedRunningTime();
-    }
+  for (pRunner r : runners) {
+    if (!r->tInTeam || r->Class != r->tInTeam->Class || (r->Class && (r->Class->isQualificationFinalBaseClass())))
+      r->apply(ChangeType::Quiet, nullptr);
+    r->storeTimes();
+    r->clearOnChangedRunningTime();
   }
   //reCalculateLeaderTimes(0);
 }
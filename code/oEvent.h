@@ -39,6 +39,7 @@
 #include "oTeam.h"
 
 #include "intkeymap.hpp"
+#include "stablelist.hpp"
 #include "meos_util.h"
 
 #include <set>
@@ -77,6 +78,9 @@ class ImportFormats;
 class MeosSQL;
 class MachineContainer;
 class MapDataContainer;
+class EventJournal;
+class JournalOverlay;
+class RunnerSearchIndex;
 class MapData;
 
 struct oCounter {
@@ -135,13 +139,13 @@ public:
 typedef multimap<int, oTimeLine> TimeLineMap;
 typedef TimeLineMap::iterator TimeLineIterator;
 
-typedef list<oControl> oControlList;
-typedef list<oCourse> oCourseList;
-typedef list<oClass> oClassList;
-typedef list<oClub> oClubList;
-typedef list<oRunner> oRunnerList;
-typedef list<oCard> oCardList;
-typedef list<oTeam> oTeamList;
+typedef stablelist<oControl> oControlList;
+typedef stablelist<oCourse> oCourseList;
+typedef stablelist<oClass> oClassList;
+typedef stablelist<oClub> oClubList;
+typedef stablelist<oRunner> oRunnerList;
+typedef stablelist<oCard> oCardList;
+typedef stablelist<oTeam> oTeamList;
 
 typedef list<oFreePunch> oFreePunchList;
 
@@ -209,6 +213,7 @@ typedef multimap<int, PlaceRunner> TempResultMap;
 struct TimeRunner;
 class CardSystem;
 struct PrintPostInfo;
+class ListSink;
 
 enum PropertyType {
   String,
@@ -239,6 +244,14 @@ protected:
   // Revision number for data modified on this client.
   unsigned long dataRevision = 0;
 
+  // Number of revisions caused by changes that only affect the results of some classes.
+  unsigned long classLocalRevisions = 0;
+  // Data revision of the last change that may affect the results of any class.
+  mutable unsigned long globalResultRevision = 0;
+  mutable unsigned long globalResultRevisionCount = 0;
+  // Data revision of the last change where a runner left or joined a class (no class aggregates).
+  unsigned long noClassResultRevision = 0;
+
   // Set to true if a global modification is made that should case all lists etc to regenerate.
   bool globalModification = false;
   bool isMainEvent = false;
@@ -443,6 +456,27 @@ protected:
   void exportIOFClublist(xmlparser &xml);
 
   void exportIOFResults(xmlparser &xml, bool selfContained, const set<int> &classes, int leg, bool oldStylePatrol);
+
+  void exportIOFSplits(IOFVersion version, xmlparser &xml, bool oldStylePatrolExport,
+                       bool useUTC,
+                       const set<int> &classes,
+                       const tuple<string, string, bool> &preferredIdTypes,
+                       const wstring &cmpName,
+                       int leg,
+                       bool withPartialResult,
+                       bool teamsAsIndividual,
+                       bool unrollLoops,
+                       bool includeStageData,
+                       bool forceSplitFee,
+                       bool useEventorQuirks);
+
+  void exportIOFStartlist(IOFVersion version, xmlparser &xml,
+                          bool useUTC, const set<int> &classes,
+                          const tuple<string, string, bool>& preferredIdTypes,
+                          bool teamsAsIndividual,
+                          bool includeStageInfo,
+                          bool forceSplitFee,
+                          bool useEventorQuirks);
   void exportTeamSplits(xmlparser &xml, const set<int> &classes, bool oldStylePatrol);
 
   /** Set up transient data in classes */
@@ -461,8 +495,10 @@ protected:
   // Tables
   map<string, shared_ptr<Table>> tables;
 
-  // Internal list method
-  void generateListInternal(gdioutput &gdi, const oListInfo &li, bool formatHead);
+  // Internal list methods. Output to either gdi or sink.
+  wstring generateListAux(gdioutput *gdi, ListSink *sink, bool reEvaluate, const oListInfo &li);
+  void generateListInternal(gdioutput *gdi, ListSink *sink, const oListInfo &li, bool formatHead);
+  void formatHeader(PrintPostInfo &ppi, const oListInfo& li, const pRunner rInput);
 
   /** Format a string for a list. */
   const wstring &formatListStringAux(const oPrintPost &pp, const oListParam &par,
@@ -566,6 +602,16 @@ private:
   
   shared_ptr<MapDataContainer> renderMaps;
 
+  // Journal of changes since the competition was last saved
+  shared_ptr<EventJournal> journal;
+  // Identifies the saved file the journal applies to
+  string journalSnapshotId;
+
+  /** Append a changed object to the journal */
+  void journalChanged(oBase &ob);
+  /** Append a removed object to the journal */
+  void journalRemoved(const oBase &ob);
+
 public:
 
   shared_ptr<MapDataContainer>& getRenderMaps() {
@@ -813,6 +859,8 @@ public:
   // Format the header of a list
   void formatHeader(gdioutput& gdi, const oListInfo& li, const pRunner rInput);
   void generateList(gdioutput &gdi, bool reEvaluate, const oListInfo &li, bool updateScrollBars);
+  /** Generate list rows without layout, for export. Not for fixed lists. */
+  void generateList(ListSink &sink, bool reEvaluate, const oListInfo &li);
   
   void generateListInfo(const gdioutput& target, oListParam &par, oListInfo &li);
   void generateListInfo(const gdioutput& target, vector<oListParam> &par, oListInfo &li);
@@ -835,7 +883,7 @@ public:
   const wstring &formatRogainingString(const oPrintPost &pp, const oListParam &par,
                                        const RogainingLegInfo *rgLeg) const;
 
-  void calculatePrintPostKey(const list<oPrintPost> &ppli, gdioutput &gdi, const oListParam &par,
+  void calculatePrintPostKey(const list<oPrintPost> &ppli, const oListParam &par,
                              const pTeam t, const pRunner r, const pClub c,
                              const pClass pc, oCounter &counter, wstring &key);
   const wstring &formatListString(EPostType type, const pRunner r) const;
@@ -849,7 +897,7 @@ public:
                        const pControl ctrl, const oPunch *punch, 
                        const RogainingLegInfo *rgLeg, int legIndex);
 
-  void listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
+  void listGeneratePunches(const oListInfo &listInfo, gdioutput *gdi, ListSink *sink,
                            pTeam t, pRunner r, pClub club, pClass cls);
   void getListTypes(map<EStdListType, oListInfo> &listMap, int filter);
   void getListType(EStdListType type, oListInfo &li);
@@ -941,6 +989,10 @@ protected:
 
   bool enumerateBackups(const wstring &file, const wstring &filetype, int type);
   mutable multimap<int, oAbstractRunner*> bibStartNoToRunnerTeam;
+  // Index for findRunner (created on demand)
+  mutable shared_ptr<RunnerSearchIndex> runnerSearchIndex;
+  // Runner added, renamed or renumbered
+  void runnerSearchChanged() const;
 
   mutable shared_ptr<std::unordered_multimap<int, pRunner>> cardToRunnerHash;
   vector<pRunner> getCardToRunner(int cardNo) const;
@@ -955,6 +1007,12 @@ protected:
   int tClubDataRevision;
   int tCalcNumMapsDataRevision = -1;
 
+  // Aggregates for runners without class, and the global result revision
+  // when they were calculated.
+  mutable ClassAggregates tNoClassAggregates;
+  unsigned long tNoClassMapsRevision = -1;
+  mutable unsigned long tNoClassStatRevision = -1;
+
   bool readOnly = false;
   bool kiosk = false;
   mutable int tLongTimesCached;
@@ -997,9 +1055,13 @@ public:
 
   /// Return revision number for current data
   long getRevision() const {return dataRevision;}
+  /** Get the data revision of the last change that was not local to a class */
+  unsigned long getGlobalResultRevision() const;
 
   /// Calculate total missed time and other statistics for each control
   void setupControlStatistics() const;
+  // Compare the aggregated control statistics with a full calculation (debug builds)
+  void checkControlStatistics() const;
 
   // Get information on classes
   void getClassConfigurationInfo(ClassConfigInfo &cnf) const;
@@ -1082,8 +1144,33 @@ public:
                           bool forceSplitFee,
                           bool useEventorQuirks);
 
+  /** Export IOF results as XML to memory (no temporary file) */
+  void exportIOFSplits(IOFVersion version, string &output, bool oldStylePatrolExport,
+                       bool useUTC,
+                       const set<int> &classes,
+                       const tuple<string, string, bool> &preferredIdTypes,
+                       const wstring &cmpName,
+                       int leg,
+                       bool withPartialResult,
+                       bool teamsAsIndividual,
+                       bool unrollLoops,
+                       bool includeStageData,
+                       bool forceSplitFee,
+                       bool useEventorQuirks);
+
+  /** Export IOF start list as XML to memory (no temporary file) */
+  void exportIOFStartlist(IOFVersion version, string &output,
+                          bool useUTC, const set<int> &classes,
+                          const tuple<string, string, bool>& preferredIdTypes,
+                          bool teamsAsIndividual,
+                          bool includeStageInfo,
+                          bool forceSplitFee,
+                          bool useEventorQuirks);
+
   bool exportOECSV(const wchar_t *file, const set<int> &classes, int LanguageTypeIndex, bool includeSplits);
   bool save();
+  /** Save changes on automatic save. Makes a full save when needed, otherwise changes are kept in the journal. */
+  bool autoSave();
   void duplicate(const wstring &annotation, bool keepTags = false);
   
   void newCompetition(const wstring &name);
@@ -1265,7 +1352,7 @@ public:
       @param out runners using the card
    */
   void getRunnersByCardNo(int cardNo, bool updateSort, CardLookupProperty prop, vector<pRunner> &out) const;
-  /** Finds a runner by start number (linear search). If several runners has same bib/number try to get the right one:
+  /** Finds a runner by bib or start number (using a lazily built map). If several runners has same bib/number try to get the right one:
        findWithoutCardNo false : find first that has not finished
        findWithoutCardNo true : find first with no card.
   */
@@ -1412,6 +1499,8 @@ public:
                                                   bool synchronize = true);
 
   void calculateNumRemainingMaps(bool forceRecalculate);
+  // Compare the aggregated map counts with a full count (debug builds)
+  void checkNumRemainingMaps() const;
 
   pControl getControl(int Id) const;
   pControl getControlByType(int type) const;
@@ -1423,7 +1512,7 @@ public:
 
   bool open(int id);
   bool open(const wstring &file, bool doImport, bool forMerge, bool forceNew);
-  bool open(const xmlparser &xml, const wstring& fileArg);
+  bool open(const xmlparser &xml, const wstring& fileArg, const JournalOverlay *journalOverlay = nullptr);
 
   void clearData(bool runnerTeam, bool courses);
 
@@ -1605,6 +1694,7 @@ public:
   friend class oListInfo;
   friend class MeosSQL;
   friend class MySQLReconnect;
+  friend class RunnerSearchIndex;
 
   friend class TestMeOS;
 
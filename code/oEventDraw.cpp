@@ -28,6 +28,9 @@
 #include <algorithm>
 #include <chrono>
 #include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 #include "oEvent.h"
 #include "gdioutput.h"
@@ -587,19 +590,7 @@ int DrawOptimAlgo::initData(DrawInfo& di, vector<ClassInfo>& cInfo, int useNCont
     if (drawClass == di.classes.end())
       continue;
 
-    int nr = 0;
-    if (ci.startGroupId == 0)
-      nr = c_it->getNumRunners(true, true, true);
-    else {
-      vector<pRunner> cr;
-      oe->getRunners(c_it->getId(), 0, cr, false);
-      for (pRunner r : cr) {
-        if (r->getStatus() == StatusNotCompeting || r->getStatus() == StatusCANCEL)
-          continue;
-        if (r->getStartGroup(true) == ci.startGroupId)
-          nr++;
-      }
-    }
+    int nr = getNumRunnersToDraw(*c_it, ci.startGroupId);
 
     if (ci.nVacant == -1 || !(ci.nVacantSpecified || ci.nVacantLoaded) || di.changedVacancyInfo) {
       // Auto initialize
@@ -638,6 +629,33 @@ int DrawOptimAlgo::initData(DrawInfo& di, vector<ClassInfo>& cInfo, int useNCont
   return nRunnersTot;
 }
 
+int DrawOptimAlgo::getNumRunnersToDraw(const oClass& cls, int startGroupId) {
+  if (numRunnersRevision != oe->getRevision()) {
+    numRunnersToDraw.clear();
+    numRunnersRevision = oe->getRevision();
+  }
+
+  auto key = make_pair(cls.getId(), startGroupId);
+  if (auto res = numRunnersToDraw.find(key); res != numRunnersToDraw.end())
+    return res->second;
+
+  int nr = 0;
+  if (startGroupId == 0)
+    nr = cls.getNumRunners(true, true, true);
+  else {
+    vector<pRunner> cr;
+    oe->getRunners(cls.getId(), 0, cr, false);
+    for (pRunner r : cr) {
+      if (r->getStatus() == StatusNotCompeting || r->getStatus() == StatusCANCEL)
+        continue;
+      if (r->getStartGroup(true) == startGroupId)
+        nr++;
+    }
+  }
+  numRunnersToDraw[key] = nr;
+  return nr;
+}
+
 void DrawOptimAlgo::computeBestStartDepth(DrawInfo& di, vector<ClassInfo>& cInfo, int nFields, int useNControls, int alteration) {
   if (di.firstStart <= 0)
     di.firstStart = 0;
@@ -709,6 +727,21 @@ DrawOptimAlgo::DrawOptimAlgo(oEvent* oe) : oe(oe) {
   oe->getRunners(-1, -1, runners);
 }
 
+void DrawOptimAlgo::initGlobalDepth(DrawInfo& di, vector<ClassInfo>& cInfo, int nFields) {
+  initData(di, cInfo, di.maxCommonControl);
+  cacheExisting();
+  bestEndPosGlobal = 100000;
+  for (int i = 1; i <= di.maxCommonControl && i <= 10; i++) {
+    int ncc = i;
+    if (i >= 10)
+      ncc = 0;
+    computeBestStartDepth(di, cInfo, nFields, ncc, 0);
+    bestEndPosGlobal = min(bestEndPos, bestEndPosGlobal);
+  }
+
+  di.minimalStartDepth = bestEndPosGlobal * di.baseInterval;
+}
+
 void DrawOptimAlgo::optimizeStartOrder(DrawInfo& di,
   vector<ClassInfo>& cInfo,
   int nFields,
@@ -720,22 +753,14 @@ void DrawOptimAlgo::optimizeStartOrder(DrawInfo& di,
   std::default_random_engine rnd(seed);
   std::uniform_int_distribution<std::mt19937::result_type> dist1000(0, 1000);
 
-  if (bestEndPosGlobal == 0) {
-    bestEndPosGlobal = 100000;
-    for (int i = 1; i <= di.maxCommonControl && i <= 10; i++) {
-      int ncc = i;
-      if (i >= 10)
-        ncc = 0;
-      computeBestStartDepth(di, cInfo, nFields, ncc, 0);
-      bestEndPosGlobal = min(bestEndPos, bestEndPosGlobal);
-    }
-
-    di.minimalStartDepth = bestEndPosGlobal * di.baseInterval;
-  }
+  if (bestEndPosGlobal == 0)
+    initGlobalDepth(di, cInfo, nFields);
 
   computeBestStartDepth(di, cInfo, nFields, useNControls, seed);
 
-  ClassInfo::sSortOrder = 0;
+  // Only written when needed; this function may run concurrently on copies of the algorithm
+  if (ClassInfo::sSortOrder != 0)
+    ClassInfo::sSortOrder = 0;
   sort(cInfo.begin(), cInfo.end());
 
   int maxSize = di.minClassInterval * maxNRunner;
@@ -1099,23 +1124,43 @@ void DrawOptimAlgo::optimizeStartOrder(DrawInfo& di,
   }
 }
 
-void DrawOptimAlgo::insertExisting(const DrawInfo& di, int startGroup) {
-  // Fill up with non-drawn classes
+void DrawOptimAlgo::cacheExisting() {
+  if (existingRevision == oe->getRevision())
+    return;
+
+  existingRevision = oe->getRevision();
+  existingStarts.clear();
+  existingStarts.reserve(runners.size());
   for (auto& it : runners) {
     if (it->isRemoved())
       continue;
-    int st = it->getStartTime();
+    ExistingStart es;
+    es.startTime = it->getStartTime();
+    es.classId = it->getClassId(true);
+    es.startGroup = it->getStartGroup(true);
+    es.courseId = it->getCourse(false) ? it->getCourse(false)->getId() : 0;
+    es.cls = it->getClassRef(true);
+    existingStarts.push_back(es);
+  }
+}
+
+void DrawOptimAlgo::insertExisting(const DrawInfo& di, int startGroup) {
+  cacheExisting();
+
+  // Fill up with non-drawn classes
+  for (auto& it : existingStarts) {
+    int st = it.startTime;
     int relSt = st - di.firstStart;
     int relPos = relSt / di.baseInterval;
     constexpr int maxRelPosition = 60 * 24 * 2;
 
     if (st > 0 && relSt >= 0 && relPos < maxRelPosition && (relSt % di.baseInterval) == 0) {
-      int cid = it->getClassId(true);
+      int cid = it.classId;
       if (otherClasses.count(cid) == 0) {
-        if (startGroup == 0 || startGroup == it->getStartGroup(true))
+        if (startGroup == 0 || startGroup == it.startGroup)
           continue;
       }
-      pClass cls = it->getClassRef(true);
+      pClass cls = it.cls;
       if (cls) {
         if (!di.startName.empty() && cls->getStart() != di.startName)
           continue;
@@ -1137,7 +1182,7 @@ void DrawOptimAlgo::insertExisting(const DrawInfo& di, int startGroup) {
         }
         else {
           unique = 12345678;
-          courseId = it->getCourse(false) ? it->getCourse(false)->getId() : 0;
+          courseId = it.courseId;
         }
       }
 
@@ -1407,75 +1452,121 @@ void oEvent::optimizeStartOrder(vector<pair<int, wstring>>& outLines, DrawInfo&
   bool checkOnlyClass = di.maxCommonControl == 1000;
 
   DrawOptimAlgo drawOptim(this);
+  drawOptim.initGlobalDepth(di, cInfo, di.nFieldsMax);
+  ClassInfo::sSortOrder = 0;
 
-  while (!found) {
-
-    StartParam optInner;
-    for (int alt = 0; alt <= 20 && !found; alt++) {
-      int nFieldsOpt = di.nFieldsMax;
-      int nFields = di.nFieldsMax;
-      int currentLastStart = 100000;
-
-      vector<int> startPerInterval;
-      int overShoot = 0;
-
-      while (nFields > 0) {
-        drawOptim.optimizeStartOrder(di, cInfo, nFields, nCtrl, alt);
-        int last = drawOptim.getLastStart();
-        if (last <= currentLastStart) {
-          startPerInterval = drawOptim.getNumStartPerInterval();
-
-          overShoot = 0;
-          for (size_t k = 0; k < cInfo.size(); k++) {
-            const ClassInfo& ci = cInfo[k];
-            if (ci.overShoot > 0) {
-              overShoot = max(overShoot, ci.overShoot);
-            }
+  // Try one alteration (seed) of the layout. Works on its own copy of the algorithm state,
+  // so that alterations can be evaluated concurrently with a result independent of order.
+  auto evaluate = [](DrawOptimAlgo& algo, DrawInfo di, vector<ClassInfo> cInfo, int nCtrl, int alt) {
+    StartParam param;
+    int nFieldsOpt = di.nFieldsMax;
+    int nFields = di.nFieldsMax;
+    int currentLastStart = 100000;
+
+    vector<int> startPerInterval;
+    int overShoot = 0;
+
+    while (nFields > 0) {
+      algo.optimizeStartOrder(di, cInfo, nFields, nCtrl, alt);
+      int last = algo.getLastStart();
+      if (last <= currentLastStart) {
+        startPerInterval = algo.getNumStartPerInterval();
+
+        overShoot = 0;
+        for (size_t k = 0; k < cInfo.size(); k++) {
+          const ClassInfo& ci = cInfo[k];
+          if (ci.overShoot > 0) {
+            overShoot = max(overShoot, ci.overShoot);
           }
-
-          currentLastStart = last;
-          nFieldsOpt = nFields;
-          nFields--;
         }
-        else {
-          break;
-        }
-      }
 
-      constexpr int numSample = 4;
-      int sumStarts[numSample];
-      for (int j = 0; j < 4; j++) {
-        int s = (j * startPerInterval.size()) / 4;
-        int e = ((j + 1) * startPerInterval.size()) / 4;
-        sumStarts[j] = 0;
-        for (int i = s; i < e; i++)
-          sumStarts[j] += startPerInterval[i];
+        currentLastStart = last;
+        nFieldsOpt = nFields;
+        nFields--;
       }
+      else {
+        break;
+      }
+    }
 
-      auto minmax = std::minmax_element(sumStarts, sumStarts + numSample);
-      double div = 1.0 + double(*minmax.first) / double(*minmax.second);
+    constexpr int numSample = 4;
+    int sumStarts[numSample];
+    for (int j = 0; j < 4; j++) {
+      int s = (j * startPerInterval.size()) / 4;
+      int e = ((j + 1) * startPerInterval.size()) / 4;
+      sumStarts[j] = 0;
+      for (int i = s; i < e; i++)
+        sumStarts[j] += startPerInterval[i];
+    }
+
+    auto minmax = std::minmax_element(sumStarts, sumStarts + numSample);
+    double div = 1.0 + double(*minmax.first) / double(*minmax.second);
+
+    //double avgShoot = double(overSum) / cInfo.size();
+    param.badness = overShoot == 0 ? 1 / div : (overShoot + 1) / div;
+    param.alternator = alt;
+    param.nControls = nCtrl;
+
+    //Find last starter
+    param.last = currentLastStart;
+    param.nFields = nFieldsOpt;
+    return param;
+  };
 
-      //double avgShoot = double(overSum) / cInfo.size();
-      double badness = overShoot == 0 ? 1 / div : (overShoot + 1) / div;
+  constexpr int numAlternations = 21;
+  const int numThreads = max(1, min<int>(thread::hardware_concurrency(), numAlternations));
+  // Stop trying more common controls when a complete round gives no improvement.
+  // Depends only on the result (not on time), so that the draw is deterministic.
 
-      if (badness < optInner.badness) {
-        optInner.badness = badness;
-        optInner.alternator = alt;
-        optInner.nControls = nCtrl;
+  while (!found) {
+    vector<StartParam> altResult(numAlternations);
+    atomic<int> nextAlt(0);
+    exception_ptr workerError;
+    mutex errorLock;
 
-        //Find last starter
-        optInner.last = currentLastStart;
-        optInner.nFields = nFieldsOpt;
+    auto worker = [&]() {
+      try {
+        DrawOptimAlgo localOptim(drawOptim);
+        int alt;
+        while ((alt = nextAlt++) < numAlternations)
+          altResult[alt] = evaluate(localOptim, di, cInfo, nCtrl, alt);
+      }
+      catch (...) {
+        lock_guard<mutex> lock(errorLock);
+        if (!workerError)
+          workerError = current_exception();
+        nextAlt = numAlternations;
       }
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++)
+      workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+      w.join();
+
+    if (workerError)
+      rethrow_exception(workerError);
+
+    // Pick the best in alteration order, so that ties are resolved as for a sequential search
+    StartParam optInner;
+    for (auto& param : altResult) {
+      if (param.badness < optInner.badness)
+        optInner = param;
     }
 
-    if (optInner.last < opt.last)
+    bool improved = optInner.last < opt.last;
+    if (improved)
       opt = optInner;
 
     if (opt.badness < 2.0 && !checkOnlyClass) {
       found = true;
     }
 
+    if (!found && !improved && !di.exhaustiveSearch && opt.last < StartParam().last)
+      found = true;
+
     if (!found) {
       nCtrl++;
     }
@@ -1837,7 +1928,7 @@ namespace {
     }
   }
 
-  void printGroups(gdioutput& gdibase, const list<oRunner>& Runners) {
+  void printGroups(gdioutput& gdibase, const oRunnerList& Runners) {
     map<int, vector<const oRunner*>> rbg;
     for (const oRunner& r : Runners) {
       rbg[r.getStartGroup(true)].push_back(&r);
@@ -125,6 +125,8 @@ struct DrawInfo {
   int maxCommonControl = 3;
   bool allowNeighbourSameCourse = true;
   bool coursesTogether = false;
+  // Try all numbers of common controls, also after a round without improvement
+  bool exhaustiveSearch = false;
   // Statistics output from optimize start order
   int numDistinctInit = -1;
   int numRunnerSameInitMax = -1;
@@ -207,6 +209,24 @@ private:
 
   int bestEndPosGlobal = 0;
 
+  /** Number of runners to draw per (class, start group). Cached so that copies of the
+      algorithm can be evaluated on worker threads without touching the competition. */
+  map<pair<int, int>, int> numRunnersToDraw;
+  long numRunnersRevision = -1;
+  int getNumRunnersToDraw(const oClass& cls, int startGroupId);
+
+  /** Start times already assigned, copied from the runners for the same reason */
+  struct ExistingStart {
+    int startTime;
+    int classId;
+    int startGroup;
+    int courseId;
+    pClass cls;
+  };
+  vector<ExistingStart> existingStarts;
+  long existingRevision = -1;
+  void cacheExisting();
+
   static int optimalLayout(int interval, vector<pair<int, int>>& classes);
   bool isFree(const DrawInfo& di, int nFields, int firstPos, int posInterval, ClassInfo& cInfo) const;
   void insertStart(const ClassInfo& cInfo);
@@ -219,6 +239,11 @@ public:
 
   DrawOptimAlgo(oEvent* oe);
 
+  /** Compute the theoretical minimal start depth and cache competition data.
+      Called implicitly by optimizeStartOrder, but must be called before copies
+      of the algorithm are used concurrently. */
+  void initGlobalDepth(DrawInfo& di, vector<ClassInfo>& cInfo, int nFields);
+
   void optimizeStartOrder(DrawInfo& di,
     vector<ClassInfo>& cInfo,
     int nFields,
@@ -195,9 +195,20 @@ void oEvent::calculateResults(const set<int> &classes, ResultType resultType, bo
   map<int, int> classToResultModule;
   set<int> rgClasses;
     
+  int resKey = resultKey(1, 2, resultType, includePreliminary);
+  const unsigned long calcRevision = dataRevision;
+
+  bool resOK = lastResultCalcPrelState == includePreliminary && !lastResultCalcSplitResult;
+  lastResultCalcPrelState = includePreliminary;
+  lastResultCalcSplitResult = false;
+
+  // Classes where no runner or team has changed since the last calculation
+  set<int> currentClasses;
   map<string, int> resultModuleToIndex;
   for (auto &cls : Classes) {
     if (!cls.isRemoved() && (all || classes.count(cls.getId()))) {
+      if (resOK && !cls.isResultOld(resKey))
+        currentClasses.insert(cls.getId());
 
       if (cls.isRogaining() && cls.getResultModuleTag().empty()) 
         rgClasses.insert(cls.getId());
@@ -223,8 +234,6 @@ void oEvent::calculateResults(const set<int> &classes, ResultType resultType, bo
     }
   }
   
-  int resKey = resultKey(1, 2, resultType, includePreliminary);
-
   vector<const oRunner *> runners;
   {
     vector<pRunner> runnersCls;
@@ -233,35 +242,57 @@ void oEvent::calculateResults(const set<int> &classes, ResultType resultType, bo
     else
       getRunners(classes, runnersCls);
 
-    runners.reserve(runnersCls.size());
-    
-    
-    bool resOK = lastResultCalcPrelState == includePreliminary && !lastResultCalcSplitResult;
-    lastResultCalcPrelState = includePreliminary;
-    lastResultCalcSplitResult = false;
+    // A class is only current if all its runners have a result of the requested type
+    for (auto it : runnersCls) {
+      const oRunner &r = *it;
+      int cid = r.getClassId(true);
+      if (currentClasses.count(cid)) {
+        bool current = r.tPlace.hasKey(resKey);
+        if (courseResults)
+          current = current && r.tCoursePlace.hasKey(resKey);
+        else if (classCourseResults)
+          current = current && r.tCourseClassPlace.hasKey(resKey);
+        else if (totalResults)
+          current = current && r.tTotalPlace.hasKey(resKey);
+
+        if (!current)
+          currentClasses.erase(cid);
+      }
+    }
 
+    // Course results are grouped over classes
+    if (courseResults) {
+      for (auto it : runnersCls) {
+        if (!currentClasses.count(it->getClassId(true))) {
+          currentClasses.clear();
+          break;
+        }
+      }
+    }
+
+    runners.reserve(runnersCls.size());
     for (auto it : runnersCls) {
       oRunner &r = *it;
       int cid = r.getClassId(true);
+      if (currentClasses.count(cid)) {
+        r.tPlace.validate(*this);
+        if (courseResults)
+          r.tCoursePlace.validate(*this);
+        else if (classCourseResults)
+          r.tCourseClassPlace.validate(*this);
+        else if (totalResults)
+          r.tTotalPlace.validate(*this);
+        continue;
+      }
+
       auto c = classToResultModule.find(cid);
       if (c != classToResultModule.end() && c->second != -1) {
         runnersByResultModule[c->second].second.push_back(&r);
       }
       runners.push_back(&r);
-      
-      if (resOK) {
-        if (courseResults && r.tCoursePlace.isOld(*this, resKey))
-          resOK = false;
-        else if (classCourseResults && r.tCourseClassPlace.isOld(*this, resKey))
-          resOK = false;
-        else if (totalResults && r.tTotalPlace.isOld(*this, resKey))
-          resOK = false;
-        else if (r.tPlace.isOld(*this, resKey))
-          resOK = false;
-      }
     }
 
-    if (resOK)
+    if (runners.empty() && currentClasses.size() == classToResultModule.size())
       return;
   }
   // Reset computed status/time
@@ -276,7 +307,7 @@ void oEvent::calculateResults(const set<int> &classes, ResultType resultType, bo
   else {
     // Reset leader times
     for (auto &cls : Classes) {
-      if (!cls.isRemoved() && (all || classes.count(cls.getId()))) {
+      if (!cls.isRemoved() && (all || classes.count(cls.getId())) && !currentClasses.count(cls.getId())) {
         for (unsigned leg = 0; leg < cls.getNumStages(); leg++)
           cls.getLeaderInfo(oClass::AllowRecompute::No,leg).resetComputed(oClass::LeaderInfo::Type::Leg);
       }
@@ -319,6 +350,20 @@ void oEvent::calculateResults(const set<int> &classes, ResultType resultType, bo
     }
     resultCalculationLock = false;
   }
+
+  for (auto &cls : Classes) {
+    if (!cls.isRemoved() && (all || classes.count(cls.getId())))
+      cls.setResultCalculated(resKey, calcRevision);
+  }
+}
+
+unsigned long oEvent::getGlobalResultRevision() const {
+  unsigned long globalCount = dataRevision - classLocalRevisions;
+  if (globalCount != globalResultRevisionCount) {
+    globalResultRevisionCount = globalCount;
+    globalResultRevision = dataRevision;
+  }
+  return globalResultRevision;
 }
 
 void oEvent::calculateRunnerResults(ResultType resultType,
@@ -234,7 +234,7 @@ void oEvent::resetSQLChanged(bool resetAllTeamsRunners, bool cleanClasses) {
   }
   if (cleanClasses) {
     // This data is used to redraw lists/speaker etc.
-    for (list<oClass>::iterator it=oe->Classes.begin();
+    for (oClassList::iterator it=oe->Classes.begin();
       it!=oe->Classes.end(); ++it) {
       it->sqlChangedControlLeg.clear();
       it->sqlChangedLegControl.clear();
@@ -698,37 +698,37 @@ bool oEvent::reConnect(string &err)
     isConnectedToServer = true;
     hasPendingDBConnection = false;
     //synchronize changed objects
-    for (list<oCard>::iterator it=oe->Cards.begin();
+    for (oCardList::iterator it=oe->Cards.begin();
           it!=oe->Cards.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oClub>::iterator it=oe->Clubs.begin();
+    for (oClubList::iterator it=oe->Clubs.begin();
           it!=oe->Clubs.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oControl>::iterator it=oe->Controls.begin();
+    for (oControlList::iterator it=oe->Controls.begin();
           it!=oe->Controls.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oCourse>::iterator it=oe->Courses.begin();
+    for (oCourseList::iterator it=oe->Courses.begin();
           it!=oe->Courses.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oClass>::iterator it=oe->Classes.begin();
+    for (oClassList::iterator it=oe->Classes.begin();
         it!=oe->Classes.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oRunner>::iterator it=oe->Runners.begin();
+    for (oRunnerList::iterator it=oe->Runners.begin();
         it!=oe->Runners.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
 
-    for (list<oTeam>::iterator it=oe->Teams.begin();
+    for (oTeamList::iterator it=oe->Teams.begin();
         it!=oe->Teams.end(); ++it)
       if (it->isChanged())
         it->synchronize(false);
@@ -754,7 +754,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
   wchar_t bf[256];
   out.clear();
 
-  for (list<oCard>::iterator it=oe->Cards.begin();
+  for (oCardList::iterator it=oe->Cards.begin();
     it!=oe->Cards.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -763,7 +763,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       it->synchronize();
     }
 
-  for (list<oClub>::iterator it=oe->Clubs.begin();
+  for (oClubList::iterator it=oe->Clubs.begin();
     it!=oe->Clubs.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -772,7 +772,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       it->synchronize();
     }
 
-  for (list<oControl>::iterator it=oe->Controls.begin();
+  for (oControlList::iterator it=oe->Controls.begin();
     it!=oe->Controls.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -781,7 +781,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       it->synchronize();
     }
 
-  for (list<oCourse>::iterator it=oe->Courses.begin();
+  for (oCourseList::iterator it=oe->Courses.begin();
         it!=oe->Courses.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -790,7 +790,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       it->synchronize();
     }
 
-  for (list<oClass>::iterator it=oe->Classes.begin();
+  for (oClassList::iterator it=oe->Classes.begin();
       it!=oe->Classes.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -799,7 +799,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       it->synchronize();
     }
 
-  for (list<oRunner>::iterator it=oe->Runners.begin();
+  for (oRunnerList::iterator it=oe->Runners.begin();
       it!=oe->Runners.end(); ++it)
     if (it->isChanged()) {
       changed++;
@@ -807,7 +807,7 @@ int oEvent::checkChanged(vector<wstring> &out) const
       out.push_back(bf);
       it->synchronize();
     }
-  for (list<oTeam>::iterator it=oe->Teams.begin();
+  for (oTeamList::iterator it=oe->Teams.begin();
       it!=oe->Teams.end(); ++it)
     if (it->isChanged()) {
       changed++;
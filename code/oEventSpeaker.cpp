@@ -2378,10 +2378,11 @@ struct TeamLegControl {
 
 void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchFilter, vector<ResultEvent> &results) const {
   results.clear();
+  results.reserve(Runners.size());
 
   vector<RunnerStatus> teamLegStatusOK;
   teamLegStatusOK.reserve(Teams.size() * 5);
-  map<int, int> teamStatusPos;
+  unordered_map<int, int> teamStatusPos;
   for (oTeamList::const_iterator it = Teams.begin(); it != Teams.end(); ++it) {
     if (!classFilter.count(it->getClassId(false)))
       continue;
@@ -2404,6 +2405,7 @@ void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchF
     }
   }
 
+  vector<pair<int, int>> dupCount; // Control id, number of punches
   for (oRunnerList::const_iterator it = Runners.begin(); it != Runners.end(); ++it) {
     const oRunner &r = *it;
     if (r.isRemoved() || !classFilter.count(r.getClassId(true)))
@@ -2422,7 +2424,7 @@ void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchF
     
     RunnerStatus punchStatus = StatusOK;
     if (r.tInTeam && r.tLeg > 0) {
-      map<int, int>::iterator res = teamStatusPos.find(r.tInTeam->getId());
+      auto res = teamStatusPos.find(r.tInTeam->getId());
       if (res != teamStatusPos.end()) {
         RunnerStatus prevStat = teamLegStatusOK[res->second + r.tLeg - 1];
         if (prevStat != StatusOK && prevStat != StatusUnknown) {
@@ -2435,10 +2437,20 @@ void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchF
 
     if (card) {
       oPunchList::const_iterator it;
-      map<int,int> dupCount;
+      dupCount.clear();
       for (it = card->punches.begin(); it != card->punches.end(); ++it) {
         if  (punchFilter.count(it->tMatchControlId)) {
-          int dupC = ++dupCount[it->tMatchControlId];
+          int dupC = 0;
+          for (auto &dc : dupCount) {
+            if (dc.first == it->tMatchControlId) {
+              dupC = ++dc.second;
+              break;
+            }
+          }
+          if (dupC == 0) {
+            dupCount.emplace_back(it->tMatchControlId, 1);
+            dupC = 1;
+          }
           int courseControlId = oControl::getCourseControlIdFromIdIndex(it->tMatchControlId, dupC-1);
           results.push_back(ResultEvent(pRunner(&r), it->getAdjustedTime(), courseControlId, punchStatus));
         }
@@ -2464,7 +2476,7 @@ void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchF
     results.push_back(ResultEvent(r, fp.getTimeInt(), courseControlId, StatusOK));
 
     if (r->tInTeam && r->tLeg > 0) {
-      map<int, int>::iterator res = teamStatusPos.find(r->tInTeam->getId());
+      auto res = teamStatusPos.find(r->tInTeam->getId());
       if (res != teamStatusPos.end()) {
         RunnerStatus prevStat = teamLegStatusOK[res->second + r->tLeg - 1];
         if (prevStat != StatusOK && prevStat != StatusUnknown) {
@@ -2490,7 +2502,7 @@ void oEvent::getResultEvents(const set<int> &classFilter, const set<int> &punchF
     results.push_back(ResultEvent(r, fp.getTimeInt(), courseControlId, StatusOK));
 
     if (r->tInTeam && r->tLeg > 0) {
-      map<int, int>::iterator res = teamStatusPos.find(r->tInTeam->getId());
+      auto res = teamStatusPos.find(r->tInTeam->getId());
       if (res != teamStatusPos.end()) {
         RunnerStatus prevStat = teamLegStatusOK[res->second + r->tLeg - 1];
         if (prevStat != StatusOK && prevStat != StatusUnknown) {
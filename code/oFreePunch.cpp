@@ -559,6 +559,7 @@ void oEvent::removeFreePunch(int Id) {
       pFreePunch fp = &*it;
       if (hasDBConnection())
         sqlRemove(fp);
+      journalRemoved(*fp);
       //punchIndex[it->itype].remove(it->CardNo);
       PunchIndexType &ix = punchIndex[it->iHashType];
       pair<PunchConstIterator, PunchConstIterator> res = ix.equal_range(it->CardNo);
@@ -753,6 +754,17 @@ void oFreePunch::changedObject() {
   oe->sqlPunches.changed = true;
 }
 
+bool oFreePunch::markResultChanged() {
+  // A punch moved from another runner also changes the results of that runner
+  bool moved = tResultRunnerId != 0 && tResultRunnerId != tRunnerId;
+  tResultRunnerId = tRunnerId;
+  pRunner r = getTiedRunner();
+  if (moved || !r)
+    return false;
+
+  return r->markResultChanged();
+}
+
 bool oEvent::hasHiredCardData() {
   synchronizeList(oListId::oLPunchId);
   isHiredCard(0); 
@@ -787,6 +799,7 @@ void oEvent::setHiredCard(int cardNo, bool flag) {
         if (!it->isRemoved() && it->isHiredCard() && it->CardNo == cardNo) {
           if (hasDBConnection())
             sqlRemove(&*it);
+          journalRemoved(*it);
 
           auto toErase = it;
           ++it;
@@ -813,6 +826,7 @@ void oEvent::clearHiredCards() {
     if (!it->isRemoved() && it->isHiredCard()) {
       if (hasDBConnection())
         sqlRemove(&*it);
+      journalRemoved(*it);
 
       auto toErase = it;
       ++it;
@@ -38,6 +38,7 @@ protected:
   int CardNo;
   int iHashType; //Index type used for lookup
   int tRunnerId; // Id of runner the punch is classified to.
+  int tResultRunnerId = 0; // Id of runner whose results were last marked as changed
 
   /** Class used to sort punches by time. */
   class FreePunchComp {
@@ -48,6 +49,7 @@ protected:
   };
 
   void changedObject();
+  bool markResultChanged() final;
 
 public:
 
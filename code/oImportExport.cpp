@@ -313,7 +313,11 @@ void oEvent::importXML_EntryData(gdioutput &gdi, const wstring &file,
   }
 
   xmlparser xml;
-  xml.read(file);
+  // IOF 3.0 entry and result lists are streamed, other files are read completely
+  xml.openStream(file);
+  xmlobject root = xml.getObject(nullptr);
+  if (!root || !(root.is("EntryList") || root.is("ResultList")) || !root.getAttrib("iofVersion"))
+    xml.read(file);
 
   xmlobject xo = xml.getObject("EntryList");
   set<wstring> matchedClasses;
@@ -2681,8 +2685,40 @@ void oEvent::exportIOFSplits(IOFVersion version, const wchar_t *file,
                              bool includeStageInfo, bool forceSplitFee,
                              bool useEventorQuirks) {
   xmlparser xml;
-
   xml.openOutput(file, false);
+  exportIOFSplits(version, xml, oldStylePatrolExport, useUTC, classes, preferredIdTypes,
+                  cmpName, leg, withPartialResult, teamsAsIndividual, unrollLoops,
+                  includeStageInfo, forceSplitFee, useEventorQuirks);
+  xml.closeOut();
+}
+
+void oEvent::exportIOFSplits(IOFVersion version, string &output,
+                             bool oldStylePatrolExport, bool useUTC,
+                             const set<int> &classes,
+                             const tuple<string, string, bool>& preferredIdTypes, 
+                             const wstring &cmpName, int leg,
+                             bool withPartialResult,
+                             bool teamsAsIndividual, bool unrollLoops,
+                             bool includeStageInfo, bool forceSplitFee,
+                             bool useEventorQuirks) {
+  xmlparser xml;
+  xml.openMemoryOutput(false);
+  exportIOFSplits(version, xml, oldStylePatrolExport, useUTC, classes, preferredIdTypes,
+                  cmpName, leg, withPartialResult, teamsAsIndividual, unrollLoops,
+                  includeStageInfo, forceSplitFee, useEventorQuirks);
+  xml.closeOut();
+  xml.getMemoryOutput(output);
+}
+
+void oEvent::exportIOFSplits(IOFVersion version, xmlparser &xml,
+                             bool oldStylePatrolExport, bool useUTC,
+                             const set<int> &classes,
+                             const tuple<string, string, bool>& preferredIdTypes, 
+                             const wstring &cmpName, int leg,
+                             bool withPartialResult,
+                             bool teamsAsIndividual, bool unrollLoops,
+                             bool includeStageInfo, bool forceSplitFee,
+                             bool useEventorQuirks) {
   oClass::initClassId(*this, classes);
   reEvaluateAll(classes, true);
   if (version != IOF20)
@@ -2714,8 +2750,6 @@ void oEvent::exportIOFSplits(IOFVersion version, const wchar_t *file,
     Name = std::move(nameOrig);
     throw;
   }
-
-  xml.closeOut();
 }
 
 void oEvent::exportIOFStartlist(IOFVersion version, const wchar_t *file, bool useUTC,
@@ -2729,7 +2763,35 @@ void oEvent::exportIOFStartlist(IOFVersion version, const wchar_t *file, bool us
   
   oClass::initClassId(*this, classes);
   xml.openOutput(file, false);
+  exportIOFStartlist(version, xml, useUTC, classes, preferredIdTypes,
+                     teamsAsIndividual, includeStageInfo, forceSplitFee, useEventorQuirks);
+  xml.closeOut();
+}
 
+void oEvent::exportIOFStartlist(IOFVersion version, string &output, bool useUTC,
+                                const set<int> &classes, 
+                                const tuple<string, string, bool>& preferredIdTypes,
+                                bool teamsAsIndividual,
+                                bool includeStageInfo, 
+                                bool forceSplitFee,
+                                bool useEventorQuirks) {
+  xmlparser xml;
+  
+  oClass::initClassId(*this, classes);
+  xml.openMemoryOutput(false);
+  exportIOFStartlist(version, xml, useUTC, classes, preferredIdTypes,
+                     teamsAsIndividual, includeStageInfo, forceSplitFee, useEventorQuirks);
+  xml.closeOut();
+  xml.getMemoryOutput(output);
+}
+
+void oEvent::exportIOFStartlist(IOFVersion version, xmlparser &xml, bool useUTC,
+                                const set<int> &classes, 
+                                const tuple<string, string, bool>& preferredIdTypes,
+                                bool teamsAsIndividual,
+                                bool includeStageInfo, 
+                                bool forceSplitFee,
+                                bool useEventorQuirks) {
   if (version == IOF20)
     exportIOFStartlist(xml);
   else {
@@ -2737,5 +2799,4 @@ void oEvent::exportIOFStartlist(IOFVersion version, const wchar_t *file, bool us
     writer.setPreferredIdType(make_pair(get<0>(preferredIdTypes), get<1>(preferredIdTypes)), get<2>(preferredIdTypes));
     writer.writeStartList(xml, classes, useUTC, teamsAsIndividual, includeStageInfo);
   }
-  xml.closeOut();
 }
@@ -36,16 +36,51 @@
 #include "gdiimpl.h"
 #include "image.h"
 #include "xmlparser.h"
+#include "listsink.h"
 
 struct PrintPostInfo {
-  PrintPostInfo(gdioutput &gdi, const oListParam &par) : 
-              gdi(gdi), par(par), keepToghether(false) {}
+  PrintPostInfo(gdioutput *gdi, ListSink *sink, const oListInfo &li) : 
+              gdi(gdi), sink(sink), li(li), par(li.lp), keepToghether(false) {}
 
-  gdioutput &gdi;
+  // Exactly one of gdi and sink is set
+  gdioutput *gdi;
+  ListSink *sink;
+  const oListInfo &li;
   const oListParam &par;
   oCounter counter;
   bool keepToghether;
+  vector<ListCell> cells;
   void reset() {keepToghether = false;}
+
+  ListSink::RowType getRowType(const list<oPrintPost> &ppli) const {
+    if (&ppli == &li.head)
+      return ListSink::RowType::Head;
+    else if (&ppli == &li.subHead)
+      return ListSink::RowType::SubHead;
+    else if (&ppli == &li.subListPost)
+      return ListSink::RowType::SubPost;
+    return ListSink::RowType::Post;
+  }
+
+  /** Start a new page (subhead). Page info is the page title */
+  void newPage(bool first, const wstring &pageInfo) {
+    if (gdi) {
+      if (!first)
+        gdi->addStringUT(gdi->getCY() - 1, 0, pageNewPage, "");
+      gdi->addStringUT(pagePageInfo, pageInfo);
+    }
+    else
+      sink->beginSection(pageInfo);
+  }
+
+  void newPage(bool first) {
+    if (gdi) {
+      if (!first)
+        gdi->addStringUT(gdi->getCY() - 1, 0, pageNewPage, "");
+    }
+    else
+      sink->beginSection(_EmptyWString);
+  }
 private:
   PrintPostInfo &operator=(const PrintPostInfo &a) {}
 };
@@ -2940,30 +2975,40 @@ bool oEvent::formatPrintPost(const list<oPrintPost> &ppli, PrintPostInfo &ppi,
                              const pTeam t, const pRunner r, const pClub c,
                              const pClass pc, const pCourse crs, const pControl ctrl,
                              const oPunch *punch, const RogainingLegInfo *rgLeg, int legIndex) {
-  int y = ppi.gdi.getCY();
-  int x = ppi.gdi.getCX();
+  gdioutput *gdi = ppi.gdi;
+  int y = gdi ? gdi->getCY() : 0;
+  int x = gdi ? gdi->getCX() : 0;
   bool updated = false;
   int lineHeight = 0;
+  int line = 0;
   int pdx = 0, pdy = 0;
+  if (!gdi)
+    ppi.cells.clear();
+
   auto ppit = ppli.begin();
   while (ppit != ppli.end()) {
     const oPrintPost &pp = *ppit;
 
     if (pp.type == lLineBreak) {
-      x -= ppi.gdi.scaleLength(pp.dx) - pdx;
-      pdx = ppi.gdi.scaleLength(pp.dx);
-      y += lineHeight;
+      if (gdi) {
+        x -= gdi->scaleLength(pp.dx) - pdx;
+        pdx = gdi->scaleLength(pp.dx);
+        y += lineHeight;
+      }
+      line++;
       ++ppit;
       continue;
     }
     else if (pp.type == lImage) {
-      pdy = ppi.gdi.scaleLength(pp.dy);
-      pdx = ppi.gdi.scaleLength(pp.dx);
-      int format = 0;
-      if (pp.imageNoUpdatePos)
-        format |= imageNoUpdatePos;
-      ppi.gdi.addImage("", y + pdy, x + pdx, format, pp.text,
-              ppi.gdi.scaleLength(pp.fixedWidth), ppi.gdi.scaleLength(pp.fixedHeight));
+      if (gdi) {
+        pdy = gdi->scaleLength(pp.dy);
+        pdx = gdi->scaleLength(pp.dx);
+        int format = 0;
+        if (pp.imageNoUpdatePos)
+          format |= imageNoUpdatePos;
+        gdi->addImage("", y + pdy, x + pdx, format, pp.text,
+                      gdi->scaleLength(pp.fixedWidth), gdi->scaleLength(pp.fixedHeight));
+      }
       ++ppit;
       continue;
     }
@@ -3017,41 +3062,63 @@ bool oEvent::formatPrintPost(const list<oPrintPost> &ppli, PrintPostInfo &ppi,
 
     TextInfo *ti = 0;
     if (!text->empty()) {
-      int tightBBFlag = ppi.par.tightBoundingBox ? 0 : skipBoundingBox;
-      pdy = ppi.gdi.scaleLength(pp.dy);
-      pdx = ppi.gdi.scaleLength(pp.dx);
+      char idType = 0;
+      int id = 0;
       if ((pp.type == lRunnerName || pp.type == lRunnerCompleteName ||
           pp.type == lRunnerFamilyName || pp.type == lRunnerGivenName ||
           pp.type == lTeamRunner || (pp.type == lPatrolNameNames && !t)) && rr) {
-        ti = &ppi.gdi.addStringUT(y + pdy, x + pdx, pp.format | tightBBFlag, *text,
-                                  ppi.gdi.scaleLength(limit), ppi.par.cb, pp.fontFace.c_str());
-        ti->setExtra(rr->getId());
-        ti->id = "R";
+        idType = 'R';
+        id = rr->getId();
       }
       else if ((pp.type == lTeamName || pp.type == lPatrolNameNames || pp.type == lTeamNameRaw) && t) {
-        ti = &ppi.gdi.addStringUT(y + pdy, x + pdx, pp.format | tightBBFlag, *text,
-                                  ppi.gdi.scaleLength(limit), ppi.par.cb, pp.fontFace.c_str());
-        ti->setExtra(t->getId());
-        ti->id = "T";
+        idType = 'T';
+        id = t->getId();
       }
-      else {
-        ti = &ppi.gdi.addStringUT(y + pdy, x + pdx,
-                                  pp.format | tightBBFlag, *text, ppi.gdi.scaleLength(limit), 0, pp.fontFace.c_str());
+
+      if (!gdi) {
+        ppi.cells.emplace_back();
+        ListCell &cell = ppi.cells.back();
+        cell.type = pp.type;
+        cell.line = line;
+        cell.x = pp.dx;
+        cell.format = pp.format;
+        cell.idType = idType;
+        cell.id = id;
+        cell.text = *text;
       }
-      if (ti && ppi.keepToghether)
-        ti->lineBreakPrioity = -1;
-      if (ti) {
-        lineHeight = ti->getHeight();
+      else {
+        int tightBBFlag = ppi.par.tightBoundingBox ? 0 : skipBoundingBox;
+        pdy = gdi->scaleLength(pp.dy);
+        pdx = gdi->scaleLength(pp.dx);
+        if (idType) {
+          ti = &gdi->addStringUT(y + pdy, x + pdx, pp.format | tightBBFlag, *text,
+                                 gdi->scaleLength(limit), ppi.par.cb, pp.fontFace.c_str());
+          ti->setExtra(id);
+          ti->id = idType == 'R' ? "R" : "T";
+        }
+        else {
+          ti = &gdi->addStringUT(y + pdy, x + pdx,
+                                 pp.format | tightBBFlag, *text, gdi->scaleLength(limit), 0, pp.fontFace.c_str());
+        }
+        if (ti && ppi.keepToghether)
+          ti->lineBreakPrioity = -1;
+        if (ti) {
+          lineHeight = ti->getHeight();
+        }
+        if (pp.color != colorDefault)
+          ti->setColor(pp.color);
       }
-      if (pp.color != colorDefault)
-        ti->setColor(pp.color);
     }
     ppi.keepToghether |= keepNext;
   }
+
+  if (!gdi && !ppi.cells.empty())
+    ppi.sink->addRow(ppi.getRowType(ppli), ppi.cells);
+
   return updated;
 }
 
-void oEvent::calculatePrintPostKey(const list<oPrintPost> &ppli, gdioutput &gdi, const oListParam &par,
+void oEvent::calculatePrintPostKey(const list<oPrintPost> &ppli, const oListParam &par,
                                    const pTeam t, const pRunner r, const pClub c,
                                    const pClass pc, oCounter &counter, wstring &key)
 {
@@ -3074,7 +3141,7 @@ void oEvent::calculatePrintPostKey(const list<oPrintPost> &ppli, gdioutput &gdi,
   }
 }
 
-void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi, 
+void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput *gdi, ListSink *sink,
                                  pTeam t, pRunner r, pClub club, pClass cls) {
   const list<oPrintPost> &ppli = listInfo.subListPost;
   const oListParam &par = listInfo.lp;
@@ -3091,7 +3158,8 @@ void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
   if (r && (r->getStatusComputed(true) == StatusNoTiming || r->noTiming()))
     return;
 
-  int h = gdi.getLineHeight();
+  // No layout for sink output (w = 0)
+  int h = gdi ? gdi->getLineHeight() : 0;
   int w = 0;
   bool newLine = false;
   int haccum = 0;
@@ -3104,16 +3172,18 @@ void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
       newLine = true;
       continue;
     }
-    h = max(h, gdi.getLineHeight(pl.getFont(), pl.fontFace.c_str()) + gdi.scaleLength(pl.dy));
-    w = max(w, gdi.scaleLength(pl.fixedWidth + pl.dx));
+    if (gdi) {
+      h = max(h, gdi->getLineHeight(pl.getFont(), pl.fontFace.c_str()) + gdi->scaleLength(pl.dy));
+      w = max(w, gdi->scaleLength(pl.fixedWidth + pl.dx));
+    }
   }
   h += haccum;
-  int xlimit = gdi.getCX() + gdi.scaleLength(600);
+  int xlimit = gdi ? gdi->getCX() + gdi->scaleLength(600) : 0;
   par.lineBreakControlList = newLine; // Controls if controls names are printed even if the runner has not punched there yet.
 
   if (w > 0) {
-    gdi.pushX();
-    gdi.fillNone();
+    gdi->pushX();
+    gdi->fillNone();
   }
 
   bool neednewline = false;
@@ -3148,18 +3218,18 @@ void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
     if (filterFinish)
       skip[crs->nControls()] = true;
   }
-  PrintPostInfo ppi(gdi, par);
+  PrintPostInfo ppi(gdi, sink, listInfo);
   if (type == oListInfo::EBaseType::EBaseTypeCoursePunches) {
     for (int k = 0; k < limit; k++) {
       if (w > 0 && updated) {
         updated = false;
-        if (gdi.getCX() + w > xlimit || newLine) {
+        if (gdi->getCX() + w > xlimit || newLine) {
           neednewline = false;
-          gdi.popX();
-          gdi.setCY(gdi.getCY() + h);
+          gdi->popX();
+          gdi->setCY(gdi->getCY() + h);
         }
         else
-          gdi.setCX(gdi.getCX() + w);
+          gdi->setCX(gdi->getCX() + w);
       }
 
       if (!skip[k]) {
@@ -3203,13 +3273,13 @@ void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
       prevPunchTime = punch.getTimeInt();
       if (w > 0 && updated) {
         updated = false;
-        if (gdi.getCX() + w > xlimit || newLine) {
+        if (gdi->getCX() + w > xlimit || newLine) {
           neednewline = false;
-          gdi.popX();
-          gdi.setCY(gdi.getCY() + h);
+          gdi->popX();
+          gdi->setCY(gdi->getCY() + h);
         }
         else
-          gdi.setCX(gdi.getCX() + w);
+          gdi->setCX(gdi->getCX() + w);
       }
 
       updated |= formatPrintPost(ppli, ppi, t, r, club, cls,
@@ -3219,14 +3289,27 @@ void oEvent::listGeneratePunches(const oListInfo &listInfo, gdioutput &gdi,
     }
   }
   if (w > 0) {
-    gdi.popX();
-    gdi.fillDown();
+    gdi->popX();
+    gdi->fillDown();
     if (neednewline)
-      gdi.setCY(gdi.getCY() + h);
+      gdi->setCY(gdi->getCY() + h);
   }
 }
 
 void oEvent::generateList(gdioutput &gdi, bool reEvaluate, const oListInfo &li, bool updateScrollBars) {
+  wstring listname = generateListAux(&gdi, nullptr, reEvaluate, li);
+  gdi.setListDescription(listname);
+  if (updateScrollBars)
+    gdi.updateScrollbars();
+}
+
+void oEvent::generateList(ListSink &sink, bool reEvaluate, const oListInfo &li) {
+  if (li.fixedType)
+    throw meosException("Listan kan inte exporteras i detta format");
+  generateListAux(nullptr, &sink, reEvaluate, li);
+}
+
+wstring oEvent::generateListAux(gdioutput *gdi, ListSink *sink, bool reEvaluate, const oListInfo &li) {
   if (reEvaluate)
     reEvaluateAll(set<int>(), false);
 
@@ -3260,30 +3343,36 @@ void oEvent::generateList(gdioutput &gdi, bool reEvaluate, const oListInfo &li,
     listname += lang.tl(L" Sträcka X#" + li.lp.getLegName());
   }
 
-  generateListInternal(gdi, li, addHead);
+  if (sink)
+    sink->beginList(listname);
+
+  generateListInternal(gdi, sink, li, addHead);
   
   for (list<oListInfo>::const_iterator it = li.next.begin(); it != li.next.end(); ++it) {
     bool interHead = addHead && it->getParam().showInterTitle;
-    if (li.lp.pageBreak || it->lp.pageBreak) {
-      gdi.dropLine(1.0);
-      gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-    }
-    else if (interHead) {
-      gdi.dropLine(1.5);
-      gdi.addStringUT(gdi.getCY() - 1, 0, pageNewChapter, "");
-    }
-    else {
-      gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
+    if (gdi) {
+      if (li.lp.pageBreak || it->lp.pageBreak) {
+        gdi->dropLine(1.0);
+        gdi->addStringUT(gdi->getCY() - 1, 0, pageNewPage, "");
+      }
+      else if (interHead) {
+        gdi->dropLine(1.5);
+        gdi->addStringUT(gdi->getCY() - 1, 0, pageNewChapter, "");
+      }
+      else {
+        gdi->addStringUT(gdi->getCY() - 1, 0, pageNewPage, "");
+      }
     }
 
-    generateListInternal(gdi, *it, interHead);
+    generateListInternal(gdi, sink, *it, interHead);
   }
   // Reset context
   oe->setGeneralResultContext(nullptr);
 
-  gdi.setListDescription(listname);
-  if (updateScrollBars)
-    gdi.updateScrollbars();
+  if (sink)
+    sink->endList();
+
+  return listname;
 }
 
 // Return true -> filtered away
@@ -3440,22 +3529,27 @@ GeneralResult *oListInfo::applyResultModule(oEvent &oe, vector<pRunner> &rlist)
 }
 
 void oEvent::formatHeader(gdioutput& gdi, const oListInfo& li, const pRunner rInput) {
+  PrintPostInfo printPostInfo(&gdi, nullptr, li);
+  formatHeader(printPostInfo, li, rInput);
+}
+
+void oEvent::formatHeader(PrintPostInfo &printPostInfo, const oListInfo& li, const pRunner rInput) {
+  gdioutput *gdi = printPostInfo.gdi;
   vector<tuple<EPostType, int, wstring>> v;
   int* xLimitForwardUpdate = nullptr;
   for (auto& lp : li.head) {
     bool strUpdate = lp.type == lCmpName || lp.type == lString;
-    if (lp.xlimit == 0 && !strUpdate) {
-      v.clear();
-      v.emplace_back(lp.type, lp.legIndex, lp.text);
-      gdiFonts font = lp.getFont();
-      lp.xlimit = li.getMaxCharWidth(*this, gdi, li.getParam().selection, v, font, lp.fontFace.c_str());
-    }
-    else if (strUpdate) {
-      v.clear();
+    if (strUpdate)
       const_cast<wstring&>(lp.text) = li.lp.getCustomTitle(lp.text);
+
+    if (!gdi)
+      continue; // Widths are only needed for layout
+
+    if (lp.xlimit == 0 || strUpdate) {
+      v.clear();
       v.emplace_back(lp.type, lp.legIndex, lp.text);
       gdiFonts font = lp.getFont();
-      lp.xlimit = li.getMaxCharWidth(*this, gdi, li.getParam().selection, v, font, lp.fontFace.c_str());
+      lp.xlimit = li.getMaxCharWidth(*this, *gdi, li.getParam().selection, v, font, lp.fontFace.c_str());
     }
     if (xLimitForwardUpdate)
       (*xLimitForwardUpdate) += lp.xlimit;
@@ -3478,13 +3572,12 @@ void oEvent::formatHeader(gdioutput& gdi, const oListInfo& li, const pRunner rIn
     cls = rInput->getClassRef(true);
   }
 
-  PrintPostInfo printPostInfo(gdi, li.lp);
   formatPrintPost(li.head, printPostInfo, team, rInput, 
                   club, cls, crs,
                   nullptr, nullptr, nullptr, -1);
 }
 
-void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool formatHead) {
+void oEvent::generateListInternal(gdioutput *gdi, ListSink *sink, const oListInfo &li, bool formatHead) {
   li.setupLinks();
   li.transformTypes(*this);
 
@@ -3555,26 +3648,29 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
     }
   }
 
-  PrintPostInfo printPostInfo(gdi, li.lp);
+  PrintPostInfo printPostInfo(gdi, sink, li);
   //oCounter counter;
   //Render header
   vector<tuple<EPostType, int, wstring>> v;
   for (auto &listPostList : { &li.subHead, &li.listPost, &li.subListPost }) {
     for (auto &lp : *listPostList) {
-      if (lp.xlimit == 0) {
+      if (lp.xlimit == 0 && gdi) {
         v.clear();
         v.emplace_back(lp.type, lp.legIndex, lp.text);
         gdiFonts font = lp.getFont();
-        lp.xlimit = li.getMaxCharWidth(*this, gdi, li.getParam().selection, v, font, lp.fontFace.c_str());
+        lp.xlimit = li.getMaxCharWidth(*this, *gdi, li.getParam().selection, v, font, lp.fontFace.c_str());
       }
     }
   }
 
-  if (formatHead && li.getParam().showHeader) 
-    formatHeader(gdi, li, nullptr);
+  if (formatHead && li.getParam().showHeader) {
+    PrintPostInfo headInfo(gdi, sink, li);
+    formatHeader(headInfo, li, nullptr);
+  }
 
   if (li.fixedType) {
-    generateFixedList(gdi, li);
+    if (gdi)
+      generateFixedList(*gdi, li);
     return;
   }
      
@@ -3615,7 +3711,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
 
   wstring oldKey;
 
-  auto formatTeam = [this, &gdi, &li, &gResult, &printPostInfo, &oldKey](pTeam it,
+  auto formatTeam = [this, gdi, sink, &li, &gResult, &printPostInfo, &oldKey](pTeam it,
     bool includeSubHead, int &parLegRangeMin, int &parLegRangeMax, pClass &parLegRangeClass) {
     int linearLegSpec = li.lp.getLegNumber(it->getClassRef(false));
 
@@ -3706,18 +3802,15 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
     if (includeSubHead) {
       wstring newKey;
       printPostInfo.par.relayLegIndex = linearLegSpec;
-      calculatePrintPostKey(li.subHead, gdi, li.lp, &*it, 0, it->Club, it->Class, printPostInfo.counter, newKey);
+      calculatePrintPostKey(li.subHead, li.lp, &*it, 0, it->Club, it->Class, printPostInfo.counter, newKey);
       if (newKey != oldKey) {
-        if (!oldKey.empty())
-          gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-
         wstring legInfo;
         if (linearLegSpec >= 0 && it->getClassRef(false)) {
           // Specified leg
           legInfo = lang.tl(L", Str. X#" + li.lp.getLegName());
         }
 
-        gdi.addStringUT(pagePageInfo, it->getClass(true) + legInfo); // Teamlist
+        printPostInfo.newPage(oldKey.empty(), it->getClass(true) + legInfo); // Teamlist
 
         oldKey.swap(newKey);
         printPostInfo.counter.level2 = 0;
@@ -3843,7 +3936,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
         if (!r) 
           return true;
 
-        listGeneratePunches(li, gdi, &*it, r, it->Club, it->Class);
+        listGeneratePunches(li, gdi, sink, &*it, r, it->Club, it->Class);
       }
     }
     return true;
@@ -3857,13 +3950,10 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
  
       wstring newKey;
       printPostInfo.par.relayLegIndex = -1;
-      calculatePrintPostKey(li.subHead, gdi, li.lp, it->tInTeam, &*it, it->Club, it->getClassRef(true), printPostInfo.counter, newKey);
+      calculatePrintPostKey(li.subHead, li.lp, it->tInTeam, &*it, it->Club, it->getClassRef(true), printPostInfo.counter, newKey);
 
       if (newKey != oldKey) {
-        if (!oldKey.empty())
-          gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-        
-        gdi.addStringUT(pagePageInfo, it->getClass(true));
+        printPostInfo.newPage(oldKey.empty(), it->getClass(true));
 
         oldKey.swap(newKey);
         printPostInfo.counter.level2 = 0;
@@ -3881,7 +3971,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
 
         if (li.listSubType == li.EBaseTypeCoursePunches ||
             li.listSubType == li.EBaseTypeAllPunches) {
-          listGeneratePunches(li, gdi, it->tInTeam, &*it, it->Club, it->getClassRef(true));
+          listGeneratePunches(li, gdi, sink, it->tInTeam, &*it, it->Club, it->getClassRef(true));
         }
       }
       ++printPostInfo.counter;
@@ -3940,12 +4030,8 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
           continue;
 
         if (!startClub) {
-          if (!first)
-            gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-          else
-            first = false;
-          
-          gdi.addStringUT(pagePageInfo, it->getName());
+          printPostInfo.newPage(first, it->getName());
+          first = false;
           printPostInfo.counter.level2 = 0;
           printPostInfo.counter.level3 = 0;
           printPostInfo.reset();
@@ -3964,7 +4050,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
 
           if (li.listSubType == li.EBaseTypeCoursePunches ||
               li.listSubType == li.EBaseTypeAllPunches) {
-            listGeneratePunches(li, gdi, rit->tInTeam, &*rit, rit->Club, rit->getClassRef(true));
+            listGeneratePunches(li, gdi, sink, rit->tInTeam, &*rit, rit->Club, rit->getClassRef(true));
           }
         }
       }//Runners
@@ -4002,12 +4088,8 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
       bool startClub = false;
       for (auto rit : clubToTeam[it->getId()]) {
         if (!startClub) {
-          if (!first)
-            gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-          else
-            first = false;
-
-          gdi.addStringUT(pagePageInfo, it->getName());
+          printPostInfo.newPage(first, it->getName());
+          first = false;
           printPostInfo.counter.level2 = 0;
           printPostInfo.counter.level3 = 0;
           printPostInfo.reset();
@@ -4041,12 +4123,10 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
       }
 
       wstring newKey;
-      calculatePrintPostKey(li.subHead, gdi, li.lp, 0, 0, 0, 0, printPostInfo.counter, newKey);
+      calculatePrintPostKey(li.subHead, li.lp, 0, 0, 0, 0, printPostInfo.counter, newKey);
 
       if (newKey != oldKey) {
-        if (!oldKey.empty())
-          gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-        
+        printPostInfo.newPage(oldKey.empty());
         oldKey.swap(newKey);
         printPostInfo.counter.level2 = 0;
         printPostInfo.counter.level3 = 0;
@@ -4074,12 +4154,10 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
         continue;
 
       wstring newKey;
-      calculatePrintPostKey(li.subHead, gdi, li.lp, 0, 0, 0, 0, printPostInfo.counter, newKey);
+      calculatePrintPostKey(li.subHead, li.lp, 0, 0, 0, 0, printPostInfo.counter, newKey);
 
       if (newKey != oldKey) {
-        if (!oldKey.empty())
-          gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-        
+        printPostInfo.newPage(oldKey.empty());
         oldKey.swap(newKey);
         printPostInfo.counter.level2 = 0;
         printPostInfo.counter.level3 = 0;
@@ -4152,7 +4230,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
         pControl ctrl = nullptr;
         RogainingLegInfo rgLeg;
         wstring newKey;
-        calculatePrintPostKey(li.subHead, gdi, li.lp, nullptr, nullptr, nullptr, rgCls.first, printPostInfo.counter, newKey);
+        calculatePrintPostKey(li.subHead, li.lp, nullptr, nullptr, nullptr, rgCls.first, printPostInfo.counter, newKey);
 
         rgLeg.bestTime = leg.bestTime;
         rgLeg.numCompetitors = leg.numCompetitors;
@@ -4169,9 +4247,7 @@ void oEvent::generateListInternal(gdioutput &gdi, const oListInfo &li, bool form
         pCourse crs = rgCls.first ? rgCls.first->getCourse(false) : nullptr;
 
         if (newKey != oldKey) {
-          if (!oldKey.empty())
-            gdi.addStringUT(gdi.getCY() - 1, 0, pageNewPage, "");
-
+          printPostInfo.newPage(oldKey.empty());
           oldKey.swap(newKey);
           printPostInfo.counter.level3 = 0;
           printPostInfo.reset();
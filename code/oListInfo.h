@@ -739,6 +739,7 @@ public:
   friend class oEvent;
   friend class MetaList;
   friend class MetaListContainer;
+  friend struct PrintPostInfo;
 
   int getMaxCharWidth(oEvent &oe,
                       const gdioutput &gdi,
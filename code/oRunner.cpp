@@ -48,6 +48,7 @@
 #include "cardsystem.h"
 #include "datadefiners.h"
 #include "xmlparser.h"
+#include "runnersearch.h"
 #include <unordered_map>
 
 char RunnerStatusOrderMap[100];
@@ -73,6 +74,10 @@ oAbstractRunner::DynamicValue &oAbstractRunner::DynamicValue::update(const oEven
   return *this;
 }
 
+void oAbstractRunner::DynamicValue::validate(const oEvent &oe) {
+  dataRevision = oe.dataRevision;
+}
+
 int oAbstractRunner::DynamicValue::get(bool preferStd) const {
   if (preferStd && valueStd >= 0)
     return valueStd;
@@ -585,9 +590,11 @@ void oAbstractRunner::setClassId(int id, bool isManualUpdate) {
     apply(ChangeType::Update, nullptr);
     if (Class) {
       Class->clearCache(true);
+      Class->setResultChanged();
     }
     if (pc) {
       pc->clearCache(true);
+      pc->setResultChanged();
       if (isManualUpdate) {
         setFlag(FlagUpdateClass, true);
         // Update heat data
@@ -618,6 +625,8 @@ void oRunner::setClassId(int id, bool isManualUpdate) {
         pClass newHeatClass = getClassRef(true);
         oldHeatClass->clearCache(true);
         newHeatClass->clearCache(true);
+        oldHeatClass->setResultChanged();
+        newHeatClass->setResultChanged();
         tSplitRevision = 0;
         apply(ChangeType::Quiet, nullptr);
       }
@@ -686,9 +695,11 @@ void oRunner::setClassId(int id, bool isManualUpdate) {
     if (Class!=pc && !isTemporaryObject) {
       if (Class) {
         Class->clearCache(true);
+        Class->setResultChanged();
       }
       if (pc) {
         pc->clearCache(true);
+        pc->setResultChanged();
       }
       tSplitRevision = 0;
       updateChanged();
@@ -2086,9 +2097,7 @@ bool oRunner::sortSplit(const oRunner &a, const oRunner &b) {
       if (a.tempRT!=b.tempRT)
         return a.tempRT<b.tempRT;
     }
-    return CompareString(LOCALE_USER_DEFAULT, 0,
-                        a.tRealName.c_str(), a.tRealName.length(),
-                        b.tRealName.c_str(), b.tRealName.length()) == CSTR_LESS_THAN;
+    return a.getNameSortKey() < b.getNameSortKey();
   }
 }
 
@@ -2108,9 +2117,7 @@ bool oRunner::operator<(const oRunner &c) const {
   if (!myClass || !cClass)
     return size_t(myClass) < size_t(cClass);
   else if (Class == cClass && Class->getClassStatus() != oClass::ClassStatus::Normal)
-    return CompareString(LOCALE_USER_DEFAULT, 0,
-                         tRealName.c_str(), tRealName.length(),
-                         c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+    return getNameSortKey() < c.getNameSortKey();
 
   if (oe->CurrentSortOrder == ClassStartTime || oe->CurrentSortOrder == ClubClassStartTime) {
     if (myClass->Id != cClass->Id) {
@@ -2175,9 +2182,7 @@ bool oRunner::operator<(const oRunner &c) const {
     else {
       if (stat == StatusOK) {
         if (Class->getNoTiming()) {
-          return CompareString(LOCALE_USER_DEFAULT, 0,
-                               tRealName.c_str(), tRealName.length(),
-                               c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+          return getNameSortKey() < c.getNameSortKey();
         }
         int s = getNumShortening();
         int cs = c.getNumShortening();
@@ -2215,9 +2220,7 @@ bool oRunner::operator<(const oRunner &c) const {
     else {
       if (stat == StatusOK) {
         if (Class->getNoTiming()) {
-          return CompareString(LOCALE_USER_DEFAULT, 0,
-                               tRealName.c_str(), tRealName.length(),
-                               c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+          return getNameSortKey() < c.getNameSortKey();
         }
         int s = getNumShortening();
         int cs = c.getNumShortening();
@@ -2257,9 +2260,7 @@ bool oRunner::operator<(const oRunner &c) const {
     else {
       if (stat == StatusOK) {
         if (Class->getNoTiming()) {
-          return CompareString(LOCALE_USER_DEFAULT, 0,
-                               tRealName.c_str(), tRealName.length(),
-                               c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+          return getNameSortKey() < c.getNameSortKey();
         }
         int s = getNumShortening();
         int cs = c.getNumShortening();
@@ -2274,9 +2275,7 @@ bool oRunner::operator<(const oRunner &c) const {
     }
   }
   else if (oe->CurrentSortOrder == SortByName) {
-    return CompareString(LOCALE_USER_DEFAULT, 0,
-                         tRealName.c_str(), tRealName.length(),
-                         c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+    return getNameSortKey() < c.getNameSortKey();
   }
   else if (oe->CurrentSortOrder == SortByLastName) {
     wstring a = getFamilyName();
@@ -2423,9 +2422,7 @@ bool oRunner::operator<(const oRunner &c) const {
         return s1 < s2;
       else if (s1 == StatusOK) {
         if (Class->getNoTiming()) {
-          return CompareString(LOCALE_USER_DEFAULT, 0,
-                               tRealName.c_str(), tRealName.length(),
-                               c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+          return getNameSortKey() < c.getNameSortKey();
         }
         int t = getTotalRunningTime(FinishTime, true, true);
         int ct = c.getTotalRunningTime(c.FinishTime, true, true);
@@ -2526,9 +2523,7 @@ bool oRunner::operator<(const oRunner &c) const {
     if (currentControlTime != c.currentControlTime)
       return currentControlTime < c.currentControlTime;
   }
-  return CompareString(LOCALE_USER_DEFAULT, 0,
-                       tRealName.c_str(), tRealName.length(),
-                       c.tRealName.c_str(), c.tRealName.length()) == CSTR_LESS_THAN;
+  return getNameSortKey() < c.getNameSortKey();
 
 }
 
@@ -2603,8 +2598,10 @@ void oRunner::propagateClub() {
 
 void oAbstractRunner::setStartNo(int no, ChangeType changeType) {
   if (no!=StartNo) {
-    if (oe)
+    if (oe) {
       oe->bibStartNoToRunnerTeam.clear();
+      oe->runnerSearchChanged();
+    }
     StartNo=no;
     updateChanged(changeType);
   }
@@ -2788,6 +2785,7 @@ void oRunner::setCardNo(int cno, bool matchCard, bool updateFromDatabase)
   if (cno != getCardNo()) {
     int oldNo = getCardNo();
     cardNumber = cno;
+    oe->runnerSearchChanged();
 
     if (oe->cardToRunnerHash && cno != 0 && isAddedToEvent() && !isTemporaryObject) {
       oe->cardToRunnerHash->emplace(cno, this);
@@ -2994,6 +2992,7 @@ void oRunner::setName(const wstring &in, bool manualUpdate)
     if (newRealName != tRealName || n != sName) {
       sName = n;
       tRealName = newRealName;
+      oe->runnerSearchChanged();
 
       if (manualUpdate)
         setFlag(FlagUpdateName, true);
@@ -3008,6 +3007,7 @@ void oRunner::setName(const wstring &in, bool manualUpdate)
         multiRunner[k]->sName = n;
         multiRunner[k]->tRealName = tRealName;
         multiRunner[k]->updateChanged();
+        oe->runnerSearchChanged();
       }
     }
     if (tInTeam && Class && Class->isSingleRunnerMultiStage()) {
@@ -4078,7 +4078,8 @@ const wstring &oRunner::getUIName() const {
 void oRunner::addTableRow(Table &table) const
 {
   oRunner &it = *pRunner(this);
-  table.addRow(getId(), &it);
+  if (!table.addRow(getId(), &it))
+    return;
 
   int row = 0;
   table.set(row++, it, TID_ID, itow(getId()), false);
@@ -4624,98 +4625,39 @@ void oRunner::fillSpeakerObject(int leg, int previousControlCourseIdX, const vec
   }
 }
 
+void oEvent::runnerSearchChanged() const {
+  if (runnerSearchIndex)
+    runnerSearchIndex->invalidate();
+}
+
 pRunner oEvent::findRunner(const wstring &s, int lastId, 
                            const unordered_set<int> &inputFilter,
                            unordered_set<int> &matchFilter) const {
   matchFilter.clear();
-  wstring trm = trim(s);
-  int len = trm.length();
-  int sn = _wtoi(trm.c_str());
-  wchar_t s_lc[1024];
-  wcscpy_s(s_lc, s.c_str());  
-  prepareMatchString(s_lc, len);
-  int score;
-  pRunner res = 0;
-
-  if (!inputFilter.empty() && inputFilter.size() < Runners.size() / 2) {
-    for (unordered_set<int>::const_iterator it = inputFilter.begin(); it!= inputFilter.end(); ++it) {
-      int id = *it;
-      pRunner r = getRunner(id, 0);
-      if (!r)
-        continue;
-
-      if (sn>0) {
-        if (matchNumber(r->StartNo, s_lc) || matchNumber(r->getCardNo(), s_lc)) {
-          matchFilter.insert(id);
-          if (res == 0)
-            res = r;
-        }
-      }
-      else {
-        if (filterMatchString(r->tRealName, s_lc, score)) {
-          matchFilter.insert(id);
-          if (res == 0)
-            res = r;
-        }
-      }
-    }
-    return res;
-  }
-
-  oRunnerList::const_iterator itstart = Runners.begin();
-
-  if (lastId) {
-    for (; itstart != Runners.end(); ++itstart) {
-      if (itstart->Id==lastId) {
-        ++itstart;
-        break;
-      }
-    }
-  }
-
-  oRunnerList::const_iterator it;
-  for (it=itstart; it != Runners.end(); ++it) {
-    pRunner r = pRunner(&(*it));
-    if (r->skip())
-       continue;
-
-    if (sn>0) {
-      if (matchNumber(r->StartNo, s_lc) || matchNumber(r->getCardNo(), s_lc)) {
-        matchFilter.insert(r->Id);
-        if (res == 0)
-          res = r;
-      }
-    }
-    else {
-      if (filterMatchString(r->tRealName, s_lc, score)) {
-        matchFilter.insert(r->Id);
-        if (res == 0)
-          res = r;
-      }
-    }
-  }
-  for (it=Runners.begin(); it != itstart; ++it) {
-    pRunner r = pRunner(&(*it));
-    if (r->skip())
-       continue;
-
-    if (sn>0) {
-      if (matchNumber(r->StartNo, s_lc) || matchNumber(r->getCardNo(), s_lc)) {
-        matchFilter.insert(r->Id);
-        if (res == 0)
-          res = r;
-      }
-    }
-    else {
-      if (filterMatchString(r->tRealName, s_lc, score)) {
-        matchFilter.insert(r->Id);
-        if (res == 0)
-          res = r;
-      }
-    }
+  if (!runnerSearchIndex)
+    runnerSearchIndex = make_shared<RunnerSearchIndex>();
+
+  vector<pRunner> match;
+  runnerSearchIndex->find(*this, s, match);
+
+  // Restrict to previous matches, if few
+  bool useInputFilter = !inputFilter.empty() && inputFilter.size() < Runners.size() / 2;
+  pRunner res = nullptr, first = nullptr;
+  bool afterLast = lastId == 0;
+  for (pRunner r : match) {
+    if (useInputFilter && !inputFilter.count(r->Id))
+      continue;
+    matchFilter.insert(r->Id);
+    if (!first)
+      first = r;
+    if (!res && afterLast)
+      res = r;
+    if (r->Id == lastId)
+      afterLast = true;
   }
 
-  return res;
+  // Start over from the first match after the last found runner
+  return res ? res : first;
 }
 
 int oRunner::getTimeAfter(int leg, bool allowUpdate) const
@@ -6722,6 +6664,7 @@ void oRunner::init(const RunnerWDBEntry &dbr, bool updateOnlyExt) {
   if (updateOnlyExt) {
     dbr.getName(sName);
     getRealName(sName, tRealName);
+    oe->runnerSearchChanged();
     getDI().setString("Nationality", dbr.getNationality());
     getDI().setInt("BirthYear", dbr.dbe().getBirthDateInt());
     getDI().setString("Sex", dbr.getSex());
@@ -6907,6 +6850,51 @@ void oRunner::changedObject() {
   oe->sqlRunners.changed = true;
 }
 
+void oAbstractRunner::markResultClass(int &markedId, pClass cls) {
+  int id = cls ? cls->getId() : 0;
+  if (markedId != id && markedId != 0) {
+    pClass oldClass = oe->getClass(markedId);
+    if (oldClass)
+      oldClass->setResultChanged();
+  }
+  markedId = id;
+  if (cls)
+    cls->setResultChanged();
+}
+
+bool oRunner::markResultChanged() {
+  if (tResultClassId[0] == 0 || !Class)
+    oe->noClassResultRevision = oe->dataRevision; // May have left the runners without class
+
+  markResultClass(tResultClassId[0], Class);
+  pClass cls2 = getClassRef(true);
+  markResultClass(tResultClassId[1], cls2 != Class ? cls2 : nullptr);
+
+  if (!Class)
+    return false;
+
+  if (tInTeam && tInTeam->Class != Class && tInTeam->Class)
+    tInTeam->Class->setResultChanged();
+
+  return true;
+}
+
+bool oRunner::isRowChangedSince(unsigned long revision) const {
+  if (isChangedSince(revision) || oe->getGlobalResultRevision() > revision)
+    return true;
+
+  // Places and team results depend on the other runners of the class
+  const pClass cls2 = getClassRef(true);
+  if (!Class || Class->getResultChangeRevision() > revision ||
+      (cls2 && cls2->getResultChangeRevision() > revision))
+    return true;
+
+  if (tInTeam && tInTeam->isChangedSince(revision))
+    return true;
+
+  return tParentRunner && tParentRunner->isChangedSince(revision);
+}
+
 int oRunner::getBuiltinAdjustment() const { 
   if (adjustTimes.empty())
     return 0;
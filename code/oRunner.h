@@ -146,6 +146,14 @@ protected:
   mutable int tComputedPoints = -1;
 
   vector<vector<wstring>> dynamicData;
+
+  CollationKey tNameKey;
+
+  // Ids of the classes last marked with changed results (class and virtual class).
+  // The previous class is marked too when the class changes.
+  int tResultClassId[2] = { 0, 0 };
+  void markResultClass(int &markedId, pClass cls);
+
 public:
   /** Return true if this and target are the same, or target is in this team, or this is in the target team.*/
   virtual bool matchAbstractRunner(const oAbstractRunner *target) const = 0;
@@ -356,6 +364,8 @@ public:
 
   virtual void setName(const wstring &n, bool manualChange);
   virtual const wstring &getName() const {return sName;}
+  /** Binary sort key of getName() in the user locale. Compare with operator<. */
+  const string &getNameSortKey() const { return tNameKey.get(getName()); }
 
   void setFinishTimeS(const wstring &t);
   virtual	void setFinishTime(int t);
@@ -536,6 +546,10 @@ public:
     bool isOld(const oEvent& oe) const;
     bool isOld(const oEvent &oe, int key) const;
     DynamicValue &update(const oEvent &oe, int key, int v, bool setStd);
+    // Returns true if the value was calculated for the specified key (regardless of revision)
+    bool hasKey(int key) const { return forKey == key; }
+    // Mark a stored value as valid for the current data revision
+    void validate(const oEvent &oe);
     void invalidate(bool invalid) { if (invalid) dataRevision = -1; }
     int get(bool preferStd) const; 
   };
@@ -662,6 +676,7 @@ protected:
   BYTE oDataOld[dataSize];
 
   void changedObject() final;
+  bool markResultChanged() final;
 
   bool storeTimes(); // Returns true if best times were updated
   
@@ -1100,6 +1115,7 @@ public:
   const wstring &getSplitTimeS(int controlNumber, bool normalized, SubSecond mode) const;
 
   void addTableRow(Table &table) const;
+  bool isRowChangedSince(unsigned long revision) const override;
   pair<int, bool> inputData(int id, const wstring &input,
                             int inputId, wstring &output, bool noUpdate) override;
   void fillInput(int id, vector< pair<wstring, size_t> > &elements, size_t &selected) override;
@@ -1205,6 +1221,7 @@ public:
   virtual ~oRunner();
 
   friend class oCard;
+  friend class oFreePunch;
   friend class MeosSQL;
   friend class oEvent;
   friend class oTeam;
@@ -226,6 +226,7 @@ void oEvent::removeTeam(int Id)
     if (it->getId() == Id) {
       if (hasDBConnection() && !it->isRemoved())
         sqlRemove(&*it);
+      journalRemoved(*it);
       dataRevision++;
       it->prepareRemove();
       Teams.erase(it);
@@ -837,14 +838,10 @@ int oAbstractRunner::compareClubs(const oClub* ca, const oClub* cb) {
     else if (cb == nullptr)
       return false;
 
-    const wstring an = ca->getName();
-    const wstring bn = cb->getName();
-    int res = CompareString(LOCALE_USER_DEFAULT, 0,
-      an.c_str(), an.length(),
-      bn.c_str(), bn.length());
-
-    if (res != CSTR_EQUAL)
-      return res == CSTR_LESS_THAN;
+    const string &an = ca->getNameSortKey();
+    const string &bn = cb->getNameSortKey();
+    if (an != bn)
+      return an < bn;
   }
   return 2;
 }
@@ -890,9 +887,7 @@ bool oTeam::compareResult(const oTeam &a, const oTeam &b)
     return aix < bix;
   }
 
-  return CompareString(LOCALE_USER_DEFAULT, 0,
-                       a.sName.c_str(), a.sName.length(),
-                       b.sName.c_str(), b.sName.length()) == CSTR_LESS_THAN;
+  return a.getNameSortKey() < b.getNameSortKey();
 }
 
 bool oTeam::compareResultNoSno(const oTeam &a, const oTeam &b)
@@ -927,9 +922,7 @@ bool oTeam::compareResultNoSno(const oTeam &a, const oTeam &b)
       return cres != 0;
   }
 
-  return CompareString(LOCALE_USER_DEFAULT, 0,
-                       a.sName.c_str(), a.sName.length(),
-                       b.sName.c_str(), b.sName.length()) == CSTR_LESS_THAN;
+  return a.getNameSortKey() < b.getNameSortKey();
 }
 
 
@@ -949,9 +942,7 @@ bool oTeam::compareSNO(const oTeam &a, const oTeam &b) {
     else return false;
   }
 
-  return CompareString(LOCALE_USER_DEFAULT, 0,
-                       a.sName.c_str(), a.sName.length(),
-                       b.sName.c_str(), b.sName.length()) == CSTR_LESS_THAN;
+  return a.getNameSortKey() < b.getNameSortKey();
 }
 
 bool oTeam::isRunnerUsed(int rId) const {
@@ -2112,7 +2103,8 @@ void oEvent::generateTeamTableData(Table &table, oTeam *addTeam)
 
 void oTeam::addTableRow(Table &table) const {
   oRunner &it = *pRunner(this);
-  table.addRow(getId(), &it);
+  if (!table.addRow(getId(), &it))
+    return;
 
   int row = 0;
   table.set(row++, it, TID_ID, itow(getId()), false);
@@ -2679,6 +2671,32 @@ void oTeam::changedObject() {
   oe->sqlTeams.changed = true;
 }
 
+bool oTeam::markResultChanged() {
+  markResultClass(tResultClassId[0], Class);
+  if (!Class)
+    return false;
+
+  for (pRunner r : Runners) {
+    if (r && r->Class && !r->markResultChanged())
+      return false;
+  }
+  return true;
+}
+
+bool oTeam::isRowChangedSince(unsigned long revision) const {
+  if (isChangedSince(revision) || oe->getGlobalResultRevision() > revision)
+    return true;
+
+  if (!Class || Class->getResultChangeRevision() > revision)
+    return true;
+
+  for (pRunner r : Runners) {
+    if (r && r->isChangedSince(revision))
+      return true;
+  }
+  return false;
+}
+
 bool oTeam::matchAbstractRunner(const oAbstractRunner* target) const {
   if (target == nullptr)
     return false;
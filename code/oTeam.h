@@ -122,6 +122,7 @@ protected:
                                   // Maps -1 to last runner
 
   void addTableRow(Table &table) const;
+  bool isRowChangedSince(unsigned long revision) const override;
 
   pair<int, bool> inputData(int id, const wstring &input,
                             int inputId, wstring &output, bool noUpdate);
@@ -138,6 +139,7 @@ protected:
                       bool &hasRunner) const;
 
   void changedObject() final;
+  bool markResultChanged() final;
 
 public:
 
@@ -430,6 +430,7 @@ void OnlineResults::process(gdioutput &gdi, oEvent *oe, AutoSyncType ast) {
       oe->getAllClasses(classes);
 
     wstring t;
+    string iofData;
     int xmlSize = 0;
     InfoCompetition& ic = getInfoServer();
     xmlbuffer xmlbuff;
@@ -454,19 +455,32 @@ void OnlineResults::process(gdioutput &gdi, oEvent *oe, AutoSyncType ast) {
       }
     }
     else {
-      t = getTempFile();
       if (dataType == DataType::IOF2)
-        oe->exportIOFSplits(oEvent::IOF20, t.c_str(), false, false,
+        oe->exportIOFSplits(oEvent::IOF20, iofData, false, false,
           classes, make_tuple("", "", true), getCompetitionName(*oe).first, -1, false, false, true, true, false, false);
       else if (dataType == DataType::IOF3)
-        oe->exportIOFSplits(oEvent::IOF30, t.c_str(), false, false,
+        oe->exportIOFSplits(oEvent::IOF30, iofData, false, false,
           classes, make_tuple("", "", true), getCompetitionName(*oe).first, -1, true, false, true, true, false, false);
       else
         throw meosException("Internal error");
     }
 
-    if (!t.empty() || xmlbuff.size() > 0) {
-      if (sendToFile) {
+    if (!iofData.empty() || xmlbuff.size() > 0) {
+      if (sendToFile && !iofData.empty()) {
+        wstring fn = getExportFileName();
+        ofstream fout(fn.c_str(), ios::binary);
+        fout.write(iofData.c_str(), iofData.size());
+        fout.close();
+        if (!fout.good())
+          gdi.addInfoBox("", L"Kunde inte skriva resultat till X#" + fn, L"");
+        else
+          bytesExported += iofData.size();
+
+        if (!exportScript.empty()) {
+          ShellExecute(NULL, NULL, exportScript.c_str(), fn.c_str(), NULL, SW_HIDE);
+        }
+      }
+      else if (sendToFile) {
 
         if (xmlbuff.size() > 0) {
           t = getTempFile();
@@ -518,24 +532,22 @@ void OnlineResults::process(gdioutput &gdi, oEvent *oe, AutoSyncType ast) {
         string tmp;
         const int total = max<int>(xmlbuff.size(), 1u);
 
+        // Each chunk is serialized, compressed, posted and parsed in memory.
+        // The buffers are reused between chunks to keep their capacity.
+        string xmlData, zipped, response;
+        xmlparser xmlOut;
         while (moreToWrite) {
-          t = getTempFile();
-          xmlparser xmlOut;
-          xmlbuff.startXML(xmlOut, t);
+          xmlOut.openMemoryOutput(false);
+          xmlbuff.startTagXML(xmlOut);
           moreToWrite = xmlbuff.commit(xmlOut, buffLimit);
           xmlOut.endTag();
           xmlSize = xmlOut.closeOut();
-          wstring result = getTempFile();
+          xmlOut.getMemoryOutput(xmlData);
           bool wasZip = false;
           if (!forceNoZip && ((zipFile && xmlSize > 1024) || forceZIP)) {
-            wstring zipped = getTempFile();
-            zip(zipped.c_str(), 0, vector<wstring>(1, t));
-            removeTempFile(t);
-            t = zipped;
+            zipMemory("mop.xml", xmlData, zipped);
             wasZip = true;
-            struct _stat st;
-            _wstat(t.c_str(), &st);
-            bytesExported += st.st_size;
+            bytesExported += zipped.size();
           }
           else
             bytesExported += xmlSize;
@@ -553,34 +565,22 @@ void OnlineResults::process(gdioutput &gdi, oEvent *oe, AutoSyncType ast) {
             addedHeader = true;
           }
 
-          dwl.postFile(url, t, result, key, pw);
-          removeTempFile(t);
+          dwl.postData(url, wasZip ? zipped : xmlData, response, key, pw);
 
           pwMain.setProgress(1000 - (1000 * xmlbuff.size()) / total);
 
           xmlparser xml;
           xmlobject res;
           try {
-            xml.read(result);
+            xml.readMemory(response, 0);
             res = xml.getObject("MOPStatus");
           }
           catch (std::exception&) {
-            ifstream is(result.c_str());
-            is.seekg(0, is.end);
-            int length = (int)is.tellg();
-            is.seekg(0, is.beg);
-            char* buffer = new char[length + 1];
-            is.read(buffer, length);
-            is.close();
-            removeTempFile(result);
-            buffer[length] = 0;
-            OutputDebugStringA(buffer);
-            split(buffer, "\n", errorLines);
-            delete[] buffer;
+            OutputDebugStringA(response.c_str());
+            split(response, "\n", errorLines);
             formatError(gdi);
             throw meosException("Onlineservern svarade felaktigt.");
           }
-          removeTempFile(result);
 
           if (res)
             res.getObjectString("status", tmp);
@@ -244,6 +244,7 @@ ParseNode *Parser::parseValue(const string &word, const string &expr, size_t &po
       matchSE(expr, pos, '[', ']');
       ArrayValueNode *arr = getArrayValue();
       arr->expr = word;
+      arr->slot = getSlot(word);
       arr->index = parseStatement(expr.substr(start, pos-start-1), false);
       
       eatWhite(expr, pos);
@@ -272,7 +273,7 @@ ParseNode *Parser::parseValue(const string &word, const string &expr, size_t &po
       un->op = OpNone;
 
       if (sword == "size") {
-        if (isMatrix(word))
+        if (isMatrix(getSlot(word)))
           un->op = OpSizeBase;
         else  
           un->op = OpSize;
@@ -284,6 +285,7 @@ ParseNode *Parser::parseValue(const string &word, const string &expr, size_t &po
       if (un->op != OpNone) {
         ValueNode *vn = getValue();
         vn->value = word;
+        vn->slot = getSlot(word);
         un->right = vn;
         return un;
       }
@@ -293,6 +295,11 @@ ParseNode *Parser::parseValue(const string &word, const string &expr, size_t &po
   }
   ValueNode *vn = getValue();
   vn->value = word;
+  vn->slot = getSlot(word);
+  if (isdigit(word[0])) {
+    vn->isConstant = true;
+    vn->constant = atoi(word.c_str());
+  }
   return vn;
 }
 
@@ -740,122 +747,140 @@ ParseNode *Parser::parse(const string &expr) {
   }
 }
 
-int Parser::evaluate(const string &input) const {
+int Parser::getSlot(const string &name) {
+  auto res = slots.emplace(name, int(slotNames.size()));
+  if (res.second) {
+    slotNames.push_back(name);
+    symbols.emplace_back();
+    variables.emplace_back();
+    hasVariable.push_back(false);
+  }
+  return res.first->second;
+}
+
+int Parser::findSlot(const string &name) const {
+  auto res = slots.find(name);
+  if (res != slots.end())
+    return res->second;
+  return -1;
+}
+
+int Parser::evaluate(int slot) const {
+  const string &input = slotNames[slot];
   if (input.empty())
     throw meosException("Empty expression");
 
   if (isdigit(input[0]))
     return atoi(input.c_str());
 
-  {
-    map<string, Symbol>::const_iterator res = symb.find(input);
-    if (res != symb.end()) {
-      if (res->second.value.empty())
-        throw meosException("Internal error");
-      if (res->second.value[0].size() == 1)
-        return res->second.value[0][0];
-      throw meosException("X is an array.#" + input);
-    }
+  if (const Symbol *s = getSymbol(slot)) {
+    if (s->value.empty())
+      throw meosException("Internal error");
+    if (s->value[0].size() == 1)
+      return s->value[0][0];
+    throw meosException("X is an array.#" + input);
   }
 
-  map<string, vector<int> >::iterator res = var.find(input);
-  if (res != var.end()) {
-    if (res->second.size() == 1)
-      return res->second[0];
+  if (hasVariable[slot]) {
+    const vector<int> &v = variables[slot];
+    if (v.size() == 1)
+      return v[0];
     throw meosException("X is an array.#" + input);
   }
   throw meosException("Unknown symbol X#" + input);
 }
 
-int Parser::evaluate(const string &input, int index, int index2) const {
+int Parser::evaluate(int slot, int index, int index2) const {
+  const string &input = slotNames[slot];
   if (input.empty())
     throw meosException("Empty expression");
 
   if (isdigit(input[0]))
     return atoi(input.c_str());
 
-  map<string, Symbol>::const_iterator res = symb.find(input);
-  if (res != symb.end()) {
-    if (size_t(index2) < res->second.value.size() && 
-        size_t(index) < res->second.value[index2].size())
-      return res->second.value[index2][index];
+  if (const Symbol *s = getSymbol(slot)) {
+    if (size_t(index2) < s->value.size() && 
+        size_t(index) < s->value[index2].size())
+      return s->value[index2][index];
     if (index2 == 0)
       throw meosException("Index X in Y is out of range.#" + itos(index) + "#" + input);
     else
       throw meosException("Index X in Y is out of range.#" + itos(index2) + "," + itos(index) + "#" + input);
   }
 
-  map<string, vector<int> >::const_iterator res2 = var.find(input);
-  if (res2 != var.end()) {
+  if (hasVariable[slot]) {
+    const vector<int> &v = variables[slot];
     if (index2 != 0)
       throw meosException("Index X in Y is out of range.#" + itos(index2) + "#" + input);
-    if (size_t(index) < res2->second.size())
-      return res2->second[index];
+    if (size_t(index) < v.size())
+      return v[index];
     throw meosException("Index X in Y is out of range.#" + itos(index) + "#" + input);
   }
   throw meosException("Unknown symbol X#" + input);
 }
 
-int Parser::evaluateSize(const string &input, int index) const {
+int Parser::evaluateSize(int slot, int index) const {
+  const string &input = slotNames[slot];
   if (input.empty())
     throw meosException("Empty expression");
 
   if (isdigit(input[0]))
     throw meosException("Constant expression");
-  {
-    map<string, Symbol >::const_iterator res = symb.find(input);
-
-    if (res != symb.end()) {
-      if (index == -1) 
-        return res->second.value.size();
-      else {
-        if (size_t(index) < res->second.value.size())
-          return res->second.value[index].size();
-        else
-          throw meosException("Index out of range for X.#" + input);
-      }
+ 
+  if (const Symbol *s = getSymbol(slot)) {
+    if (index == -1) 
+      return s->value.size();
+    else {
+      if (size_t(index) < s->value.size())
+        return s->value[index].size();
+      else
+        throw meosException("Index out of range for X.#" + input);
     }
   }
 
-  map<string, vector<int> >::const_iterator res = var.find(input);
-  if (res != var.end()) {
+  if (hasVariable[slot]) {
     if (index != 0)
       throw meosException("Index out of range for X.#" + input);
-    return res->second.size();
+    return variables[slot].size();
   }
   throw meosException("Unknown symbol X#" + input);
 }
 
-void Parser::sortArray(const string &input) const {
-  map<string, vector<int> >::iterator res = var.find(input);
-  if (res != var.end()) {
-    sort(res->second.begin(), res->second.end());
+void Parser::sortArray(int slot) const {
+  if (hasVariable[slot]) {
+    sort(variables[slot].begin(), variables[slot].end());
     return;
   }
-  throw meosException("Unknown symbol X#" + input);
+  throw meosException("Unknown symbol X#" + slotNames[slot]);
 }
 
-void Parser::storeVariable(const string &input, const vector<int> &value) const {  
-  if (symb.count(input))
-    throw meosException("Duplicate symbol X#" + input);
-  var[input] = value;
+void Parser::storeVariable(int slot, const vector<int> &value) const {  
+  if (getSymbol(slot))
+    throw meosException("Duplicate symbol X#" + slotNames[slot]);
+  variables[slot] = value;
+  hasVariable[slot] = true;
 }
 
-void Parser::storeVariable(const string &input, int value) const {
-  if (symb.count(input))
-    throw meosException("Duplicate symbol X#" + input);
-  vector<int> &iv = var[input];
+void Parser::storeVariable(int slot, int value) const {
+  if (getSymbol(slot))
+    throw meosException("Duplicate symbol X#" + slotNames[slot]);
+  vector<int> &iv = variables[slot];
   iv.resize(1);
   iv[0] = value;
+  hasVariable[slot] = true;
 }
 
-void Parser::storeVariable(const string &input, int index, int value) const {
-  if (symb.count(input))
-    throw meosException("Duplicate symbol X#" + input);
+void Parser::storeVariable(int slot, int index, int value) const {
+  if (getSymbol(slot))
+    throw meosException("Duplicate symbol X#" + slotNames[slot]);
   if (index < 0 || index>1024)
-    throw meosException("Index out of range for X.#" + input);
+    throw meosException("Index out of range for X.#" + slotNames[slot]);
 
-  vector<int> &iv = var[input];
+  vector<int> &iv = variables[slot];
+  if (!hasVariable[slot]) {
+    iv.clear();
+    hasVariable[slot] = true;
+  }
   if (iv.size() <= size_t(index))
     iv.resize(index+1);
   iv[index] = value;
@@ -957,7 +982,9 @@ Parser::ValueNode::~ValueNode() {
 }
 
 int Parser::ValueNode::evaluate(const Parser &parser) const {
-  return parser.evaluate(value);
+  if (isConstant)
+    return constant;
+  return parser.evaluate(slot);
 }
 bool Parser::ValueNode::isVariable() const {
   return value.length()>0 && isalpha(value[0]);
@@ -1015,17 +1042,17 @@ int Parser::BinaryOperatorNode::evaluate(const Parser &parser) const {
   case OpAssign: {
     ValueNode *vn = dynamic_cast<ValueNode *>(right);
     if (vn != 0) {
-      if (parser.isMatrix(vn->value))
+      if (parser.isMatrix(vn->slot))
         throw meosException("Cannot assign matrix X#"+vn->value);
-      if (parser.isVector(vn->value)) {
-        left->assignVector(parser, parser.getVector(vn->value, 0));
+      if (parser.isVector(vn->slot)) {
+        left->assignVector(parser, parser.getVector(vn->slot, 0));
         parser.ignoreValue = true;
         return -1;
       }
     }
     ArrayValueNode *avn = dynamic_cast<ArrayValueNode *>(right);
-    if (avn != 0 && parser.isMatrix(avn->expr) && avn->index2 == 0) {
-      left->assignVector(parser, parser.getVector(avn->expr, avn->index->evaluate(parser)));
+    if (avn != 0 && parser.isMatrix(avn->slot) && avn->index2 == 0) {
+      left->assignVector(parser, parser.getVector(avn->slot, avn->index->evaluate(parser)));
       parser.ignoreValue = true;
       return -1;
     }
@@ -1094,19 +1121,19 @@ int Parser::UnaryOperatorNode::evaluate(const Parser &parser) const {
     }
     case OpSize: {
        ValueNode &vn= dynamic_cast<ValueNode &>(*right);
-       return parser.evaluateSize(vn.value, 0);
+       return parser.evaluateSize(vn.slot, 0);
     }
     case OpSizeBase: {
        ValueNode &vn= dynamic_cast<ValueNode &>(*right);
-       return parser.evaluateSize(vn.value, -1);
+       return parser.evaluateSize(vn.slot, -1);
     }
     case OpSizeSub: {
       ArrayValueNode &vn= dynamic_cast<ArrayValueNode &>(*right);
-      return parser.evaluateSize(vn.expr, vn.index->evaluate(parser));
+      return parser.evaluateSize(vn.slot, vn.index->evaluate(parser));
     }
     case OpSortArray: {
        ValueNode &vn= dynamic_cast<ValueNode &>(*right);
-       parser.sortArray(vn.value);
+       parser.sortArray(vn.slot);
        parser.ignoreValue = true;
        return -1;
     }
@@ -1218,9 +1245,9 @@ Parser::ArrayValueNode::~ArrayValueNode() {
 
 int Parser::ArrayValueNode::evaluate(const Parser &parser) const {
   if (index2 == 0)
-    return parser.evaluate(expr, index->evaluate(parser), 0);
+    return parser.evaluate(slot, index->evaluate(parser), 0);
   else
-    return parser.evaluate(expr, index->evaluate(parser), index2->evaluate(parser));
+    return parser.evaluate(slot, index->evaluate(parser), index2->evaluate(parser));
 }
 
 bool Parser::ArrayValueNode::isVariable() const {
@@ -1236,11 +1263,11 @@ void ParseNode::assignVector(const Parser &parser, const vector<int> &value) con
 }
  
 void Parser::ValueNode::assign(const Parser &parser, int in_value) const {
-  parser.storeVariable(value, in_value);
+  parser.storeVariable(slot, in_value);
 }
 
 void Parser::ValueNode::assignVector(const Parser &parser, const vector<int> &in_value) const {
-  parser.storeVariable(value, in_value);
+  parser.storeVariable(slot, in_value);
 }
 
 
@@ -1248,140 +1275,158 @@ void Parser::ArrayValueNode::assign(const Parser &parser, int value) const {
   int ix2;
   if (index2 != 0 && (ix2 = index2->evaluate(parser)) != 0)
       throw meosException("Index X in Y is out of range.#" + itos(ix2) + "#" + expr); 
-  parser.storeVariable(expr, index->evaluate(parser), value);
+  parser.storeVariable(slot, index->evaluate(parser), value);
 }
 
 void Parser::ArrayValueNode::assignVector(const Parser &parser, const vector<int> &in_value) const {
   if (in_value.size() != 1)
     throw meosException("Vector cannot be assigned to X[i]#" + expr);
-  parser.storeVariable(expr, index->evaluate(parser), in_value[0]);
+  parser.storeVariable(slot, index->evaluate(parser), in_value[0]);
 }
 
 void Parser::declareSymbol(const char *name, const string &desc, 
                            bool isVector, bool isMatrix, bool deprecated) {
-  assert(symb.count(name) == 0 || (symb[name].isVector == isVector && symb[name].isMatrix == isMatrix));
-  symb[name].desc = desc;
-  symb[name].isVector = isVector;
-  symb[name].isMatrix = isMatrix;
-  symb[name].deprecated = deprecated;
+  Symbol &s = symbols[getSlot(name)];
+  assert(!s.declared || (s.isVector == isVector && s.isMatrix == isMatrix));
+  s.declared = true;
+  s.desc = desc;
+  s.isVector = isVector;
+  s.isMatrix = isMatrix;
+  s.deprecated = deprecated;
 }
 
-bool Parser::isMatrix(const string &input) const {
-  map<string, Symbol>::const_iterator res = symb.find(input);
-  return res != symb.end() && res->second.isMatrix;
+Parser::Symbol &Parser::getSymbolForUpdate(const char *name) {
+  Symbol &s = symbols[getSlot(name)];
+  assert(s.declared);
+  return s;
 }
 
-bool Parser::isVector(const string &input) const {
-  map<string, Symbol>::const_iterator res = symb.find(input);
-  if (res != symb.end()) 
-    return !res->second.isMatrix && res->second.value[0].size() != 1;
+bool Parser::isMatrix(int slot) const {
+  const Symbol *s = getSymbol(slot);
+  return s && s->isMatrix;
+}
 
-  map<string, vector<int> >::const_iterator resv = var.find(input);
-  return resv != var.end() && resv->second.size() != 1;
+bool Parser::isVector(int slot) const {
+  if (const Symbol *s = getSymbol(slot)) 
+    return !s->isMatrix && (s->value.empty() || s->value[0].size() != 1);
+
+  return hasVariable[slot] && variables[slot].size() != 1;
 }
 
-const vector<int> &Parser::getVector(const string &symbol, int index) const{
-  map<string, Symbol>::const_iterator res = symb.find(symbol);
-  if (res != symb.end()) {
-    if (size_t(index) < res->second.value.size())
-      return res->second.value[index];
+const vector<int> &Parser::getVector(int slot, int index) const{
+  if (const Symbol *s = getSymbol(slot)) {
+    if (size_t(index) < s->value.size())
+      return s->value[index];
     else
-      throw meosException("Index out of range for X.#" + symbol);
+      throw meosException("Index out of range for X.#" + slotNames[slot]);
   }
-  map<string, vector<int> >::const_iterator resv = var.find(symbol);
-  if (resv != var.end())
-    return resv->second;
+  if (hasVariable[slot])
+    return variables[slot];
 
-  throw meosException("Unknown symbol X#" + symbol);
+  throw meosException("Unknown symbol X#" + slotNames[slot]);
 }
 
 void Parser::addSymbol(const char *name, const string &value) {
-  assert(symb.count(name) && !symb[name].isVector);
-  symb[name].value.resize(1);
-  vector<int> &v = symb[name].value[0];
+  Symbol &s = getSymbolForUpdate(name);
+  assert(!s.isVector);
+  s.value.resize(1);
+  vector<int> &v = s.value[0];
   v.resize(1);
   v[0] = atoi(value.c_str());
 }
 
 void Parser::addSymbol(const char *name, int value) {
-  assert(symb.count(name) && !symb[name].isVector);
-  symb[name].value.resize(1);
-  vector<int> &v = symb[name].value[0];
+  Symbol &s = getSymbolForUpdate(name);
+  assert(!s.isVector);
+  s.value.resize(1);
+  vector<int> &v = s.value[0];
   v.resize(1);
   v[0] = value;
 }
 
 void Parser::addSymbol(const char *name, const vector<string> &value) {
-  assert(symb.count(name) && symb[name].isVector);
-  symb[name].value.resize(1);
-  vector<int> &v = symb[name].value[0];
+  Symbol &s = getSymbolForUpdate(name);
+  assert(s.isVector);
+  s.value.resize(1);
+  vector<int> &v = s.value[0];
   v.resize(value.size());
   for (size_t k = 0; k < value.size(); k++)
     v[k] = atoi(value[k].c_str());
 }
 
 void Parser::addSymbol(const char *name, const vector<int> &value) {
-  assert(symb.count(name) && symb[name].isVector);
-  symb[name].value.resize(1);
-  symb[name].value[0] = value;
+  Symbol &s = getSymbolForUpdate(name);
+  assert(s.isVector);
+  s.value.resize(1);
+  s.value[0] = value;
 }
 
 void Parser::addSymbol(const char *name, vector< vector<int> > &value) {
-  assert(symb.count(name) && symb[name].isVector);
-  symb[name].value.swap(value);
+  Symbol &s = getSymbolForUpdate(name);
+  assert(s.isVector);
+  s.value.swap(value);
 }
 
 void Parser::removeSymbol(const char *name) {
-  symb[name].value.clear();
+  int slot = findSlot(name);
+  if (slot != -1)
+    symbols[slot].value.clear();
 }
 
 void Parser::clearSymbols() {
-  symb.clear();
+  for (Symbol &s : symbols)
+    s = Symbol();
 }
 
 void Parser::clearVariables() const {
-  var.clear();
+  // Keep the allocated storage for the next evaluation
+  for (size_t k = 0; k < hasVariable.size(); k++) {
+    if (hasVariable[k]) {
+      variables[k].clear();
+      hasVariable[k] = false;
+    }
+  }
 }
 
 void Parser::takeVariable(const char*name, vector<int> &val) const {
-  map<string, vector<int> >::iterator resv = var.find(name);
-  if (resv != var.end()) {
-    vector<int> &res = resv->second;
-    val.swap(res);
-  }
+  int slot = findSlot(name);
+  if (slot != -1 && hasVariable[slot])
+    val.swap(variables[slot]);
   else
     val.clear();
 }
 
 void Parser::getSymbols(vector< pair<wstring, size_t> > &symbOut) const {
   int iter = 0;
-  for(auto it = symb.begin(); it != symb.end(); ++it) {
-    if (it->second.deprecated)
+  for(auto it = slots.begin(); it != slots.end(); ++it) {
+    const Symbol *s = getSymbol(it->second);
+    if (!s || s->deprecated)
       continue;
 
-    if (it->second.isMatrix)
-      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"[][]\t" + lang.tl(it->second.desc), iter++));
-    else if (it->second.isVector)
-      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"[]\t" + lang.tl(it->second.desc), iter++));
+    if (s->isMatrix)
+      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"[][]\t" + lang.tl(s->desc), iter++));
+    else if (s->isVector)
+      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"[]\t" + lang.tl(s->desc), iter++));
     else
-      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"\t" + lang.tl(it->second.desc), iter++));
+      symbOut.push_back(make_pair(gdi_main->widen(it->first) + L"\t" + lang.tl(s->desc), iter++));
   }
 }
 
 void Parser::getSymbolInfo(int ix, wstring &name, wstring &desc) const {
   int iter = 0;
-  for(auto it = symb.begin(); it != symb.end(); ++it) {
-    if (it->second.deprecated)
+  for(auto it = slots.begin(); it != slots.end(); ++it) {
+    const Symbol *s = getSymbol(it->second);
+    if (!s || s->deprecated)
       continue;
 
     if (ix == iter++) {
-      if (it->second.isMatrix)
+      if (s->isMatrix)
         name = gdi_main->widen(it->first) + L"[][]";
-      else if (it->second.isVector)
+      else if (s->isVector)
         name = gdi_main->widen(it->first) + L"[]";
       else
         name = gdi_main->widen(it->first);
-      desc = gdi_main->widen(it->second.desc);
+      desc = gdi_main->widen(s->desc);
 
       return;
     }
@@ -1572,11 +1617,21 @@ void Parser::test() {
   catch (const meosException &) {
   }
 
+  try {
+    parser.evaluate(parser.getSlot(""));
+    assertEq(0,1);
+  }
+  catch (const meosException &ex) {
+    if (ex.wwhat() != L"Empty expression")
+      assertEq(0,2);
+  }
 }
 
 void Parser::dumpVariables(gdioutput &gdi, int c1, int c2) const {
-  for (map<string, vector<int> >::iterator it = var.begin(); it != var.end(); ++it) {
-    const vector<int> &v = it->second;
+  for (auto it = slots.begin(); it != slots.end(); ++it) {
+    if (!hasVariable[it->second])
+      continue;
+    const vector<int> &v = variables[it->second];
     string val;
     if (v.size() == 1) {
       val = itos(v[0]);
@@ -1597,8 +1652,11 @@ void Parser::dumpVariables(gdioutput &gdi, int c1, int c2) const {
 }
 
 void Parser::dumpSymbols(gdioutput &gdi, int c1, int c2) const {
-  for (map<string, Symbol>::const_iterator it = symb.begin(); it != symb.end(); ++it) {
-    const vector< vector<int> > &v = it->second.value;
+  for (auto it = slots.begin(); it != slots.end(); ++it) {
+    const Symbol *s = getSymbol(it->second);
+    if (!s)
+      continue;
+    const vector< vector<int> > &v = s->value;
     if (v.empty())
       continue;
 
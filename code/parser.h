@@ -98,14 +98,28 @@ class Parser {
 
   struct Symbol {
     string desc;
-    bool isVector;
-    bool isMatrix;
+    bool declared = false;
+    bool isVector = false;
+    bool isMatrix = false;
     bool deprecated = false;
     vector<vector<int>> value;
   };
 
-  map<string, Symbol> symb;
-  mutable map<string, vector<int>> var;
+  // Each name used as a symbol or variable is given a slot when parsed, so that
+  // evaluation does not need to look up names. Slots are never removed, which keeps
+  // parsed methods valid when symbols are cleared and declared again.
+  map<string, int> slots;
+  vector<string> slotNames;
+  vector<Symbol> symbols;
+  mutable vector<vector<int>> variables;
+  mutable vector<bool> hasVariable;
+
+  int getSlot(const string &name);
+  int findSlot(const string &name) const;
+  const Symbol *getSymbol(int slot) const {
+    return symbols[slot].declared ? &symbols[slot] : nullptr;
+  }
+  Symbol &getSymbolForUpdate(const char *name);
 
   mutable int breakMode;
   mutable bool returnMode;
@@ -131,6 +145,9 @@ class Parser {
 
   class ValueNode : public ParseNode {
     string value;
+    int slot = -1;
+    bool isConstant = false;
+    int constant = 0;
     ValueNode(const ValueNode&) = delete;
     ValueNode &operator=(const ValueNode &) = delete;
 
@@ -147,6 +164,7 @@ class Parser {
 
   class ArrayValueNode : public ParseNode {
     string expr;
+    int slot = -1;
     ParseNode *index;
     ParseNode *index2;    
     ArrayValueNode(const ArrayValueNode&) = delete;
@@ -242,15 +260,15 @@ class Parser {
   };
 
 
-  int evaluate(const string &input) const;
-  int evaluate(const string &input, int index, int index2) const;
-  int evaluateSize(const string &input, int index) const;
-  void sortArray(const string &input) const;
+  int evaluate(int slot) const;
+  int evaluate(int slot, int index, int index2) const;
+  int evaluateSize(int slot, int index) const;
+  void sortArray(int slot) const;
 
   
-  void storeVariable(const string &input, const vector<int> &value) const;
-  void storeVariable(const string &input, int value) const;
-  void storeVariable(const string &input, int index, int value) const;
+  void storeVariable(int slot, const vector<int> &value) const;
+  void storeVariable(int slot, int value) const;
+  void storeVariable(int slot, int index, int value) const;
 
   UnaryOperatorNode *getUnary();
   BinaryOperatorNode *getBinary();
@@ -270,10 +288,10 @@ class Parser {
   string parseMethod(const string &expr, size_t &pos);
 
   vector<ParseNode *> nodes;
-  bool isMatrix(const string &symbol) const;
-  bool isVector(const string &symbol) const;
+  bool isMatrix(int slot) const;
+  bool isVector(int slot) const;
 
-  const vector<int> &getVector(const string &symbol, int index) const;
+  const vector<int> &getVector(int slot, int index) const;
 public:
   ParseNode *parse(const string &expr);
   static void test();
@@ -38,6 +38,7 @@ Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
 #include "TabList.h"
 #include "generalresult.h"
 #include "HTMLWriter.h"
+#include "listsink.h"
 #include "RunnerDB.h"
 #include "image.h"
 #include "cardsystem.h"
@@ -69,7 +70,7 @@ void RestServer::remove(shared_ptr<RestServer> server) {
   }
 }
 
-RestServer::RestServer() : hasAnyRequest(false) {
+RestServer::RestServer() : hasAnyRequest(false), publishedRevision(-1), mainThreadId(0) {
 }
 
 RestServer::~RestServer() {
@@ -107,7 +108,9 @@ void RestServer::handleRequest(const shared_ptr<restbed::Session> &session) {
     param = rootMap;
   }
 
-  auto answer = RestServer::addRequest(param);
+  auto answer = getCachedAnswer(param);
+  if (!answer)
+    answer = RestServer::addRequest(param);
   {
     unique_lock<mutex> mlock(lock);
     if (!waitForCompletion.wait_for(mlock, 10s, [answer] {return answer->isCompleted(); })) {
@@ -122,9 +125,12 @@ void RestServer::handleRequest(const shared_ptr<restbed::Session> &session) {
   session->fetch(content_length, [request, answer](const shared_ptr< Session > session, const Bytes & body)
   {
     if (answer->image.empty()) {
-      session->close(restbed::OK, answer->answer, { { "Content-Length", itos(answer->answer.length()) },
-                                                    { "Connection", "close" },
-                                                    { "Access-Control-Allow-Origin", "*" } });
+      multimap<string, string> headers = { { "Content-Length", itos(answer->answer.length()) },
+                                           { "Connection", "close" },
+                                           { "Access-Control-Allow-Origin", "*" } };
+      if (!answer->contentType.empty())
+        headers.emplace("Content-Type", answer->contentType);
+      session->close(restbed::OK, answer->answer, headers);
     }
     else {
       session->close(restbed::OK, answer->image, { { "Content-Type", "image/png"},
@@ -138,6 +144,8 @@ void RestServer::handleRequest(const shared_ptr<restbed::Session> &session) {
 void RestServer::startThread(int port) {
   auto settings = make_shared<Settings>();
   settings->set_port(port);
+  // Several workers, so that cached answers are not blocked by requests waiting for the main thread
+  settings->set_worker_limit(max(2u, min(8u, thread::hardware_concurrency())));
   auto resource = make_shared<MeOSResource>(this);
   resource->set_path("/meos");
   
@@ -194,28 +202,108 @@ void RestServer::computeRequested(oEvent &ref) {
 }
 
 void RestServer::compute(oEvent &ref) {
-  auto rq = getRequest();
-  if (!rq)
-    return;
+  mainThreadId = GetCurrentThreadId();
+  publishedRevision = ref.getRevision();
 
-  try {
-    computeInternal(ref, rq);
-  }
-  catch (meosException &ex) {
-    rq->answer = "Error (MeOS): Error: " + ref.gdiBase().toUTF8(lang.tl(ex.wwhat()));
+  // Answer all pending requests. Identical read-only requests are computed once.
+  while (auto rq = getRequest()) {
+    auto cached = getCachedAnswer(rq->parameters);
+    if (cached) {
+      rq->answer = cached->answer;
+      rq->contentType = cached->contentType;
+      rq->image = cached->image;
+    }
+    else {
+      bool ok = false;
+      try {
+        computeInternal(ref, rq);
+        ok = true;
+      }
+      catch (meosException &ex) {
+        rq->answer = "Error (MeOS): Error: " + ref.gdiBase().toUTF8(lang.tl(ex.wwhat()));
+      }
+      catch (std::exception &ex) {
+        rq->answer = "Error (MeOS): General Error: " + string(ex.what());
+      }
+      catch (...) {
+        rq->answer = "Error (MeOS): Unknown internal error.";
+      }
+
+      if (ok && isCacheable(rq->parameters))
+        cacheAnswer(rq);
+      else {
+        // The request may have modified the competition. Later requests, in this loop
+        // or answered from the cache by the server threads, must not get older answers.
+        long revision = ref.getRevision();
+        lock_guard<mutex> lg(lock);
+        if (revision != publishedRevision || rq->parameters.count("entry") > 0)
+          answerCache.clear();
+        publishedRevision = revision;
+      }
+    }
+
+    {
+      lock_guard<mutex> lg(lock);
+      rq->state = true;
+    }
+    waitForCompletion.notify_all();
   }
-  catch (std::exception &ex) {
-    rq->answer = "Error (MeOS): General Error: " + string(ex.what());
+}
+
+bool RestServer::isCacheable(const multimap<string, string> &param) {
+  // Requests that modify the competition or depend on the state of the client.
+  // An entry is handled before get/html if both are given.
+  for (const char *key : { "entry", "difference" }) {
+    if (param.count(key) > 0)
+      return false;
   }
-  catch (...) {
-    rq->answer = "Error (MeOS): Unknown internal error.";
+
+  // Only data and list requests that do not modify the competition
+  return param.count("get") > 0 || param.count("html") > 0;
+}
+
+/** Maximal age of a cached answer. Lists and results may also depend on current time. */
+static constexpr uint64_t maxCachedAnswerAgeMs = 2000;
+
+/** IOF exports only depend on competition data and are valid until the data changes */
+static bool isRevisionOnly(const multimap<string, string> &param) {
+  auto res = param.find("get");
+  return res != param.end() && (res->second == "iofresult" || res->second == "iofstart");
+}
+
+shared_ptr<RestServer::EventRequest> RestServer::getCachedAnswer(const multimap<string, string> &param) {
+  if (!isCacheable(param))
+    return nullptr;
+
+  lock_guard<mutex> lg(lock);
+  auto res = answerCache.find(param);
+  if (res == answerCache.end())
+    return nullptr;
+
+  if (res->second.revision != publishedRevision || 
+      (!isRevisionOnly(param) && GetTickCount64() > res->second.computedTime + maxCachedAnswerAgeMs)) {
+    answerCache.erase(res);
+    return nullptr;
   }
 
-  {
-    lock_guard<mutex> lg(lock);
-    rq->state = true;
+  return res->second.request;
+}
+
+void RestServer::cacheAnswer(const shared_ptr<EventRequest> &rq) {
+  uint64_t now = GetTickCount64();
+  lock_guard<mutex> lg(lock);
+  for (auto it = answerCache.begin(); it != answerCache.end();) {
+    if (it->second.revision != publishedRevision || 
+        (!isRevisionOnly(it->first) && now > it->second.computedTime + maxCachedAnswerAgeMs))
+      it = answerCache.erase(it);
+    else
+      ++it;
   }
-  waitForCompletion.notify_all();
+
+  auto &ca = answerCache[rq->parameters];
+  ca.revision = publishedRevision;
+  ca.computedTime = now;
+  ca.request = rq;
 }
 
 extern wchar_t programPath[MAX_PATH];
@@ -263,7 +351,10 @@ void RestServer::computeInternal(oEvent &ref, shared_ptr<RestServer::EventReques
         listCache[keyCand].second.reset();
       }
 
-      rq->answer += "<li><a href=\"?html=1&type=" + itos(keyCand) + "\">" + ref.gdiBase().toUTF8(n) + "</a></li>\n";
+      string link = "?html=1&type=" + itos(keyCand);
+      rq->answer += "<li><a href=\"" + link + "\">" + ref.gdiBase().toUTF8(n) + "</a> "
+                    "(<a href=\"" + link + "&format=csv\">CSV</a>, "
+                    "<a href=\"" + link + "&format=json\">JSON</a>)</li>\n";
     }
     //  "<li><a href=\"?html=1&result=1\">Resultat</a></li>"
     //  "<li><a href=\"?html=1&startlist=1\">Startlista</a></li>"
@@ -385,13 +476,7 @@ void RestServer::computeInternal(oEvent &ref, shared_ptr<RestServer::EventReques
   }
   else if (rq->parameters.count("difference")) {
     string what = rq->parameters.find("difference")->second;
-    int id = -2;
-    if (what == "zero")
-      id = -1;
-    else
-      id = atoi(what.c_str());
-
-    difference(ref, id, rq->answer);
+    mopDifference(ref, what, rq->answer);
   }
   else if (rq->parameters.count("page") > 0) {
     string what = rq->parameters.find("page")->second;
@@ -460,10 +545,29 @@ void RestServer::computeInternal(oEvent &ref, shared_ptr<RestServer::EventReques
         res->second.second = make_shared<oListInfo>();
         ref.generateListInfo(gdiPrint, res->second.first, *res->second.second);
       }
-      ref.generateList(gdiPrint, true, *res->second.second, false);
-      //wstring exportFile = getTempFile();
+      // Formats other than the default HTML page are streamed without layout
+      string format = rq->parameters.count("format") ? rq->parameters.find("format")->second : _EmptyString;
       ostringstream fout;
-      HTMLWriter::write(gdiPrint, fout, ref.getName(), 30, res->second.first, ref);
+      if (format == "csv") {
+        CSVListSink sink(fout);
+        ref.generateList(sink, true, *res->second.second);
+        rq->contentType = "text/csv; charset=utf-8";
+      }
+      else if (format == "json") {
+        JSONListSink sink(fout);
+        ref.generateList(sink, true, *res->second.second);
+        rq->contentType = "application/json; charset=utf-8";
+      }
+      else if (format == "table") {
+        HTMLListSink sink(fout);
+        ref.generateList(sink, true, *res->second.second);
+        rq->contentType = "text/html; charset=utf-8";
+      }
+      else {
+        ref.generateList(gdiPrint, true, *res->second.second, false);
+        //wstring exportFile = getTempFile();
+        HTMLWriter::write(gdiPrint, fout, ref.getName(), 30, res->second.first, ref);
+      }
       rq->answer = fout.str();
       //ifstream fin(exportFile.c_str());
       /*string rbf;
@@ -537,38 +641,24 @@ void RestServer::getData(oEvent &oe, const string &what, const multimap<string,
   out.setComplete(true);
   bool okRequest = false;
   if (what == "iofresult") {
-    wstring exportFile = getTempFile();
     bool useUTC = false;
     set<int> cls;
     if (param.count("class") > 0)
       getSelection(param.find("class")->second, cls);
     tuple<string, string, bool> preferredIdTypes("", "", true);
 
-    oe.exportIOFSplits(oEvent::IOF30, exportFile.c_str(), false, useUTC, cls, preferredIdTypes, L"",
+    oe.exportIOFSplits(oEvent::IOF30, answer, false, useUTC, cls, preferredIdTypes, L"",
                        - 1, true, false, false, true, false, false);
-    ifstream fin(exportFile.c_str());
-    string rbf;
-    while (std::getline(fin, rbf)) {
-      answer += rbf;
-    }
-    removeTempFile(exportFile);
     okRequest = true;
   }
   else if (what == "iofstart") {
-    wstring exportFile = getTempFile();
     bool useUTC = false;
     set<int> cls;
     if (param.count("class") > 0)
       getSelection(param.find("class")->second, cls);
     tuple<string, string, bool> preferredIdTypes("","",true);
 
-    oe.exportIOFStartlist(oEvent::IOF30, exportFile.c_str(), useUTC, cls, preferredIdTypes, false, true, false, false);
-    ifstream fin(exportFile.c_str());
-    string rbf;
-    while (std::getline(fin, rbf)) {
-      answer += rbf;
-    }
-    removeTempFile(exportFile);
+    oe.exportIOFStartlist(oEvent::IOF30, answer, useUTC, cls, preferredIdTypes, false, true, false, false);
     okRequest = true;
   }
   else if (what == "competition") {
@@ -1077,9 +1167,16 @@ shared_ptr<RestServer::EventRequest> RestServer::getRequest() {
 shared_ptr<RestServer::EventRequest> RestServer::addRequest(multimap<string, string> &param) {
   auto rq = make_shared<EventRequest>();
   rq->parameters.swap(param);
-  lock_guard<mutex> lg(lock);
-  requests.push_back(rq);
-  hasAnyRequest = true;
+  {
+    lock_guard<mutex> lg(lock);
+    requests.push_back(rq);
+    hasAnyRequest = true;
+  }
+  // Wake up the main message loop
+  DWORD threadId = mainThreadId;
+  if (threadId != 0)
+    PostThreadMessage(threadId, WM_NULL, 0, 0);
+
   return rq;
 }
 
@@ -1564,8 +1661,10 @@ int RestServer::InfoServerContainer::getNextInstanceId() {
 }
 
 int RestServer::getNewInstanceId() {
-  int limit = 10;
-  if (isContainers.size() > 10) {
+  // A client only keeps a position in the shared MOP log. The limit is
+  // given by the number of base ids.
+  constexpr size_t maxInstances = smallPrime - 1;
+  if (isContainers.size() >= maxInstances) {
     isContainers.pop_back();
   }
 
@@ -1596,7 +1695,56 @@ int RestServer::getNewInstanceId() {
   throw meosException("No server instance found");
 }
 
-xmlbuffer * RestServer::getMOPXML(oEvent &oe, int id, int &nextId) {
+void RestServer::synchronizeMOP(oEvent &oe) {
+  oe.autoSynchronizeLists(true);
+  if (mopModel && mopRevision == oe.getRevision())
+    return;
+
+  set<int> classes;
+  vector<pClass> cls;
+  oe.getClasses(cls, false);
+  for (pClass pc : cls) {
+    if (!pc->isQualificationFinalBaseClass())
+      classes.insert(pc->getId());
+  }
+
+  set<int> controls;
+  vector<pControl> ctrl;
+  vector<int> ids;
+  oe.getControls(ctrl, true);
+  for (size_t k = 0; k < ctrl.size(); k++) {
+    if (ctrl[k]->isValidRadio()) {
+      ctrl[k]->getCourseControls(ids);
+      controls.insert(ids.begin(), ids.end());
+    }
+  }
+
+  if (!mopModel)
+    mopModel = make_shared<InfoCompetition>(0);
+
+  mopModel->synchronize(oe, L"", InfoCompetition::SynchType::All, classes, controls, controls, true);
+  auto diff = make_shared<xmlbuffer>();
+  mopModel->getDiffXML(*diff);
+  mopModel->commitComplete();
+  mopRevision = oe.getRevision();
+
+  if (diff->isComplete()) {
+    // Not expressible as a difference (e.g. deletions). Restart the log,
+    // so that all clients get the complete competition next time.
+    mopLog.clear();
+    mopLogHead++;
+    mopComplete.reset();
+    mopCompletePosition = -1;
+  }
+  else if (diff->size() > 0) {
+    mopLog.push_back(diff);
+    mopLogHead++;
+    if (mopLog.size() > maxMOPLogSize)
+      mopLog.pop_front();
+  }
+}
+
+const vector<shared_ptr<xmlbuffer>> *RestServer::getMOPXML(oEvent &oe, int id, int &nextId) {
   for (auto it = isContainers.begin(); it != isContainers.end(); ++it) {
     auto &c = *it;
     if (c.thisInstanceId == id) {
@@ -1604,71 +1752,72 @@ xmlbuffer * RestServer::getMOPXML(oEvent &oe, int id, int &nextId) {
       if (it != isContainers.begin())
         isContainers.splice(isContainers.begin(), isContainers, it);
 
-      return c.lastData.get();
+      return &c.lastData;
     }
     else if (c.nextInstanceId == id) {
       if (it != isContainers.begin())
         isContainers.splice(isContainers.begin(), isContainers, it);
 
-      oe.autoSynchronizeLists(true);
-      if (!c.cmpModel) {
-        c.cmpModel = make_shared<InfoCompetition>(id);
-        if (c.classes.empty()) {
-          vector<pClass> classes;
-          oe.getClasses(classes, false);
-          for (pClass pc : classes) {
-            if (!pc->isQualificationFinalBaseClass())
-              c.classes.insert(pc->getId());
-          }
-        }
-        if (c.controls.empty()) {
-          vector<pControl> ctrl;
-          vector<int> ids;
-          oe.getControls(ctrl, true);
-          for (size_t k = 0; k < ctrl.size(); k++) {
-            if (ctrl[k]->isValidRadio()) {
-              ctrl[k]->getCourseControls(ids);
-              c.controls.insert(ids.begin(), ids.end());
-            }
-          }
+      synchronizeMOP(oe);
+      c.lastData.clear();
+      const int64_t logStart = mopLogHead - int64_t(mopLog.size());
+      if (c.logPosition < logStart) {
+        // New client, or too far behind: send the complete competition
+        if (mopCompletePosition != mopLogHead || !mopComplete) {
+          mopComplete = make_shared<xmlbuffer>();
+          mopModel->getCompleteXML(*mopComplete);
+          mopCompletePosition = mopLogHead;
         }
+        c.lastData.push_back(mopComplete);
+      }
+      else {
+        for (int64_t pos = c.logPosition; pos < mopLogHead; pos++)
+          c.lastData.push_back(mopLog[size_t(pos - logStart)]);
       }
-      c.cmpModel->synchronize(oe, L"", InfoCompetition::SynchType::All, c.classes, c.controls, c.controls, true);
-      c.lastData = make_shared<xmlbuffer>();
-      c.cmpModel->getDiffXML(*c.lastData);
-      c.cmpModel->commitComplete();
+      c.logPosition = mopLogHead;
 
-      if (c.lastData->size() == 0) {
+      if (c.lastData.empty()) {
         nextId = c.nextInstanceId;
-        return c.lastData.get(); 
+        return &c.lastData; 
       }
 
       c.thisInstanceId = id;
       nextId = c.nextInstanceId = c.getNextInstanceId();
-      return c.lastData.get();
+      return &c.lastData;
     }
   }
   return nullptr;
 }
 
+void RestServer::mopDifference(oEvent &oe, const string &what, string &answer) {
+  int id = -2;
+  if (what == "zero")
+    id = -1;
+  else
+    id = atoi(what.c_str());
+
+  difference(oe, id, answer);
+}
+
 void RestServer::difference(oEvent &oe, int id, string &answer) {
   string type;
   if (id == -1) {
     id = getNewInstanceId();
   }
   int nextId;
-  xmlbuffer *bf = getMOPXML(oe, id, nextId);
-  if (bf) {
+  auto data = getMOPXML(oe, id, nextId);
+  if (data) {
     xmlparser mem;
     mem.openMemoryOutput(false);
-    if (bf->isComplete())
+    if (data->size() == 1 && data->front()->isComplete())
       type = "MOPComplete";
     else
       type = "MOPDiff";
 
     mem.startTag(type.c_str(), { L"xmlns", L"http://www.melin.nu/mop",
                                  L"nextdifference", itow(nextId)});
-    bf->commitCopy(mem);
+    for (auto &bf : *data)
+      bf->commitCopy(mem);
     mem.endTag();
     mem.getMemoryOutput(answer);
   }
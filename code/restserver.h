@@ -53,6 +53,7 @@ private:
     EventRequest() : state(false) {}
     multimap<string, string> parameters;
     string answer;
+    string contentType; // Empty if not specified
     vector<uint8_t> image;
     std::atomic_bool state; //false - asked, true - answerd
 
@@ -71,6 +72,22 @@ private:
   std::condition_variable waitForCompletion;
 
   deque<shared_ptr<EventRequest>> requests;
+
+  struct CachedAnswer {
+    long revision;
+    uint64_t computedTime;
+    shared_ptr<EventRequest> request;
+  };
+
+  // Computed answers to read-only requests, by request parameters
+  map<multimap<string, string>, CachedAnswer> answerCache;
+  // Data revision of the event, as last seen by the main thread
+  std::atomic<long> publishedRevision;
+  std::atomic<DWORD> mainThreadId;
+
+  static bool isCacheable(const multimap<string, string> &param);
+  shared_ptr<EventRequest> getCachedAnswer(const multimap<string, string> &param);
+  void cacheAnswer(const shared_ptr<EventRequest> &rq);
   void getData(oEvent &ref, const string &what, const multimap<string, string> &param, string &answer);
   void lookup(oEvent &ref, const string &what, const multimap<string, string> &param, string &answer);
   
@@ -111,10 +128,10 @@ private:
     const int instanceIncrementor;
     int thisInstanceId = -1;
     int nextInstanceId;
-    shared_ptr<InfoCompetition> cmpModel;
-    shared_ptr<xmlbuffer> lastData;
-    set<int> classes;
-    set<int> controls;
+    // Position in the shared MOP change log, -1 before the complete competition is sent
+    int64_t logPosition = -1;
+    // Data sent for thisInstanceId, resent if the client repeats the request
+    vector<shared_ptr<xmlbuffer>> lastData;
 
     InfoServerContainer(int s, int e) : nextInstanceId(s), instanceIncrementor(e) {}
   };
@@ -122,7 +139,20 @@ private:
   shared_ptr<std::default_random_engine> randGen;
   list<InfoServerContainer> isContainers;
   int getNewInstanceId();
-  xmlbuffer *getMOPXML(oEvent &oe, int id, int &nextId);
+
+  // MOP model shared by all difference clients. Each synchronization that changes 
+  // the model appends its difference to the log; clients receive the log entries 
+  // after their position.
+  shared_ptr<InfoCompetition> mopModel;
+  long mopRevision = -1;
+  int64_t mopLogHead = 0;
+  deque<shared_ptr<xmlbuffer>> mopLog;
+  shared_ptr<xmlbuffer> mopComplete;
+  int64_t mopCompletePosition = -1;
+  static constexpr size_t maxMOPLogSize = 256;
+
+  void synchronizeMOP(oEvent &oe);
+  const vector<shared_ptr<xmlbuffer>> *getMOPXML(oEvent &oe, int id, int &nextId);
 
   void difference(oEvent &oe, int id, string &answer);
 
@@ -137,6 +167,9 @@ public:
   static void remove(shared_ptr<RestServer> server);
   static void computeRequested(oEvent &ref);
 
+  /** Answer a MOP difference request: "zero" for the complete competition, or the nextdifference id. */
+  void mopDifference(oEvent &oe, const string &what, string &answer);
+
   void setEntryPermission(EntryPermissionClass epClass, EntryPermissionType epType);
 
   static void newEntryErrorCheck(oEvent &oe,
@@ -0,0 +1,158 @@
+﻿/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License fro more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+#include "stdafx.h"
+#include <algorithm>
+
+#include "oEvent.h"
+#include "meos_util.h"
+#include "runnersearch.h"
+
+void RunnerSearchIndex::clear() {
+  entries.clear();
+  idToEntry.clear();
+  trigrams.clear();
+  numbers.clear();
+  revision = -1;
+}
+
+void RunnerSearchIndex::update(const oEvent &oe) {
+  if (revision == oe.getRevision())
+    return;
+
+  revision = oe.getRevision();
+  vector<Entry> newEntries;
+  newEntries.reserve(oe.Runners.size());
+  bool changed = false;
+
+  for (auto &r : oe.Runners) {
+    if (r.skip())
+      continue;
+
+    Entry *old = nullptr;
+    auto res = idToEntry.find(r.getId());
+    if (res != idToEntry.end() && entries[res->second].runner == &r)
+      old = &entries[res->second];
+
+    if (!old || res->second != int(newEntries.size()))
+      changed = true; // Added, removed or moved runner
+
+    newEntries.emplace_back();
+    Entry &e = newEntries.back();
+    e.runner = pRunner(&r);
+    e.id = r.getId();
+    e.startNo = r.getStartNo();
+    e.cardNo = r.getCardNo();
+    if (old && old->name == r.getName()) {
+      swap(e.name, old->name);
+      swap(e.key, old->key);
+    }
+    else {
+      e.name = r.getName();
+      e.key = e.name;
+      if (!e.key.empty())
+        prepareMatchString(&e.key[0], e.key.length());
+      changed = true;
+    }
+
+    if (old && (old->startNo != e.startNo || old->cardNo != e.cardNo))
+      changed = true;
+  }
+
+  if (newEntries.size() != entries.size())
+    changed = true;
+
+  swap(entries, newEntries);
+  if (changed)
+    rebuildLookup();
+}
+
+void RunnerSearchIndex::rebuildLookup() {
+  idToEntry.clear();
+  trigrams.clear();
+  numbers.clear();
+
+  idToEntry.reserve(entries.size());
+  numbers.reserve(entries.size() * 2);
+  for (size_t k = 0; k < entries.size(); k++) {
+    const Entry &e = entries[k];
+    idToEntry[e.id] = k;
+
+    const wstring &key = e.key;
+    for (size_t j = 0; j + 3 <= key.length(); j++) {
+      vector<int> &post = trigrams[trigram(key.c_str() + j)];
+      if (post.empty() || post.back() != int(k))
+        post.push_back(k);
+    }
+
+    if (e.startNo > 0)
+      numbers.emplace_back(itow(e.startNo), k);
+    if (e.cardNo > 0)
+      numbers.emplace_back(itow(e.cardNo), k);
+  }
+  sort(numbers.begin(), numbers.end());
+}
+
+void RunnerSearchIndex::find(const oEvent &oe, const wstring &s, vector<oRunner *> &out) {
+  update(oe);
+  out.clear();
+
+  wstring trm = trim(s);
+  if (_wtoi(trm.c_str()) > 0) {
+    vector<int> match;
+    auto it = lower_bound(numbers.begin(), numbers.end(), make_pair(trm, -1));
+    for (; it != numbers.end() && it->first.compare(0, trm.length(), trm) == 0; ++it)
+      match.push_back(it->second);
+
+    sort(match.begin(), match.end());
+    match.erase(unique(match.begin(), match.end()), match.end());
+    for (int ix : match)
+      out.push_back(entries[ix].runner);
+    return;
+  }
+
+  wstring q = s;
+  if (!q.empty())
+    prepareMatchString(&q[0], q.length());
+
+  if (q.length() < 3) {
+    for (auto &e : entries) {
+      if (wcsstr(e.key.c_str(), q.c_str()))
+        out.push_back(e.runner);
+    }
+    return;
+  }
+
+  // Use the rarest trigram of the query to select candidates
+  const vector<int> *best = nullptr;
+  for (size_t j = 0; j + 3 <= q.length(); j++) {
+    auto res = trigrams.find(trigram(q.c_str() + j));
+    if (res == trigrams.end())
+      return; // No runner has this trigram
+    if (!best || res->second.size() < best->size())
+      best = &res->second;
+  }
+
+  for (int ix : *best) {
+    if (wcsstr(entries[ix].key.c_str(), q.c_str()))
+      out.push_back(entries[ix].runner);
+  }
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License fro more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class oEvent;
+class oRunner;
+
+/** Index for finding runners by (part of) name, start number or card number.
+    Updated lazily when the competition has changed; only runners that were
+    added, renamed or renumbered are reindexed. */
+class RunnerSearchIndex {
+  struct Entry {
+    oRunner *runner = nullptr;
+    int id = 0;
+    wstring name; // Name as indexed, to detect changes
+    wstring key; // Normalized name
+    int startNo = 0;
+    int cardNo = 0;
+  };
+
+  vector<Entry> entries;
+  unordered_map<int, int> idToEntry;
+  // Trigram of normalized name -> entries (in increasing order)
+  unordered_map<uint64_t, vector<int>> trigrams;
+  // Start and card numbers as text, sorted for prefix search
+  vector<pair<wstring, int>> numbers;
+  long revision = -1;
+
+  static uint64_t trigram(const wchar_t *s) {
+    return (uint64_t(s[0]) << 32) | (uint64_t(s[1]) << 16) | uint64_t(s[2]);
+  }
+
+  void update(const oEvent &oe);
+  void rebuildLookup();
+
+public:
+  /** Find runners matching the search string. A string starting with a number is matched
+      as a prefix of start or card numbers; other strings are matched as part of the name.
+      The matching runners are returned in competition order. */
+  void find(const oEvent &oe, const wstring &s, vector<oRunner *> &out);
+
+  /** Mark as outdated, for local changes not yet synchronized (no new revision). */
+  void invalidate() { revision = -1; }
+
+  void clear();
+};
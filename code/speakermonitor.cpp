@@ -52,6 +52,7 @@ SpeakerMonitor::~SpeakerMonitor() {
 void SpeakerMonitor::setClassFilter(const set<int> &filter, const set<int> &cfilter) {
   classFilter = filter;
   controlIdFilter = cfilter;
+  resultRevision = -1;
   oListInfo li;
   maxClassNameWidth = oe.gdiBase().scaleLength(li.getMaxCharWidth(oe, classFilter, EPostType::lClassName, -1, L"", gdiFonts::normalText));
 }
@@ -66,14 +67,9 @@ bool orderResultsInTime(const oEvent::ResultEvent &a,
   if (a.time != b.time)
     return a.time > b.time;
  
-  if (a.time > 0) {
-    const wstring &na = a.r->getName();
-    const wstring &nb = b.r->getName();
-  
-    return CompareString(LOCALE_USER_DEFAULT, 0,
-                          na.c_str(), na.length(),
-                          nb.c_str(), nb.length()) == CSTR_LESS_THAN;
-  }
+  if (a.time > 0)
+    return a.r->getNameSortKey() < b.r->getNameSortKey();
+
   return a.r->getId() < b.r->getId();
 }
 
@@ -84,8 +80,68 @@ void SpeakerMonitor::show(gdioutput &gdi) {
   extraWidth = gdi.scaleLength(200);
   dash = makeDash(L"- ");
 
-  oe.getResultEvents(classFilter, controlIdFilter, results);
-  calculateResults();
+  updateResults();
+
+  int order = 0;
+  for (size_t k = 0; k < results.size() && (order < numLimit || numLimit == 0); k++) {
+    if (results[k].time > 0) {
+      oEvent::ResultEvent *ahead = 0, *behind = 0;
+
+      if (results[k].status == StatusOK)
+        ahead = k > 0 && sameResultPoint(results[k], results[k-1]) ? &results[k-1] : 0;
+      if (results[k].status == StatusOK)
+        behind = (k + 1) < results.size() && sameResultPoint(results[k], results[k+1]) ? &results[k+1] : 0;
+
+      renderResult(gdi, ahead, results[k], behind, order, true);
+    }
+  }
+
+  for (size_t k = 0; k < results.size() && (order < numLimit || numLimit == 0); k++) {
+    if (results[k].time == 0)
+      renderResult(gdi, 0, results[k], 0, order, false);
+    else
+      break;
+  }
+}
+
+bool SpeakerMonitor::updateResults() {
+  if (resultRevision == oe.getRevision())
+    return false;
+
+  // Events depend only on runners and teams of the own class. Recalculate the classes
+  // with changes, or all classes after a change that may affect any class.
+  set<int> changed;
+  if (resultRevision == -1 || oe.getGlobalResultRevision() > (unsigned long)resultRevision) {
+    classResults.clear();
+    totalLeaderTimes.clear();
+    firstTimes.clear();
+    dynamicTotalLeaderTimes.clear();
+    runnerToTimeKey.clear();
+    changed = classFilter;
+  }
+  else {
+    for (int c : classFilter) {
+      pClass cls = oe.getClass(c);
+      if (cls && cls->getResultChangeRevision() > (unsigned long)resultRevision) {
+        clearClassResults(c);
+        changed.insert(c);
+      }
+    }
+  }
+  resultRevision = oe.getRevision();
+  if (changed.empty())
+    return false;
+
+  vector<oEvent::ResultEvent> events;
+  oe.getResultEvents(changed, controlIdFilter, events);
+  calculateResults(events);
+  for (oEvent::ResultEvent &re : events)
+    classResults[re.classId()].push_back(re);
+
+  results.clear();
+  for (auto &cr : classResults)
+    results.insert(results.end(), cr.second.begin(), cr.second.end());
+  timeToResultIx.clear();
 
   orderedResults.resize(results.size());
   for (size_t k = 0; k < results.size(); k++) {
@@ -97,7 +153,7 @@ void SpeakerMonitor::show(gdioutput &gdi) {
 
   // Sort
   sort(results.begin(), results.end(), orderResultsInTime);
-  
+
   // Initialize map back
   for (size_t k = 0; k < results.size(); k++) {
     orderedResults[results[k].localIndex].eventIx = k;
@@ -105,34 +161,30 @@ void SpeakerMonitor::show(gdioutput &gdi) {
 
   for (size_t k = 0; k < results.size(); k++) {
     oEvent::ResultEvent &re(results[results.size()-(1+k)]);
-    if (re.status == StatusOK) {
+    if (re.status == StatusOK && changed.count(re.classId())) {
       map<int,int> &dynLead = dynamicTotalLeaderTimes[ResultKey(re.classId(), re.control, re.leg())];
       int totTime = re.runTime;
       if (dynLead.empty() || totTime < dynLead.rbegin()->second)
         dynLead[re.time] = totTime;
     }
   }
-  
-  int order = 0;
-  for (size_t k = 0; k < results.size() && (order < numLimit || numLimit == 0); k++) {
-    if (results[k].time > 0) {
-      oEvent::ResultEvent *ahead = 0, *behind = 0;
-
-      if (results[k].status == StatusOK)
-        ahead = k > 0 && sameResultPoint(results[k], results[k-1]) ? &results[k-1] : 0;
-      if (results[k].status == StatusOK)
-        behind = (k + 1) < results.size() && sameResultPoint(results[k], results[k+1]) ? &results[k+1] : 0;
+  return true;
+}
 
-      renderResult(gdi, ahead, results[k], behind, order, true);
-    }
+void SpeakerMonitor::clearClassResults(int classId) {
+  auto res = classResults.find(classId);
+  if (res != classResults.end()) {
+    for (const oEvent::ResultEvent &re : res->second)
+      runnerToTimeKey.erase(re.r->getId());
+    classResults.erase(res);
   }
 
-  for (size_t k = 0; k < results.size() && (order < numLimit || numLimit == 0); k++) {
-    if (results[k].time == 0)
-      renderResult(gdi, 0, results[k], 0, order, false);
-    else
-      break;
-  }
+  const int minKey = numeric_limits<int>::min();
+  const ResultKey first(classId, minKey, minKey), last(classId + 1, minKey, minKey);
+  firstTimes.erase(firstTimes.lower_bound(first), firstTimes.lower_bound(last));
+  totalLeaderTimes.erase(totalLeaderTimes.lower_bound(first), totalLeaderTimes.lower_bound(last));
+  dynamicTotalLeaderTimes.erase(dynamicTotalLeaderTimes.lower_bound(first),
+                                dynamicTotalLeaderTimes.lower_bound(last));
 }
 
 bool SpeakerMonitor::sameResultPoint(const oEvent::ResultEvent &a,
@@ -287,26 +339,21 @@ bool compareResult(const oEvent::ResultEvent &a,
   return a.r->getId() < b.r->getId();
 }
 
-void SpeakerMonitor::calculateResults() {
+void SpeakerMonitor::calculateResults(vector<oEvent::ResultEvent> &events) {
   // TODO Result modules
 
-  for (size_t k = 0; k < results.size(); k++) {
-    results[k].runTime = results[k].r->getTotalRunningTime(results[k].time, true, totalResults);
-    if (results[k].status == StatusOK && totalResults)
-      results[k].status = results[k].r->getTotalStatus();
+  for (size_t k = 0; k < events.size(); k++) {
+    events[k].runTime = events[k].r->getTotalRunningTime(events[k].time, true, totalResults);
+    if (events[k].status == StatusOK && totalResults)
+      events[k].status = events[k].r->getTotalStatus();
     
-    if (results[k].status == StatusOK)
-      results[k].resultScore = results[k].runTime;
+    if (events[k].status == StatusOK)
+      events[k].resultScore = events[k].runTime;
     else
-      results[k].resultScore = RunnerStatusOrderMap[results[k].status] + timeConstHour*24*7;
+      events[k].resultScore = RunnerStatusOrderMap[events[k].status] + timeConstHour*24*7;
   }
 
-  totalLeaderTimes.clear();
-  firstTimes.clear();
-  dynamicTotalLeaderTimes.clear();
-  runnerToTimeKey.clear();
-  timeToResultIx.clear();
-  sort(results.begin(), results.end(), compareResult);
+  sort(events.begin(), events.end(), compareResult);
 
   int clsId = -1;
   int ctrlId = -1;
@@ -314,39 +361,39 @@ void SpeakerMonitor::calculateResults() {
   int lastScore = 0;
   int place = 0;
 
-  for (size_t k = 0; k < results.size(); k++) {
-    if (results[k].partialCount > 0)
+  for (size_t k = 0; k < events.size(); k++) {
+    if (events[k].partialCount > 0)
       continue; // Skip in result calculation
-    int totTime = results[k].r->getTotalRunningTime(results[k].time, true, totalResults);
-    assert(totTime == results[k].runTime);
-    int leg = results[k].leg();
+    int totTime = events[k].r->getTotalRunningTime(events[k].time, true, totalResults);
+    assert(totTime == events[k].runTime);
+    int leg = events[k].leg();
     
-    if (clsId != results[k].classId() || ctrlId != results[k].control || legId != leg) {
-      clsId = results[k].classId();
-      ctrlId = results[k].control;
+    if (clsId != events[k].classId() || ctrlId != events[k].control || legId != leg) {
+      clsId = events[k].classId();
+      ctrlId = events[k].control;
       legId = leg;
       place = 1;
       ResultKey key(clsId, ctrlId, leg);
     
       totalLeaderTimes[key] = totTime;
     }
-    else if (lastScore != results[k].resultScore)
+    else if (lastScore != events[k].resultScore)
       place++;
 
     ResultKey key(clsId, ctrlId, leg);
-    lastScore = results[k].resultScore;
+    lastScore = events[k].resultScore;
 
-    if (results[k].status == StatusOK) {
-      results[k].place = place;
-      runnerToTimeKey[results[k].r->getId()].push_back(ResultInfo(key, results[k].time, totTime));
+    if (events[k].status == StatusOK) {
+      events[k].place = place;
+      runnerToTimeKey[events[k].r->getId()].push_back(ResultInfo(key, events[k].time, totTime));
 
-      if (results[k].time > 0) {
+      if (events[k].time > 0) {
         int val = firstTimes[key];
-        firstTimes[key] = (val > 0 && val < results[k].time) ? val : results[k].time;
+        firstTimes[key] = (val > 0 && val < events[k].time) ? val : events[k].time;
       }
     }
     else
-      results[k].place = 0;
+      events[k].place = 0;
   }
 
   // Sort times for each runner
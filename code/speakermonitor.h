@@ -76,6 +76,10 @@ private:
   set<int> classFilter;
   set<int> controlIdFilter;
   vector<oEvent::ResultEvent> results;
+  // Calculated result events of each class, in result order
+  map<int, vector<oEvent::ResultEvent>> classResults;
+  // Data revision of the calculated results, -1 to calculate all classes
+  long resultRevision = -1;
   bool totalResults;
 
   int placeLimit;
@@ -122,6 +126,9 @@ private:
 
   const oEvent::ResultEvent *getAdjacentResult(const oEvent::ResultEvent &res, int delta) const;
 
+  void clearClassResults(int classId);
+  void calculateResults(vector<oEvent::ResultEvent> &events);
+
   int getLeaderTime(const oEvent::ResultEvent &res);
   int getDynamicLeaderTime(const oEvent::ResultEvent &res, int time);
   int getDynamicLeaderTime(const ResultKey &res, int time);
@@ -135,6 +142,8 @@ public:
   void setClassFilter(const set<int> &filter, const set<int> &controlIdFilter);
   
   void useTotalResults(bool total) {
+    if (totalResults != total)
+      resultRevision = -1;
     totalResults = total;
   }
   
@@ -144,6 +153,8 @@ public:
 
   void setLimits(int placeLimit, int numLimit);
   void show(gdioutput &gdi);
-  
-  void calculateResults();
+
+  /** Calculate results for classes where a runner or team has changed. Returns true if results changed. */
+  bool updateResults();
+  const vector<oEvent::ResultEvent> &getResults() const {return results;}
 };
@@ -0,0 +1,313 @@
+﻿#pragma once
+/************************************************************************
+    MeOS - Orienteering Software
+    Copyright (C) 2009-2026 Melin Software HB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License fro more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Melin Software HB - software@melin.nu - www.melin.nu
+    Eksoppsvägen 16, SE-75646 UPPSALA, Sweden
+
+************************************************************************/
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <cassert>
+
+/** Container for the objects of an event (runners, classes, ...). Used
+    like a std::list: addresses of the objects never change, and an iterator
+    keeps referring to its object when objects are added, erased, sorted or
+    spliced.
+
+    The objects are kept in chunks of contiguous memory and iterated by a
+    dense vector of pointers. An erased object leaves an empty slot in the
+    order (skipped when iterating). Empty slots are removed when the
+    container is sorted, or when they make up more than half of the order.
+    An iterator looks up the new position of its object the next time it
+    is moved. The memory of erased objects is reused. */
+template<class T> class stablelist {
+private:
+  static constexpr size_t chunkSize = sizeof(T) < 4096 ? 65536 / sizeof(T) : 16;
+  // Do not compact on erase for fewer empty slots than this
+  static constexpr size_t minCompact = 32;
+
+  vector<T *> chunks;
+  size_t usedInLast = chunkSize;
+  vector<T *> freeSlots;
+
+  /** Iteration order. Erased objects are nullptr. */
+  vector<T *> order;
+  size_t numObjects = 0;
+  size_t numErased = 0;
+
+  /** Changed when objects move in the order */
+  unsigned int orderVersion = 0;
+  /** Position of each object in the order, built when an iterator needs it */
+  mutable unordered_map<const T *, size_t> position;
+  mutable bool positionValid = false;
+
+  T *allocate() {
+    if (!freeSlots.empty()) {
+      T *p = freeSlots.back();
+      freeSlots.pop_back();
+      return p;
+    }
+    if (usedInLast == chunkSize) {
+      chunks.push_back(static_cast<T *>(::operator new(sizeof(T) * chunkSize)));
+      usedInLast = 0;
+    }
+    return chunks.back() + usedInLast++;
+  }
+
+  void insert(T *p) {
+    order.push_back(p);
+    numObjects++;
+    if (positionValid)
+      position[p] = order.size() - 1;
+  }
+
+  void orderChanged() {
+    orderVersion++;
+    position.clear();
+    positionValid = false;
+  }
+
+  void compact() {
+    if (numErased > 0) {
+      order.erase(std::remove(order.begin(), order.end(), nullptr), order.end());
+      numErased = 0;
+      orderChanged();
+    }
+  }
+
+  size_t positionOf(const T *p) const {
+    if (!positionValid) {
+      position.reserve(numObjects);
+      for (size_t k = 0; k < order.size(); k++) {
+        if (order[k])
+          position[order[k]] = k;
+      }
+      positionValid = true;
+    }
+    auto res = position.find(p);
+    assert(res != position.end());
+    return res->second;
+  }
+
+  static constexpr size_t endIx = size_t(-1);
+
+  template<class V, class Ptr> class iteratorBase {
+    const stablelist *list = nullptr;
+    // The object, nullptr at end
+    T *obj = nullptr;
+    size_t ix = endIx;
+    unsigned int version = 0;
+
+    void setPosition(size_t i) {
+      const vector<T *> &ord = list->order;
+      while (i < ord.size() && ord[i] == nullptr)
+        i++;
+      if (i < ord.size()) {
+        ix = i;
+        obj = ord[i];
+      }
+      else {
+        ix = endIx;
+        obj = nullptr;
+      }
+      version = list->orderVersion;
+    }
+
+    // Find the position of the object if the order has changed
+    void sync() {
+      if (version != list->orderVersion) {
+        if (obj)
+          ix = list->positionOf(obj);
+        version = list->orderVersion;
+      }
+    }
+
+    iteratorBase(const stablelist *list, size_t ix) : list(list) { setPosition(ix); }
+    friend class stablelist;
+    template<class V2, class Ptr2> friend class iteratorBase;
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef Ptr pointer;
+    typedef V &reference;
+
+    iteratorBase() = default;
+    // Allow iterator -> const_iterator
+    template<class V2, class Ptr2>
+    iteratorBase(const iteratorBase<V2, Ptr2> &it) : list(it.list), obj(it.obj), ix(it.ix), version(it.version) {}
+
+    V &operator*() const { return *obj; }
+    Ptr operator->() const { return obj; }
+
+    iteratorBase &operator++() {
+      sync();
+      setPosition(ix + 1);
+      return *this;
+    }
+    iteratorBase operator++(int) {
+      iteratorBase t = *this;
+      ++*this;
+      return t;
+    }
+    iteratorBase &operator--() {
+      sync();
+      const vector<T *> &ord = list->order;
+      ix = std::min(ix, ord.size());
+      do {
+        ix--;
+      } while (ix > 0 && ord[ix] == nullptr);
+      obj = ord[ix];
+      return *this;
+    }
+    iteratorBase operator--(int) {
+      iteratorBase t = *this;
+      --*this;
+      return t;
+    }
+
+    // Any iterator past the last object equals end(), also after objects are added.
+    template<class V2, class Ptr2>
+    bool operator==(const iteratorBase<V2, Ptr2> &it) const { return obj == it.obj; }
+    template<class V2, class Ptr2>
+    bool operator!=(const iteratorBase<V2, Ptr2> &it) const { return obj != it.obj; }
+  };
+
+public:
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef iteratorBase<T, T *> iterator;
+  typedef iteratorBase<const T, const T *> const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  stablelist() = default;
+  stablelist(const stablelist &) = delete;
+  stablelist &operator=(const stablelist &) = delete;
+  ~stablelist() { clear(); }
+
+  size_t size() const { return numObjects; }
+  bool empty() const { return numObjects == 0; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, endIx); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, endIx); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  T &front() { return *begin(); }
+  const T &front() const { return *begin(); }
+  T &back() { return *--end(); }
+  const T &back() const { return *--end(); }
+
+  void push_back(const T &obj) {
+    T *p = allocate();
+    try {
+      new (p) T(obj);
+    }
+    catch (...) {
+      freeSlots.push_back(p);
+      throw;
+    }
+    insert(p);
+  }
+
+  template<class... Args> T &emplace_back(Args&&... args) {
+    T *p = allocate();
+    try {
+      new (p) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+      freeSlots.push_back(p);
+      throw;
+    }
+    insert(p);
+    return *p;
+  }
+
+  /** Erase an object. Iterators to other objects remain valid. Returns the next object. */
+  iterator erase(iterator it) {
+    it.sync();
+    T *p = it.obj;
+    order[it.ix] = nullptr;
+    numErased++;
+    numObjects--;
+    p->~T();
+    freeSlots.push_back(p);
+    iterator next(this, it.ix + 1);
+    if (numErased >= minCompact && numErased > numObjects)
+      compact();
+    return next;
+  }
+
+  void clear() {
+    for (T *p : order) {
+      if (p)
+        p->~T();
+    }
+    order.clear();
+    for (T *c : chunks)
+      ::operator delete(c);
+    chunks.clear();
+    freeSlots.clear();
+    usedInLast = chunkSize;
+    numObjects = 0;
+    numErased = 0;
+    orderChanged();
+  }
+
+  /** Stable sort, like list::sort. Addresses of the objects do not change. */
+  template<class Comp> void sort(Comp comp) {
+    compact();
+    std::stable_sort(order.begin(), order.end(), [&comp](const T *a, const T *b) {
+      return comp(*a, *b);
+    });
+    orderChanged();
+  }
+
+  void sort() {
+    sort([](const T &a, const T &b) { return a < b; });
+  }
+
+  /** Move [first, last) before pos. Only within the same container. */
+  void splice(iterator pos, stablelist &other, iterator first, iterator last) {
+    assert(&other == this);
+    pos.sync();
+    first.sync();
+    last.sync();
+    size_t p = std::min(pos.ix, order.size());
+    size_t f = std::min(first.ix, order.size());
+    size_t l = std::min(last.ix, order.size());
+    if (p < f)
+      std::rotate(order.begin() + p, order.begin() + f, order.begin() + l);
+    else if (p > l)
+      std::rotate(order.begin() + f, order.begin() + l, order.begin() + p);
+    else
+      return;
+    orderChanged();
+  }
+};
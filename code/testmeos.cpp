@@ -91,6 +91,9 @@ void TestMeOS::publishChildren(gdioutput &gdi, pair<int,int> &passFail) const {
     gdi.addStringUT(1, "PASSED " + test).setColor(colorGreen);
   }
 
+  for (const string &line : reportLines)
+    gdi.addStringUT(0, line);
+
   if (!subTests.empty()) {
     gdi.dropLine(0.5);
     int cx = gdi.getCX();
@@ -128,6 +131,7 @@ void TestMeOS::runProtected(bool protect) const {
   gdi_main->clearPage(false, false);
   gdi_main->dbRegisterSubCommand(0, "");
   subWindows.clear();
+  reportLines.clear();
   oe_main->clear();
   gdi_main->isTestMode = true;
   showTab(TCmpTab);
@@ -358,6 +362,11 @@ void TestMeOS::assertTrue(const char *message, bool condition) const {
   assertEquals(message, "true", condition ? "true" : "false");
 }
 
+void TestMeOS::report(const string &line) const {
+  reportLines.push_back(line);
+  OutputDebugStringA((test + ": " + line + "\n").c_str());
+}
+
 void TestMeOS::assertEquals(const string &message, 
                             const string &expected,
                             const string &value) const {
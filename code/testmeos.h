@@ -59,6 +59,7 @@ private:
 
   mutable TestStatus status;
   mutable wstring message;
+  mutable vector<string> reportLines; // Measured values (benchmarks)
   int testId;
   int *testIdMain; // Pointer to main test id
 
@@ -68,6 +69,9 @@ private:
 protected:
   oEvent &oe() {return *oe_main;}
   const oEvent &oe() const {return *oe_main;}
+
+  // Event to set up test data in (run is const)
+  oEvent &testEvent() const {return *oe_main;}
   
   TestMeOS &registerTest(const TestMeOS &test);
 
@@ -88,6 +92,9 @@ protected:
 
   void assertTrue(const char *message, bool condition) const;
 
+  // Add a measured value to the test report, e.g. the result of a benchmark
+  void report(const string &line) const;
+
   int getResultModuleIndex(const char *tag) const;
   int getListIndex(const char *name) const;
   int getResultListIndex(const char *name) const {
@@ -8,7 +8,1357 @@
 ************************************************************************/
 #include "stdafx.h"
 
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <winsock2.h>
+
 #include "testmeos.h"
+#include "oEvent.h"
+#include "gdioutput.h"
+#include "listsink.h"
+#include "oEventDraw.h"
+#include "Table.h"
+#include "speakermonitor.h"
+#include "journal.h"
+#include "localizer.h"
+#include "RunnerDB.h"
+#include "generalresult.h"
+#include "parser.h"
+#include "restserver.h"
+#include "SportIdent.h"
+#include "xmlparser.h"
+#include "meos_util.h"
+#include "meosexception.h"
+#include "intkeymap.hpp"
+#include "intkeymapimpl.hpp"
+
+// Milliseconds since start, for benchmarks
+static double msSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// New competition with classes of runners with start times
+static vector<pRunner> createRunners(oEvent &event, int numClass, int numRunner) {
+  event.newCompetition(L"Test");
+  vector<pRunner> runners;
+  for (int c = 0; c < numClass; c++) {
+    pClass cls = event.addClass(L"Klass " + itow(c + 1));
+    for (int k = 0; k < numRunner; k++) {
+      pRunner r = event.addRunner(L"Runner " + itow(c * numRunner + k + 1), 0, cls->getId(), 0, L"", false);
+      r->setStartTime(timeConstHour + k * 2 * timeConstMinute, true, oBase::ChangeType::Update);
+      r->synchronize(true);
+      runners.push_back(r);
+    }
+  }
+  return runners;
+}
+
+static int countSubString(const string &s, const string &sub) {
+  int count = 0;
+  for (size_t pos = s.find(sub); pos != string::npos; pos = s.find(sub, pos + sub.length()))
+    count++;
+  return count;
+}
+
+// Map counts are kept as per-class sums and must follow a runner to its new class
+class TestClassChangeMaps : public TestMeOS {
+public:
+  TestClassChangeMaps(TestMeOS &tm) : TestMeOS(tm, "Remaining maps after class change") {}
+  TestMeOS *newInstance() const override { return new TestClassChangeMaps(*this); }
+  void run() const override;
+};
+
+void TestClassChangeMaps::run() const {
+  oEvent &event = testEvent();
+  event.newCompetition(L"Test");
+  pCourse crs = event.addCourse(L"Bana");
+  crs->setNumberMaps(10);
+  pClass c1 = event.addClass(L"H21", crs->getId());
+  c1->setNumberMaps(5);
+  pClass c2 = event.addClass(L"D21", crs->getId());
+  c2->setNumberMaps(5);
+
+  vector<pRunner> runners;
+  for (int k = 0; k < 3; k++) {
+    runners.push_back(event.addRunner(L"Runner " + itow(k + 1), 0, c1->getId(), 0, L"", false));
+    runners.back()->synchronize(true);
+  }
+  assertEquals(2, c1->getNumRemainingMaps(false));
+  assertEquals(5, c2->getNumRemainingMaps(false));
+
+  runners[0]->setClassId(c2->getId(), true);
+  runners[0]->synchronize(true);
+  assertEquals(3, c1->getNumRemainingMaps(false));
+  assertEquals(4, c2->getNumRemainingMaps(false));
+
+  runners[0]->setStatus(StatusDNS, true, oBase::ChangeType::Update);
+  runners[0]->synchronize(true);
+  assertEquals(3, c1->getNumRemainingMaps(false));
+  assertEquals(5, c2->getNumRemainingMaps(false));
+}
+
+// Remaining maps after a change of one runner, recounting one class versus all classes
+class BenchmarkMapCount : public TestMeOS {
+public:
+  BenchmarkMapCount(TestMeOS &tm) : TestMeOS(tm, "Benchmark remaining maps") {}
+  TestMeOS *newInstance() const override { return new BenchmarkMapCount(*this); }
+  void run() const override;
+};
+
+void BenchmarkMapCount::run() const {
+  oEvent &event = testEvent();
+  event.newCompetition(L"Test");
+  constexpr int numClass = 40, numRunner = 250, numRounds = 50;
+  vector<pClass> classes;
+  vector<pRunner> runners;
+  for (int c = 0; c < numClass; c++) {
+    pCourse crs = event.addCourse(L"Bana " + itow(c + 1));
+    crs->setNumberMaps(numRunner + 10);
+    classes.push_back(event.addClass(L"Klass " + itow(c + 1), crs->getId()));
+    for (int k = 0; k < numRunner; k++) {
+      runners.push_back(event.addRunner(L"Runner " + itow(c * numRunner + k), 0, classes.back()->getId(), 0, L"", false));
+      runners.back()->synchronize(true);
+    }
+  }
+
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < numRounds; i++)
+    event.calculateNumRemainingMaps(true);
+  double full = msSince(start) / numRounds;
+
+  start = chrono::steady_clock::now();
+  for (int i = 0; i < numRounds; i++) {
+    pRunner r = runners[(i * 7919) % runners.size()];
+    r->setStatus(r->getStatus() == StatusDNS ? StatusUnknown : StatusDNS, true, oBase::ChangeType::Update);
+    r->synchronize(true);
+    event.calculateNumRemainingMaps(false);
+  }
+  double incremental = msSince(start) / numRounds;
+
+  vector<int> remaining;
+  for (pClass c : classes)
+    remaining.push_back(c->getNumRemainingMaps(false));
+  event.calculateNumRemainingMaps(true);
+  for (size_t c = 0; c < classes.size(); c++)
+    assertEquals(remaining[c], classes[c]->getNumRemainingMaps(false));
+
+  report(itos(runners.size()) + " runners, full count: " + itos(int(full * 1000)) + " us");
+  report("After change of one runner: " + itos(int(incremental * 1000)) + " us");
+}
+
+// Lists exported without layout, as for the REST formats csv and json
+class TestListExport : public TestMeOS {
+public:
+  TestListExport(TestMeOS &tm) : TestMeOS(tm, "Export list as CSV and JSON") {}
+  TestMeOS *newInstance() const override { return new TestListExport(*this); }
+  void run() const override;
+};
+
+void TestListExport::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 2, 5);
+  runners[0]->setName(L"Anna \"Quote\"; Svensson", false);
+  runners[0]->synchronize(true);
+
+  oListInfo li;
+  event.generateListInfo(gdi(), EStdStartList, 0, li);
+
+  ostringstream csv;
+  CSVListSink csvSink(csv);
+  event.generateList(csvSink, true, li);
+  string csvText = csv.str();
+  assertEquals(int(runners.size()), countSubString(csvText, "\n"));
+  assertEquals(1, countSubString(csvText, "\"Anna \"\"Quote\"\"; Svensson\""));
+  for (pRunner r : runners)
+    assertTrue("Runner in CSV", csvText.find(gdi().toUTF8(r->getName())) != string::npos);
+
+  ostringstream json;
+  JSONListSink jsonSink(json);
+  event.generateList(jsonSink, true, li);
+  string jsonText = json.str();
+  assertEquals("JSON start", "{\"name\":\"", jsonText.substr(0, 9));
+  assertEquals("JSON end", "]}\n", jsonText.substr(jsonText.length() - 3));
+  assertEquals(int(runners.size()), countSubString(jsonText, "{\"type\":\"Post\""));
+  assertEquals(1, countSubString(jsonText, "Anna \\\"Quote\\\"; Svensson"));
+  assertEquals(countSubString(jsonText, "{"), countSubString(jsonText, "}"));
+  assertEquals(countSubString(jsonText, "["), countSubString(jsonText, "]"));
+}
+
+// Export speed without layout compared to the laid out list
+class BenchmarkListExport : public TestMeOS {
+public:
+  BenchmarkListExport(TestMeOS &tm) : TestMeOS(tm, "Benchmark list export") {}
+  TestMeOS *newInstance() const override { return new BenchmarkListExport(*this); }
+  void run() const override;
+};
+
+void BenchmarkListExport::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 40, 250);
+  oListInfo li;
+  event.generateListInfo(gdi(), EStdStartList, 0, li);
+  constexpr int numRounds = 5;
+
+  auto bytesPerSecond = [](size_t bytes, double ms) {
+    return itos(int(bytes / (ms / 1000.0) / 1024)) + " kB/s";
+  };
+
+  auto start = chrono::steady_clock::now();
+  size_t bytes = 0;
+  for (int i = 0; i < numRounds; i++) {
+    ostringstream out;
+    CSVListSink sink(out);
+    event.generateList(sink, true, li);
+    bytes += out.str().length();
+  }
+  report("CSV, " + itos(runners.size()) + " runners: " + bytesPerSecond(bytes, msSince(start)));
+
+  start = chrono::steady_clock::now();
+  bytes = 0;
+  for (int i = 0; i < numRounds; i++) {
+    ostringstream out;
+    JSONListSink sink(out);
+    event.generateList(sink, true, li);
+    bytes += out.str().length();
+  }
+  report("JSON: " + bytesPerSecond(bytes, msSince(start)));
+
+  start = chrono::steady_clock::now();
+  for (int i = 0; i < numRounds; i++) {
+    gdioutput gdiPrint("print", gdi().getScale());
+    gdiPrint.clearPage(false);
+    event.generateList(gdiPrint, true, li, false);
+  }
+  report("With layout: " + itos(int(msSince(start) / numRounds)) + " ms per list");
+}
+
+// Random operations on intkeymap compared with std::unordered_map
+class TestIntKeyMap : public TestMeOS {
+  template<typename KEY> void fuzz(unsigned seed, KEY keyScale) const;
+  template<typename KEY> void verify(const intkeymap<int, KEY> &map,
+                                     const unordered_map<KEY, int> &ref, KEY keyScale) const;
+public:
+  TestIntKeyMap(TestMeOS &tm) : TestMeOS(tm, "Hash map with integer keys") {}
+  TestMeOS *newInstance() const override { return new TestIntKeyMap(*this); }
+  void run() const override;
+};
+
+constexpr int intKeyMapKeyRange = 3000;
+
+template<typename KEY>
+void TestIntKeyMap::verify(const intkeymap<int, KEY> &map,
+                           const unordered_map<KEY, int> &ref, KEY keyScale) const {
+  assertEquals(int(ref.size()), map.size());
+  assertTrue("Empty", map.empty() == ref.empty());
+  for (int k = 0; k < intKeyMapKeyRange; k++) {
+    KEY key = KEY(k - 500) * keyScale;
+    auto res = ref.find(key);
+    int value = -1;
+    bool found = map.lookup(key, value);
+    assertTrue("Key found", found == (res != ref.end()));
+    assertEquals(found ? res->second : 0, value);
+    assertEquals(found ? 1 : 0, map.count(key));
+    assertEquals(value, map[key]);
+  }
+}
+
+template<typename KEY>
+void TestIntKeyMap::fuzz(unsigned seed, KEY keyScale) const {
+  mt19937 rnd(seed);
+  intkeymap<int, KEY> map;
+  unordered_map<KEY, int> ref;
+  auto randomKey = [&]() { return KEY(int(rnd() % intKeyMapKeyRange) - 500) * keyScale; };
+
+  for (int i = 0; i < 200000; i++) {
+    KEY key = randomKey();
+    int value = int(rnd() % 100000);
+    switch (rnd() % 10) {
+    case 0:
+    case 1:
+    case 2:
+      map.insert(key, value);
+      ref[key] = value;
+      break;
+    case 3:
+      map[key] = value;
+      ref[key] = value;
+      break;
+    case 4:
+    case 5:
+    case 6:
+      map.remove(key);
+      ref.erase(key);
+      break;
+    case 7: {
+      int v = -1;
+      bool found = map.lookup(key, v);
+      auto res = ref.find(key);
+      assertTrue("Key found", found == (res != ref.end()));
+      if (found)
+        assertEquals(res->second, v);
+      break;
+    }
+    case 8:
+      assertEquals(int(ref.count(key)), map.count(key));
+      break;
+    case 9:
+      if (rnd() % 100 == 0)
+        map.resize(int(rnd() % 5000));
+      break;
+    }
+
+    if (i % 5000 == 4999) {
+      intkeymap<int, KEY> copy(map);
+      verify(copy, ref, keyScale);
+      intkeymap<int, KEY> assigned(7);
+      assigned.insert(key, value);
+      assigned = map;
+      verify(assigned, ref, keyScale);
+      map = assigned;
+      verify(map, ref, keyScale);
+    }
+
+    if (i % 50000 == 49999) {
+      map.clear();
+      ref.clear();
+      verify(map, ref, keyScale);
+    }
+  }
+  verify(map, ref, keyScale);
+}
+
+void TestIntKeyMap::run() const {
+  fuzz<int>(1, 1);
+  fuzz<int>(2, 1024); // Keys with equal low bits
+  fuzz<__int64>(3, 1);
+  fuzz<__int64>(4, 1000000007); // Keys beyond 32 bits
+}
+
+// Insert and lookup speed of intkeymap and std::unordered_map
+class BenchmarkIntKeyMap : public TestMeOS {
+public:
+  BenchmarkIntKeyMap(TestMeOS &tm) : TestMeOS(tm, "Benchmark hash map with integer keys") {}
+  TestMeOS *newInstance() const override { return new BenchmarkIntKeyMap(*this); }
+  void run() const override;
+};
+
+void BenchmarkIntKeyMap::run() const {
+  constexpr int numKeys = 1000000, numLookup = 4000000;
+  mt19937 rnd(17);
+  vector<int> keys(numKeys);
+  for (int &k : keys)
+    k = int(rnd() % 100000000);
+
+  auto nsPerOp = [](double ms, int ops) {
+    return itos(int(ms * 1000000.0 / ops)) + " ns";
+  };
+
+  int64_t sum = 0;
+  auto start = chrono::steady_clock::now();
+  intkeymap<int> map;
+  for (int k = 0; k < numKeys; k++)
+    map.insert(keys[k], k);
+  string insertMap = nsPerOp(msSince(start), numKeys);
+  start = chrono::steady_clock::now();
+  for (int k = 0; k < numLookup; k++) {
+    int v;
+    if (map.lookup(keys[(size_t(k) * 7919) % numKeys] + (k & 1), v))
+      sum += v;
+  }
+  string lookupMap = nsPerOp(msSince(start), numLookup);
+
+  start = chrono::steady_clock::now();
+  unordered_map<int, int> ref;
+  for (int k = 0; k < numKeys; k++)
+    ref[keys[k]] = k;
+  string insertRef = nsPerOp(msSince(start), numKeys);
+  start = chrono::steady_clock::now();
+  for (int k = 0; k < numLookup; k++) {
+    auto res = ref.find(keys[(size_t(k) * 7919) % numKeys] + (k & 1));
+    if (res != ref.end())
+      sum -= res->second;
+  }
+  string lookupRef = nsPerOp(msSince(start), numLookup);
+
+  assertTrue("Same lookup result", sum == 0);
+  report("intkeymap insert: " + insertMap + ", lookup: " + lookupMap);
+  report("unordered_map insert: " + insertRef + ", lookup: " + lookupRef);
+}
+
+// Iterators of stablelist follow their object through sort, splice and compaction, like std::list
+class TestStableList : public TestMeOS {
+public:
+  TestStableList(TestMeOS &tm) : TestMeOS(tm, "Stable list iterators") {}
+  TestMeOS *newInstance() const override { return new TestStableList(*this); }
+  void run() const override;
+};
+
+void TestStableList::run() const {
+  stablelist<int> lst;
+  for (int k = 0; k < 200; k++)
+    lst.push_back(k);
+  auto at = [&lst](int value) {
+    for (auto it = lst.begin(); it != lst.end(); ++it) {
+      if (*it == value)
+        return it;
+    }
+    return lst.end();
+  };
+
+  auto it = at(100);
+  lst.sort([](int a, int b) { return a > b; });
+  assertEquals(100, *it);
+  assertEquals(99, *++it);
+  assertEquals(199, lst.front());
+
+  // Erase enough objects to compact the order
+  auto keep = at(155);
+  for (auto e = lst.begin(); e != lst.end();) {
+    if (*e % 10 != 0 && *e != 155)
+      e = lst.erase(e);
+    else
+      ++e;
+  }
+  assertEquals(21, int(lst.size()));
+  assertEquals(155, *keep);
+  assertEquals(150, *++keep);
+  assertEquals(155, *--keep);
+
+  int n = 0, last = 1000;
+  for (int v : lst) {
+    assertTrue("Sorted", v < last);
+    last = v;
+    n++;
+  }
+  assertEquals(int(lst.size()), n);
+
+  auto moved = at(50);
+  lst.splice(lst.begin(), lst, moved, lst.end());
+  assertEquals(50, lst.front());
+  assertEquals(50, *moved);
+  assertEquals(40, *++moved);
+  assertEquals(60, lst.back());
+
+  lst.push_back(1000);
+  assertEquals(1000, lst.back());
+  assertEquals(1000, *--lst.end());
+  assertEquals(22, int(lst.size()));
+}
+
+// Iteration, sort and erase of stablelist compared to std::list
+class BenchmarkStableList : public TestMeOS {
+public:
+  BenchmarkStableList(TestMeOS &tm) : TestMeOS(tm, "Benchmark stable list") {}
+  TestMeOS *newInstance() const override { return new BenchmarkStableList(*this); }
+  void run() const override;
+};
+
+void BenchmarkStableList::run() const {
+  constexpr int numObj = 200000, numIter = 20;
+  struct Obj {
+    int key;
+    char data[200];
+    bool operator<(const Obj &o) const { return key < o.key; }
+  };
+  mt19937 rnd(3);
+  vector<int> keys(numObj);
+  for (int &k : keys)
+    k = int(rnd() % 1000000);
+
+  auto measure = [&](auto &lst) {
+    string res;
+    int64_t sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int k = 0; k < numObj; k++) {
+      lst.emplace_back();
+      lst.back().key = keys[k];
+    }
+    res += "insert " + itos(int(msSince(start))) + " ms";
+    start = chrono::steady_clock::now();
+    for (int n = 0; n < numIter; n++) {
+      for (auto &o : lst)
+        sum += o.key;
+    }
+    res += ", iterate " + itos(int(msSince(start) / numIter)) + " ms";
+    start = chrono::steady_clock::now();
+    lst.sort();
+    res += ", sort " + itos(int(msSince(start))) + " ms";
+    start = chrono::steady_clock::now();
+    int k = 0;
+    for (auto it = lst.begin(); it != lst.end(); k++) {
+      if (k % 3 != 0)
+        it = lst.erase(it);
+      else
+        ++it;
+    }
+    for (auto &o : lst)
+      sum += o.key;
+    res += ", erase " + itos(int(msSince(start))) + " ms";
+    return make_pair(sum, res);
+  };
+
+  stablelist<Obj> stable;
+  list<Obj> ref;
+  auto s = measure(stable);
+  auto r = measure(ref);
+  assertTrue("Same result", s.first == r.first);
+  assertEquals(int(ref.size()), int(stable.size()));
+  report("stablelist: " + s.second);
+  report("std::list: " + r.second);
+}
+
+// Translations composed on several threads keep their value after many more translations
+class TestTranslateThreads : public TestMeOS {
+public:
+  TestTranslateThreads(TestMeOS &tm) : TestMeOS(tm, "Translate on several threads") {}
+  TestMeOS *newInstance() const override { return new TestTranslateThreads(*this); }
+  void run() const override;
+};
+
+void TestTranslateThreads::run() const {
+  constexpr int numThread = 8, numString = 2000;
+  const wstring direct = lang.tl("Klass");
+  vector<int> errors(numThread);
+  vector<thread> threads;
+  for (int t = 0; t < numThread; t++) {
+    threads.emplace_back([t, &direct, &errors]() {
+      vector<pair<const wstring *, wstring>> results;
+      for (int k = 0; k < numString; k++) {
+        wstring text = L"Thread " + itow(t) + L" string " + itow(k);
+        // Pass through, prefix and direct translations
+        results.emplace_back(&lang.tl(L"#" + text), text);
+        results.emplace_back(&lang.tl(itow(k) + L": #" + text), itow(k) + L": " + text);
+        results.emplace_back(&lang.tl("Klass"), direct);
+      }
+      for (auto &r : results) {
+        if (*r.first != r.second)
+          errors[t]++;
+      }
+    });
+  }
+  for (auto &th : threads)
+    th.join();
+
+  for (int t = 0; t < numThread; t++)
+    assertEquals(0, errors[t]);
+}
+
+// Time per call of lang.tl for direct, composed and substituted translations
+class BenchmarkTranslate : public TestMeOS {
+public:
+  BenchmarkTranslate(TestMeOS &tm) : TestMeOS(tm, "Benchmark translate") {}
+  TestMeOS *newInstance() const override { return new BenchmarkTranslate(*this); }
+  void run() const override;
+};
+
+void BenchmarkTranslate::run() const {
+  constexpr int numCall = 1000000;
+  auto nsPerCall = [](double ms) {
+    return itos(int(ms * 1000000.0 / numCall)) + " ns";
+  };
+
+  size_t sum = 0;
+  auto start = chrono::steady_clock::now();
+  for (int k = 0; k < numCall; k++)
+    sum += lang.tl("Klass").length();
+  string directNarrow = nsPerCall(msSince(start));
+
+  const wstring klass = L"Klass";
+  start = chrono::steady_clock::now();
+  for (int k = 0; k < numCall; k++)
+    sum += lang.tl(klass).length();
+  string directWide = nsPerCall(msSince(start));
+
+  const wstring prefixed = L"12: Klass";
+  start = chrono::steady_clock::now();
+  for (int k = 0; k < numCall; k++)
+    sum += lang.tl(prefixed).length();
+  string prefix = nsPerCall(msSince(start));
+
+  const wstring substituted = L"Klass X#Herrar";
+  start = chrono::steady_clock::now();
+  for (int k = 0; k < numCall; k++)
+    sum += lang.tl(substituted).length();
+  string subst = nsPerCall(msSince(start));
+
+  assertTrue("Translated", sum > 0);
+  report("Direct: " + directNarrow + ", direct wide: " + directWide +
+         ", prefix: " + prefix + ", substitution: " + subst);
+}
+
+// The parser test corpus, and the bundled result modules giving the same result from a fresh
+// copy and in reverse runner order, so that no evaluation state is kept between runners.
+class TestResultModules : public TestMeOS {
+public:
+  TestResultModules(TestMeOS &tm) : TestMeOS(tm, "Result module corpus") {}
+  TestMeOS *newInstance() const override { return new TestResultModules(*this); }
+  void run() const override;
+};
+
+void TestResultModules::run() const {
+  try {
+    Parser::test();
+  }
+  catch (const string &err) {
+    throw meosException(err);
+  }
+
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 3, 40);
+  mt19937 rnd(11);
+  for (size_t k = 0; k < runners.size(); k++) {
+    pRunner r = runners[k];
+    r->setFinishTime(r->getStartTime() + 20 * timeConstMinute + int(rnd() % 3000) * timeConstSecond);
+    RunnerStatus st = k % 7 == 3 ? StatusMP : (k % 11 == 5 ? StatusDNF : StatusOK);
+    r->setStatus(st, true, oBase::ChangeType::Update, false);
+    r->synchronize(true);
+  }
+
+  event.loadGeneralResults(true, true);
+  vector<pair<int, pair<string, wstring>>> modules;
+  event.getGeneralResults(true, modules, false);
+  assertTrue("Bundled modules", !modules.empty());
+
+  typedef tuple<int, int, int, int, int> Result;
+  auto calculate = [&runners](const GeneralResult &gr, bool reverse) {
+    vector<pRunner> rs = runners;
+    if (reverse)
+      std::reverse(rs.begin(), rs.end());
+    gr.calculateIndividualResults(rs, true, oListInfo::Classwise, true, 0);
+    map<int, Result> res;
+    for (pRunner r : rs) {
+      const oRunner::TempResult &tr = r->getTempResult();
+      res[r->getId()] = Result(tr.getRunningTime(), int(tr.getStatus()), tr.getPoints(),
+                               tr.getPlace(), tr.getTimeAfter());
+    }
+    return res;
+  };
+
+  auto start = chrono::steady_clock::now();
+  for (auto &m : modules) {
+    wstring source;
+    auto dr = dynamic_pointer_cast<DynamicResult>(event.getGeneralResult(m.second.first, source));
+    if (!dr)
+      continue;
+    map<int, Result> first = calculate(*dr, false);
+    map<int, Result> again = calculate(*dr, true);
+    DynamicResult fresh(*dr);
+    map<int, Result> copy = calculate(fresh, true);
+    assertTrue(("Same result again, " + m.second.first).c_str(), first == again);
+    assertTrue(("Same result from copy, " + m.second.first).c_str(), first == copy);
+  }
+  report(itos(modules.size()) + " modules, " + itos(int(msSince(start))) + " ms");
+}
+
+// Start order search: stopping after a round without improvement compared to trying all rounds
+class BenchmarkDrawStartOrder : public TestMeOS {
+public:
+  BenchmarkDrawStartOrder(TestMeOS &tm) : TestMeOS(tm, "Benchmark start order search") {}
+  TestMeOS *newInstance() const override { return new BenchmarkDrawStartOrder(*this); }
+  void run() const override;
+};
+
+void BenchmarkDrawStartOrder::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 30, 30);
+  vector<pClass> classes;
+  event.getClasses(classes, false);
+  for (size_t c = 0; c < classes.size(); c++) {
+    pCourse crs = event.addCourse(L"Bana " + itow(c + 1));
+    crs->importControls(itos(31 + c % 8) + ";" + itos(40 + c % 5) + ";" + itos(50 + c % 3) + ";" + itos(60 + c), true, false);
+    classes[c]->setCourse(crs);
+  }
+
+  auto draw = [&](bool exhaustive, double &ms) {
+    DrawInfo di;
+    di.maxCommonControl = 5;
+    di.exhaustiveSearch = exhaustive;
+    for (pClass c : classes)
+      di.classes[c->getId()] = ClassInfo(c);
+    vector<ClassInfo> cInfo;
+    vector<pair<int, wstring>> outLines;
+    auto start = chrono::steady_clock::now();
+    event.optimizeStartOrder(outLines, di, cInfo);
+    ms = msSince(start);
+    int last = 0;
+    for (const ClassInfo &ci : cInfo)
+      last = max(last, ci.firstStart + (ci.nRunners - 1) * ci.interval);
+    return last;
+  };
+
+  double msStop, msAll;
+  int lastStop = draw(false, msStop);
+  int lastAll = draw(true, msAll);
+  assertEquals(lastStop, draw(false, msStop)); // Deterministic
+
+  report("Stop without improvement: " + itos(int(msStop)) + " ms, last start slot " + itos(lastStop));
+  report("All rounds: " + itos(int(msAll)) + " ms, last start slot " + itos(lastAll));
+}
+
+// Rows are updated in place, and rows depending on a changed object are regenerated
+class TestTableUpdate : public TestMeOS {
+public:
+  TestTableUpdate(TestMeOS &tm) : TestMeOS(tm, "Update runner table") {}
+  TestMeOS *newInstance() const override { return new TestTableUpdate(*this); }
+  void run() const override;
+};
+
+void TestTableUpdate::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 2, 5);
+  pClub club = event.addClub(L"Club A");
+  for (pRunner r : runners) {
+    r->setClubId(club->getId());
+    r->synchronize(true);
+  }
+
+  Table &table = *oRunner::getTable(&event);
+  const int nameCol = 2, clubCol = 5;
+  auto cell = [&](pRunner r, int col) {
+    for (int row = 2; row < table.getNumDataRows() + 2; row++) {
+      if (table.getTableText(gdi(), row, 0) == itow(r->getId()))
+        return table.getTableText(gdi(), row, col);
+    }
+    throw meosException("Row not found");
+  };
+  assertEquals(int(runners.size()), table.getNumDataRows());
+
+  runners[3]->setName(L"Changed Name", false);
+  runners[3]->synchronize(true);
+  table.update();
+  assertEquals("Changed runner", gdi().narrow(runners[3]->getName()), gdi().narrow(cell(runners[3], nameCol)));
+  assertEquals("Unchanged runner", gdi().narrow(runners[2]->getName()), gdi().narrow(cell(runners[2], nameCol)));
+
+  club->setName(L"Club B");
+  club->synchronize(true);
+  table.update();
+  for (pRunner r : runners)
+    assertEquals("Club of runner", "Club B", gdi().narrow(cell(r, clubCol)));
+
+  event.removeRunner({ runners[0]->getId() });
+  table.update();
+  assertEquals(int(runners.size()) - 1, table.getNumDataRows());
+  table.update();
+  assertEquals(int(runners.size()) - 1, table.getNumDataRows());
+}
+
+// Journaled changes and removals replace the saved objects when the competition is opened
+class TestJournal : public TestMeOS {
+public:
+  TestJournal(TestMeOS &tm) : TestMeOS(tm, "Journal changes") {}
+  TestMeOS *newInstance() const override { return new TestJournal(*this); }
+  void run() const override;
+};
+
+void TestJournal::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 1, 4);
+  wstring file = getTempFile();
+  wstring journalFile = EventJournal::getJournalFile(file);
+  string id = EventJournal::newSnapshotId();
+
+  // Saved state of the runners
+  xmlparser saved;
+  string doc = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<RunnerList>\n";
+  for (pRunner r : runners)
+    doc += "<Runner><Id>" + itos(r->getId()) + "</Id><Name>Saved</Name></Runner>\n";
+  doc += "</RunnerList>\n";
+  saved.readMemory(doc, 0);
+  xmlList objects;
+  saved.getObject("RunnerList").getObjects(objects);
+
+  {
+    EventJournal journal;
+    journal.start(file, id);
+    assertTrue("Journal active", journal.isActive());
+    runners[1]->setName(L"First", false);
+    journal.changed(*runners[1]);
+    journal.removed(*runners[2]);
+  }
+  {
+    // Continue the journal of the same snapshot
+    EventJournal journal;
+    journal.start(file, id);
+    runners[1]->setName(L"Second", false);
+    journal.changed(*runners[1]);
+    assertTrue("No checkpoint", !journal.checkpoint());
+  }
+
+  JournalOverlay overlay;
+  assertTrue("Journal loaded", overlay.load(file, id));
+  assertTrue("Other snapshot", !JournalOverlay().load(file, EventJournal::newSnapshotId()));
+  overlay.merge("Runner", objects);
+
+  map<int, wstring> names;
+  for (auto &obj : objects) {
+    wstring name;
+    names[obj.getObjectInt("Id")] = obj.getObjectString("Name", name);
+  }
+  assertEquals(3, int(names.size()));
+  assertEquals(L"Saved", names[runners[0]->getId()]);
+  assertEquals(L"Second", names[runners[1]->getId()]);
+  assertTrue("Removed runner", names.count(runners[2]->getId()) == 0);
+  assertEquals(L"Saved", names[runners[3]->getId()]);
+
+  // A new snapshot replaces the journal
+  {
+    EventJournal journal;
+    journal.start(file, EventJournal::newSnapshotId());
+  }
+  assertTrue("Replaced journal", !JournalOverlay().load(file, id));
+  _wremove(journalFile.c_str());
+}
+
+// The saved name index of the runner database is used only with the file it was saved with
+class TestRunnerDBIndex : public TestMeOS {
+public:
+  TestRunnerDBIndex(TestMeOS &tm) : TestMeOS(tm, "Runner database name index") {}
+  TestMeOS *newInstance() const override { return new TestRunnerDBIndex(*this); }
+  void run() const override;
+};
+
+void TestRunnerDBIndex::run() const {
+  constexpr int numRunner = 200000;
+  oEvent &event = testEvent();
+  wstring file = getTempFile();
+  wstring indexFile = file + L".index";
+  {
+    RunnerDB db(&event);
+    for (int k = 0; k < numRunner; k++)
+      db.addRunner((L"Runner " + itow(k)).c_str(), k + 1, 0, k + 1);
+    db.saveRunners(file);
+  }
+
+  auto loadAndLookup = [&](RunnerDB &db, double &ms) {
+    auto start = chrono::steady_clock::now();
+    db.loadRunners(file);
+    RunnerWDBEntry *r = db.getRunnerByName(L"Runner 4711", 0, 0);
+    ms = msSince(start);
+    return r ? r->dbe().cardNo : 0;
+  };
+
+  double withIndex, withoutIndex;
+  RunnerDB indexed(&event);
+  assertEquals(4712, loadAndLookup(indexed, withIndex));
+  assertTrue("Unknown name", indexed.getRunnerByName(L"Runner X", 0, 0) == nullptr);
+
+  // Runners added before the first lookup are not in the saved index
+  RunnerDB added(&event);
+  added.loadRunners(file);
+  added.addRunner(L"Added Runner", numRunner + 1, 0, numRunner + 1);
+  RunnerWDBEntry *r = added.getRunnerByName(L"Added Runner", 0, 0);
+  assertTrue("Added runner", r != nullptr && r->dbe().cardNo == numRunner + 1);
+  assertTrue("Saved runner", added.getRunnerByName(L"Runner 17", 0, 0) != nullptr);
+
+  // A stale index is ignored
+  {
+    RunnerDB db(&event);
+    db.addRunner(L"Other Runner", 1, 0, 1);
+    db.saveRunners(file + L".other");
+    _wremove(indexFile.c_str());
+    _wrename((file + L".other.index").c_str(), indexFile.c_str());
+    _wremove((file + L".other").c_str());
+  }
+  RunnerDB stale(&event);
+  assertEquals(4712, loadAndLookup(stale, withoutIndex));
+  assertTrue("Stale index", stale.getRunnerByName(L"Other Runner", 0, 0) == nullptr);
+
+  _wremove(indexFile.c_str());
+  RunnerDB noIndex(&event);
+  assertEquals(4712, loadAndLookup(noIndex, withoutIndex));
+  report("Load and first lookup with index: " + itos(int(withIndex)) +
+         " ms, without: " + itos(int(withoutIndex)) + " ms");
+}
+
+// Table update time when nothing, one runner or a shared object has changed
+class BenchmarkTableUpdate : public TestMeOS {
+public:
+  BenchmarkTableUpdate(TestMeOS &tm) : TestMeOS(tm, "Benchmark runner table update") {}
+  TestMeOS *newInstance() const override { return new BenchmarkTableUpdate(*this); }
+  void run() const override;
+};
+
+void BenchmarkTableUpdate::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 40, 250);
+  pClub club = event.addClub(L"Club A");
+  runners[0]->setClubId(club->getId());
+  runners[0]->synchronize(true);
+
+  auto start = chrono::steady_clock::now();
+  Table &table = *oRunner::getTable(&event);
+  report("Generate " + itos(runners.size()) + " rows: " + itos(int(msSince(start))) + " ms");
+
+  start = chrono::steady_clock::now();
+  table.update();
+  report("No change: " + itos(int(msSince(start))) + " ms");
+
+  runners[1]->setName(L"Changed Name", false);
+  runners[1]->synchronize(true);
+  start = chrono::steady_clock::now();
+  table.update();
+  report("One runner changed: " + itos(int(msSince(start))) + " ms");
+
+  club->setName(L"Club B");
+  club->synchronize(true);
+  start = chrono::steady_clock::now();
+  table.update();
+  report("Club changed (all rows): " + itos(int(msSince(start))) + " ms");
+}
+
+// Replay a recorded stream of radio punches through the speaker monitor, with
+// incremental updates of the changed classes compared to a full recalculation
+class BenchmarkSpeakerReplay : public TestMeOS {
+public:
+  BenchmarkSpeakerReplay(TestMeOS &tm) : TestMeOS(tm, "Benchmark speaker punch replay") {}
+  TestMeOS *newInstance() const override { return new BenchmarkSpeakerReplay(*this); }
+  void run() const override;
+};
+
+void BenchmarkSpeakerReplay::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 20, 50);
+  vector<pClass> classes;
+  event.getClasses(classes, false);
+  const int radios[] = { 31, 32, 33 };
+  for (size_t c = 0; c < classes.size(); c++) {
+    pCourse crs = event.addCourse(L"Bana " + itow(c + 1));
+    crs->importControls("31;" + itos(40 + c) + ";32;" + itos(60 + c) + ";33", true, false);
+    classes[c]->setCourse(crs);
+  }
+  for (size_t k = 0; k < runners.size(); k++) {
+    runners[k]->setCardNo(10001 + k, false);
+    runners[k]->synchronize(true);
+  }
+
+  struct Punch {
+    int time;
+    int code;
+    int card;
+  };
+  vector<Punch> stream;
+  mt19937 rnd(1);
+  for (size_t k = 0; k < runners.size(); k++) {
+    int t = runners[k]->getStartTime();
+    for (int code : radios) {
+      t += timeConstMinute * (5 + rnd() % 10) + rnd() % timeConstMinute;
+      stream.push_back({ t, code, int(10001 + k) });
+    }
+  }
+  sort(stream.begin(), stream.end(), [](const Punch &a, const Punch &b) { return a.time < b.time; });
+
+  set<int> classIds, controlIds(begin(radios), end(radios));
+  for (pClass c : classes)
+    classIds.insert(c->getId());
+
+  SpeakerMonitor incremental(event), full(event);
+  incremental.setClassFilter(classIds, controlIds);
+  double msIncremental = 0, msFull = 0;
+  const size_t refresh = 10; // Punches between screen updates
+  for (size_t k = 0; k < stream.size(); k++) {
+    event.addFreePunch(stream[k].time, stream[k].code, 0, stream[k].card, true, true);
+    if (k % refresh == refresh - 1 || k + 1 == stream.size()) {
+      auto start = chrono::steady_clock::now();
+      incremental.updateResults();
+      msIncremental += msSince(start);
+
+      full.setClassFilter(classIds, controlIds);
+      start = chrono::steady_clock::now();
+      full.updateResults();
+      msFull += msSince(start);
+    }
+  }
+
+  auto describe = [](const oEvent::ResultEvent &re) {
+    return itos(re.r->getId()) + ":" + itos(re.control) + ":" + itos(re.time) + ":" +
+           itos(re.runTime) + ":" + itos(re.place);
+  };
+  const vector<oEvent::ResultEvent> &a = incremental.getResults(), &b = full.getResults();
+  assertEquals(int(stream.size()), int(b.size()));
+  assertEquals(int(b.size()), int(a.size()));
+  for (size_t k = 0; k < a.size(); k++)
+    assertEquals("Result event", describe(b[k]), describe(a[k]));
+
+  report(itos(stream.size()) + " punches, update every " + itos(refresh));
+  report("Changed classes: " + itos(int(msIncremental)) + " ms");
+  report("All classes: " + itos(int(msFull)) + " ms");
+}
+
+// Applies MOP documents the way a MOP server does: an element replaces the stored element
+// with the same tag and id, except that the card, radio times and input result of a
+// competitor are kept when not sent.
+class MOPConsumer {
+  map<string, map<string, wstring>> elements;
+
+  static void readFields(const xmlobject &x, const string &prefix,
+                         const vector<const char *> &attribs, map<string, wstring> &fields) {
+    for (const char *a : attribs) {
+      xmlattrib xa = x.getAttrib(a);
+      if (xa)
+        fields[prefix + a] = xa.getWStr();
+      else
+        fields.erase(prefix + a);
+    }
+    fields[prefix] = x.getWStr();
+  }
+
+public:
+  // Returns the nextdifference id
+  string apply(const string &doc) {
+    xmlparser xml;
+    xml.readMemory(doc, 0);
+    xmlobject root = xml.getObject(nullptr);
+    if (root.is("MOPComplete"))
+      elements.clear();
+
+    xmlList children;
+    root.getObjects(children);
+    for (xmlobject &x : children) {
+      string key = string(x.getName()) + ":" + x.getAttrib("id").getStr();
+      if (x.getAttrib("delete")) {
+        elements.erase(key);
+        continue;
+      }
+      map<string, wstring> &fields = elements[key];
+      const vector<const char *> base = { "org", "cls", "stat", "prel", "st", "rt", "crs", "bib", "nat" };
+      if (x.is("cmp")) {
+        if (x.getAttrib("card"))
+          fields["card"] = x.getAttrib("card").getWStr();
+        readFields(x, "", { "competing" }, fields);
+        readFields(x.getObject("base"), "base.", base, fields);
+        if (x.getObject("radio"))
+          fields["radio"] = x.getObject("radio").getWStr();
+        if (xmlobject input = x.getObject("input"))
+          fields["input"] = input.getAttrib("it").getWStr() + L"," + input.getAttrib("tstat").getWStr();
+        continue;
+      }
+
+      fields.clear();
+      if (x.is("tm")) {
+        readFields(x.getObject("base"), "base.", base, fields);
+        fields["r"] = x.getObject("r").getWStr();
+      }
+      else
+        readFields(x, "", { "offline", "ord", "radio", "crs", "maps", "len", "climb", "nat",
+                            "date", "organizer", "homepage", "zerotime" }, fields);
+    }
+    return root.getAttrib("nextdifference").getStr();
+  }
+
+  bool operator==(const MOPConsumer &c) const { return elements == c.elements; }
+  size_t size() const { return elements.size(); }
+};
+
+// Subscribers poll MOP differences at different rates while the competition changes
+class TestMOPSubscribers : public TestMeOS {
+public:
+  TestMOPSubscribers(TestMeOS &tm) : TestMeOS(tm, "MOP difference subscribers") {}
+  TestMeOS *newInstance() const override { return new TestMOPSubscribers(*this); }
+  void run() const override;
+};
+
+void TestMOPSubscribers::run() const {
+  oEvent &event = testEvent();
+  vector<pRunner> runners = createRunners(event, 5, 40);
+  pClub club = event.addClub(L"Club A");
+  for (pRunner r : runners) {
+    r->setClubId(club->getId());
+    r->synchronize(true);
+  }
+
+  shared_ptr<RestServer> server = RestServer::construct();
+  shared_ptr<RestServer> reference = RestServer::construct();
+  struct Subscriber {
+    MOPConsumer state;
+    string next = "zero";
+    string lastAnswer;
+  };
+  vector<Subscriber> subscribers(100);
+  int fallbacks = 0;
+  auto poll = [&](Subscriber &s) {
+    string answer;
+    server->mopDifference(event, s.next, answer);
+    if (answer.compare(0, 5, "Error") == 0) {
+      fallbacks++; // Evicted client: start over, as a MOP client does
+      s.next = "zero";
+      server->mopDifference(event, s.next, answer);
+    }
+    s.lastAnswer = answer;
+    s.next = s.state.apply(answer);
+  };
+
+  mt19937 rnd(7);
+  for (int round = 0; round < 40; round++) {
+    for (int k = 0; k < 5; k++) {
+      pRunner r = runners[rnd() % runners.size()];
+      if (r->isRemoved())
+        continue;
+      r->setFinishTime(r->getStartTime() + timeConstMinute * (20 + rnd() % 40));
+      r->setStatus(StatusOK, true, oBase::ChangeType::Update);
+      if (round % 5 == 0)
+        r->setCardNo(20000 + round * 10 + k, false);
+      r->synchronize(true);
+    }
+    if (round == 20)
+      event.removeRunner({ runners[1]->getId() });
+
+    // Subscribers polling at the same position get the same bytes
+    map<string, string> answerByPosition;
+    for (Subscriber &s : subscribers) {
+      if (rnd() % 3 != 0)
+        continue;
+      string position = s.next;
+      poll(s);
+      if (position == "zero")
+        continue;
+      auto res = answerByPosition.emplace(position, s.lastAnswer);
+      if (!res.second)
+        assertTrue("Same difference", res.first->second == s.lastAnswer);
+    }
+
+    // A repeated request is answered with the same data
+    Subscriber &s = subscribers[round % subscribers.size()];
+    if (s.next != "zero") {
+      string answer, again;
+      server->mopDifference(event, s.next, answer);
+      server->mopDifference(event, s.next, again);
+      assertTrue("Repeated request", answer == again);
+    }
+  }
+
+  Subscriber complete;
+  string answer;
+  reference->mopDifference(event, "zero", answer);
+  complete.state.apply(answer);
+  assertTrue("Complete competition", complete.state.size() > runners.size());
+
+  for (Subscriber &s : subscribers) {
+    poll(s);
+    assertTrue("Subscriber state", s.state == complete.state);
+  }
+  report("Restarted subscribers: " + itos(fallbacks));
+
+  RestServer::remove(server);
+  RestServer::remove(reference);
+}
+
+// Radio punches from several station threads at a fixed total rate, processed
+// by the main thread as they arrive. Some punches fail when processed.
+class BenchmarkSIQueue : public TestMeOS {
+public:
+  BenchmarkSIQueue(TestMeOS &tm) : TestMeOS(tm, "Benchmark SportIdent punch queue") {}
+  TestMeOS *newInstance() const override { return new BenchmarkSIQueue(*this); }
+  void run() const override;
+};
+
+void BenchmarkSIQueue::run() const {
+  constexpr int numStation = 8, punchesPerSecond = 10000, seconds = 2, failInterval = 997;
+  constexpr int numPunch = punchesPerSecond * seconds / numStation;
+  const chrono::nanoseconds interval(1000000000LL * numStation / punchesPerSecond);
+
+  SportIdent si(nullptr, 0, false);
+  vector<vector<chrono::steady_clock::time_point>> sentAt(numStation, vector<chrono::steady_clock::time_point>(numPunch));
+  vector<int> received(numStation);
+  bool inOrder = true;
+  int numFailed = 0, numErrors = 0;
+  double maxDelay = 0, sumDelay = 0;
+
+  auto start = chrono::steady_clock::now();
+  vector<thread> stations;
+  for (int s = 0; s < numStation; s++) {
+    stations.emplace_back([s, start, interval, &si, &sentAt]() {
+      for (int k = 0; k < numPunch; k++) {
+        this_thread::sleep_until(start + k * interval);
+        sentAt[s][k] = chrono::steady_clock::now();
+        si.addPunch((k + 1) * timeConstSecond, 31 + s, k + 1);
+      }
+    });
+  }
+
+  auto process = [&](SICard &sic) {
+    auto now = chrono::steady_clock::now();
+    int s = sic.Punch[0].Code - 31;
+    int k = sic.CardNumber - 1;
+    if (s < 0 || s >= numStation || k != received[s]) {
+      inOrder = false;
+      return;
+    }
+    double delay = chrono::duration<double, milli>(now - sentAt[s][k]).count();
+    maxDelay = max(maxDelay, delay);
+    sumDelay += delay;
+    received[s]++;
+    if (k % failInterval == 0) {
+      numFailed++;
+      throw meosException("Failed punch");
+    }
+  };
+
+  const int total = numPunch * numStation;
+  auto deadline = start + chrono::seconds(seconds + 10);
+  int numReceived = 0;
+  while (numReceived < total && chrono::steady_clock::now() < deadline) {
+    try {
+      si.processReadouts(process);
+    }
+    catch (const meosException &) {
+      numErrors++;
+    }
+    numReceived = 0;
+    for (int r : received)
+      numReceived += r;
+    Sleep(1);
+  }
+  for (auto &t : stations)
+    t.join();
+  double ms = msSince(start);
+
+  assertTrue("In order", inOrder);
+  assertEquals(total, numReceived);
+  assertTrue("Failed punches reported", numErrors > 0 && numErrors <= numFailed);
+  report(itos(total) + " punches from " + itos(numStation) + " stations in " + itos(int(ms)) +
+         " ms, delay mean " + itos(int(sumDelay * 1000 / max(numReceived, 1))) + " us, max " +
+         itos(int(maxDelay * 1000)) + " us");
+}
+
+// Fake SportIdent TCP gateways replay punches and cards on several connections at once.
+// Each stream is sent in random pieces, so frames are split between reads.
+class TestTCPGateways : public TestMeOS {
+public:
+  TestTCPGateways(TestMeOS &tm) : TestMeOS(tm, "SportIdent TCP gateways") {}
+  TestMeOS *newInstance() const override { return new TestTCPGateways(*this); }
+  void run() const override;
+};
+
+void TestTCPGateways::run() const {
+  constexpr int numGateway = 8, numPunch = 2500, cardInterval = 100;
+  const u_short port = 10931;
+  WSADATA wsaData;
+  if (WSAStartup(0x202, &wsaData) != 0)
+    throw meosException("WSAStartup failed");
+
+  auto putFrame = [](vector<char> &out, BYTE type, WORD codeNo, DWORD cardNo, DWORD time) {
+    char frame[15];
+    DWORD day = 0;
+    frame[0] = char(type);
+    memcpy(frame + 1, &codeNo, 2);
+    memcpy(frame + 3, &cardNo, 4);
+    memcpy(frame + 7, &day, 4);
+    memcpy(frame + 11, &time, 4);
+    out.insert(out.end(), frame, frame + 15);
+  };
+
+  // (card, control) of punches and (card, number of punches) of cards
+  multiset<pair<int, int>> sentPunches, sentCards;
+  vector<vector<char>> streams(numGateway);
+  for (int g = 0; g < numGateway; g++) {
+    for (int k = 0; k < numPunch; k++) {
+      int cardNo = 100000 * (g + 1) + k % 300;
+      int code = 31 + k % 200;
+      putFrame(streams[g], 0, WORD(code), cardNo, (k + 1) * timeConstSecond);
+      sentPunches.emplace(cardNo, code);
+      if (k % cardInterval == 0) {
+        cardNo = 900000 + 10000 * g + k;
+        int nPunch = 2 + k % 30;
+        putFrame(streams[g], 64, WORD(nPunch), cardNo, 0);
+        for (int p = 0; p < nPunch; p++) {
+          SIPunch punch = { DWORD(31 + p), DWORD((p + 1) * timeConstMinute) };
+          const char *data = (const char *)&punch;
+          streams[g].insert(streams[g].end(), data, data + sizeof(SIPunch));
+        }
+        sentCards.emplace(cardNo, nPunch);
+      }
+    }
+  }
+
+  SportIdent si(nullptr, 0, false);
+  si.tcpAddPort(port, 0);
+  si.startMonitorThread(L"TCP");
+  assertTrue("Port open", si.isPortOpen(L"TCP"));
+
+  auto start = chrono::steady_clock::now();
+  vector<int> sendErrors(numGateway);
+  vector<thread> gateways;
+  for (int g = 0; g < numGateway; g++) {
+    gateways.emplace_back([g, port, &streams, &sendErrors]() {
+      SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      sockaddr_in addr = {};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port = htons(port);
+      if (s == INVALID_SOCKET || connect(s, (sockaddr *)&addr, sizeof(addr)) != 0) {
+        sendErrors[g]++;
+        if (s != INVALID_SOCKET)
+          closesocket(s);
+        return;
+      }
+      mt19937 rnd(g);
+      const vector<char> &data = streams[g];
+      for (size_t pos = 0; pos < data.size();) {
+        int len = int(std::min<size_t>(1 + rnd() % 700, data.size() - pos));
+        int r = send(s, data.data() + pos, len, 0);
+        if (r <= 0) {
+          sendErrors[g]++;
+          break;
+        }
+        pos += r;
+      }
+      closesocket(s);
+    });
+  }
+  for (auto &t : gateways)
+    t.join();
+
+  multiset<pair<int, int>> gotPunches, gotCards;
+  SICard card(ConvertedTimeStatus::Hour24);
+  size_t expected = sentPunches.size() + sentCards.size();
+  auto deadline = chrono::steady_clock::now() + chrono::seconds(30);
+  while (gotPunches.size() + gotCards.size() < expected && chrono::steady_clock::now() < deadline) {
+    if (!si.getCard(card)) {
+      Sleep(10);
+      continue;
+    }
+    if (card.punchOnly)
+      gotPunches.emplace(card.CardNumber, card.Punch[0].Code);
+    else
+      gotCards.emplace(card.CardNumber, card.nPunch);
+  }
+  double ms = msSince(start);
+  si.closeCom(L"TCP");
+  Sleep(1000); // Let the listener thread notice that the port is closed
+  WSACleanup();
+
+  for (int g = 0; g < numGateway; g++)
+    assertEquals(0, sendErrors[g]);
+  assertEquals(int(sentPunches.size()), int(gotPunches.size()));
+  assertEquals(int(sentCards.size()), int(gotCards.size()));
+  assertTrue("Same punches", sentPunches == gotPunches);
+  assertTrue("Same cards", sentCards == gotCards);
+  report(itos(int(expected)) + " punches and cards from " + itos(numGateway) +
+         " gateways in " + itos(int(ms)) + " ms");
+}
 
 void registerTests(TestMeOS &tm) {
+  tm.registerTest(TestClassChangeMaps(tm));
+  tm.registerTest(BenchmarkMapCount(tm));
+  tm.registerTest(TestListExport(tm));
+  tm.registerTest(BenchmarkListExport(tm));
+  tm.registerTest(TestIntKeyMap(tm));
+  tm.registerTest(BenchmarkIntKeyMap(tm));
+  tm.registerTest(TestStableList(tm));
+  tm.registerTest(BenchmarkStableList(tm));
+  tm.registerTest(TestTranslateThreads(tm));
+  tm.registerTest(BenchmarkTranslate(tm));
+  tm.registerTest(TestResultModules(tm));
+  tm.registerTest(BenchmarkDrawStartOrder(tm));
+  tm.registerTest(TestTableUpdate(tm));
+  tm.registerTest(BenchmarkTableUpdate(tm));
+  tm.registerTest(TestJournal(tm));
+  tm.registerTest(TestRunnerDBIndex(tm));
+  tm.registerTest(BenchmarkSpeakerReplay(tm));
+  tm.registerTest(TestMOPSubscribers(tm));
+  tm.registerTest(BenchmarkSIQueue(tm));
+  tm.registerTest(TestTCPGateways(tm));
 }
@@ -503,17 +503,18 @@ void xmlparser::endTag()
 void xmlparser::openMemoryOutput(bool useCutMode) {
   cutMode = useCutMode;
   toString = true;
+  tagStackPointer = 0;
+  foutString.str(string());
   foutString.clear();
   if (utfConverter)
     fOut() << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n\n\n";
   else
     fOut() << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n\n\n";
-
-  string out = foutString.str();
 }
 
 void xmlparser::getMemoryOutput(string &res) {
   res = foutString.str();
+  foutString.str(string());
   foutString.clear();
 }
 
@@ -548,6 +549,9 @@ int xmlparser::closeOut()
   while(tagStackPointer>0)
     endTag();
 
+  if (toString)
+    return (int)foutString.tellp();
+
   int len = (int)foutFile.tellp();
   foutFile.close();
 
@@ -564,6 +568,10 @@ xmlattrib::xmlattrib(const char *t, char *d, const xmlparser *p) : tag(t), data(
 
 void xmlparser::read(const wstring &file, int maxobj)
 {
+  if (fin.is_open())
+    fin.close();
+  fin.clear();
+  streaming = false;
   fin.open(file.c_str(), ios::binary);
 
   if (!fin.good())
@@ -646,6 +654,161 @@ void xmlparser::readMemory(const string &mem, int maxobj)
   parse(maxobj);
 }
 
+void xmlparser::openStream(const wstring &file) {
+  if (fin.is_open())
+    fin.close();
+  fin.clear();
+  fin.open(file.c_str(), ios::binary);
+
+  if (!fin.good())
+    throw meosException(L"Failed to open 'X' for reading.#" + file);
+
+  char bf[1024];
+  bf[0]=0;
+
+  do {
+    fin.getline(bf, 1024, '>');
+    lineNumber++;
+  }
+  while(fin.good() && bf[0]==0);
+
+  char *ptr=ltrim(bf);
+  isUTF = checkUTF(ptr);
+
+  streaming = true;
+  streamFile = file;
+  streamRoot.clear();
+  streamStart = 0;
+  streamLen = 0;
+  streamEof = false;
+  streamDone = false;
+
+  // Find the start tag of the root element
+  size_t offset = 0, tagStart, tagEnd;
+  while (findStreamTag(offset, tagStart, tagEnd)) {
+    const char *tag = &streamBuf[streamStart + tagStart];
+    offset = tagEnd + 1;
+    if (tag[1] == '!' || tag[1] == '?')
+      continue;
+    if (tag[1] == '/')
+      throw std::exception("Invalid XML file.");
+
+    streamRoot.assign(tag, tagEnd - tagStart + 1);
+    if (tag[tagEnd - tagStart - 1] == '/')
+      streamDone = true; // Empty root
+    break;
+  }
+  streamStart += offset;
+  parseStreamed(nullptr, 0);
+}
+
+void xmlparser::rewindStream() {
+  if (streaming)
+    openStream(wstring(streamFile));
+}
+
+bool xmlparser::fillStream() {
+  if (streamEof)
+    return false;
+
+  // Move unconsumed data to the beginning of the buffer. Offsets relative to streamStart are kept.
+  if (streamStart > 0) {
+    memmove(&streamBuf[0], &streamBuf[streamStart], streamLen - streamStart);
+    streamLen -= streamStart;
+    streamStart = 0;
+  }
+
+  const size_t chunkSize = 1024 * 1024;
+  if (streamBuf.size() < streamLen + chunkSize)
+    streamBuf.resize(streamLen + chunkSize);
+
+  fin.read(&streamBuf[streamLen], chunkSize);
+  size_t got = size_t(fin.gcount());
+  streamLen += got;
+  if (got < chunkSize) {
+    streamEof = true;
+    fin.close();
+  }
+  return got > 0;
+}
+
+bool xmlparser::findStreamTag(size_t &offset, size_t &tagStart, size_t &tagEnd) {
+  size_t k = offset;
+  while (true) {
+    while (streamStart + k < streamLen && streamBuf[streamStart + k] != '<')
+      k++;
+    if (streamStart + k < streamLen)
+      break;
+    if (!fillStream())
+      return false;
+  }
+  tagStart = k;
+  while (true) {
+    while (streamStart + k < streamLen && streamBuf[streamStart + k] != '>')
+      k++;
+    if (streamStart + k < streamLen)
+      break;
+    if (!fillStream())
+      return false;
+  }
+  tagEnd = k;
+  return true;
+}
+
+void xmlparser::parseStreamed(const char *data, size_t len) {
+  xbf.resize(streamRoot.size() + len + 2);
+  memcpy(&xbf[0], streamRoot.c_str(), streamRoot.size());
+  if (len > 0)
+    memcpy(&xbf[streamRoot.size()], data, len);
+  xbf[xbf.size() - 2] = '\n';
+  xbf.back() = 0;
+
+  xmlinfo.clear();
+  parseStack.clear();
+  if (!streamRoot.empty())
+    parse(0);
+}
+
+xmlobject xmlparser::readNextObject() {
+  if (!streaming || streamDone)
+    return xmlobject(0);
+
+  int depth = 0;
+  size_t offset = 0, tagStart, tagEnd;
+  size_t childStart = 0;
+  while (findStreamTag(offset, tagStart, tagEnd)) {
+    const char *tag = &streamBuf[streamStart + tagStart];
+    offset = tagEnd + 1;
+    if (tag[1] == '!' || tag[1] == '?')
+      continue;
+
+    if (tag[1] == '/') {
+      if (depth == 0) {
+        // End of root
+        streamStart += offset;
+        streamDone = true;
+        break;
+      }
+      depth--;
+    }
+    else {
+      if (depth == 0)
+        childStart = tagStart;
+      if (tag[tagEnd - tagStart - 1] != '/')
+        depth++;
+    }
+
+    if (depth == 0) {
+      parseStreamed(&streamBuf[streamStart + childStart], offset - childStart);
+      streamStart += offset;
+      return xmlobject(this, 1);
+    }
+  }
+  streamDone = true;
+  parseStreamed(nullptr, 0);
+  return xmlobject(0);
+}
+
 bool xmlparser::checkUTF(const char *ptr) const {
   bool utf = false;
 
@@ -806,7 +969,8 @@ xmlobject xmlobject::getObject(const char *pname) const
 
   unsigned child = index+1;
   while (child < xmlinfo.size() && xmlinfo[child].parent == index) {
-    if (strcmp(xmlinfo[child].tag, pname)==0)
+    const char *tag = xmlinfo[child].tag;
+    if (tag[0] == pname[0] && strcmp(tag, pname)==0)
       return xmlobject(parser, child);
     else
       child = xmlinfo[child].next;
@@ -832,6 +996,31 @@ void xmlobject::getObjects(xmlList &obj) const
   }
 }
 
+void xmlobject::forEach(const char *tag, const function<void(xmlobject &)> &f) const {
+  if (isnull())
+    throw std::exception("Null pointer exception");
+
+  if (parser->isStreaming() && index == 0) {
+    parser->rewindStream();
+    while (true) {
+      xmlobject child = parser->readNextObject();
+      if (!child)
+        break;
+      if (tag == nullptr || child.is(tag))
+        f(child);
+    }
+  }
+  else {
+    xmlList children;
+    if (tag)
+      getObjects(tag, children);
+    else
+      getObjects(children);
+    for (xmlobject &child : children)
+      f(child);
+  }
+}
+
 void xmlobject::getObjects(const char *tag, xmlList &obj) const
 {
   obj.clear();
@@ -844,7 +1033,8 @@ void xmlobject::getObjects(const char *tag, xmlList &obj) const
   parser->access(index);
 
   while (child < xmlinfo.size() && xmlinfo[child].parent == index) {
-    if (strcmp(tag, xmlinfo[child].tag) == 0)
+    const char *ctag = xmlinfo[child].tag;
+    if (ctag[0] == tag[0] && strcmp(tag, ctag) == 0)
       obj.push_back(xmlobject(parser, child));
     child = xmlinfo[child].next;
   }
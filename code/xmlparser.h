@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <sstream>
+#include <functional>
 class xmlobject;
 
 typedef vector<xmlobject> xmlList;
@@ -116,6 +117,20 @@ protected:
   vector<xmldata> xmlinfo;
   vector<char> xbf;
 
+  // Streaming read
+  bool streaming = false;
+  wstring streamFile;
+  string streamRoot; // Start tag of the root element
+  vector<char> streamBuf;
+  size_t streamStart = 0; // First unconsumed byte in streamBuf
+  size_t streamLen = 0;
+  bool streamEof = false;
+  bool streamDone = false;
+
+  bool fillStream();
+  bool findStreamTag(size_t &offset, size_t &tagStart, size_t &tagEnd);
+  void parseStreamed(const char *data, size_t len);
+
   bool processTag(char *start, char *end);
 
   bool checkUTF(const char *ptr) const;
@@ -152,6 +167,16 @@ public:
   void read(const wstring &file, int maxobj = 0);
   void readMemory(const string &mem, int maxobj);
 
+  /** Open a file for streaming. Only the root element and one of its children
+      at a time are kept in memory. The root (with attributes) is available by getObject. */
+  void openStream(const wstring &file);
+  bool isStreaming() const { return streaming; }
+  /** Read the next child of the root element. The previously read child becomes invalid. 
+      Returns a null object at the end of the root element. */
+  xmlobject readNextObject();
+  /** Restart reading from the first child of the root element. */
+  void rewindStream();
+
   void write(const char *tag, const char *prop,
               const string &value);
   void write(const char *tag, const char *prop,
@@ -275,6 +300,11 @@ public:
   void getObjects(xmlList &objects) const;
   void getObjects(const char *tag, xmlList &objects) const;
 
+  /** Call f for each child (with the given tag, or all if null). For the root
+      of a streamed file, the children are read from file and f must not
+      keep the object. */
+  void forEach(const char *tag, const std::function<void(xmlobject &)> &f) const;
+
   bool is(const char *pname) const {
     const char *n = getName();
     return n[0] == pname[0] && strcmp(n, pname)==0;
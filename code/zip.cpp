@@ -472,3 +472,117 @@ int zip(const wchar_t *zipfilename, const char *password, const vector<wstring>
 
   return 0;
 }
+
+namespace {
+  /** Growable in-memory target for minizip's file function table. */
+  struct MemoryZipStream {
+    string *data;
+    size_t pos;
+  };
+
+  voidpf ZCALLBACK memOpen(voidpf opaque, const void *filename, int mode) {
+    MemoryZipStream *ms = (MemoryZipStream *)opaque;
+    ms->pos = 0;
+    ms->data->clear();
+    return ms;
+  }
+
+  uLong ZCALLBACK memRead(voidpf opaque, voidpf stream, void *buf, uLong size) {
+    MemoryZipStream *ms = (MemoryZipStream *)stream;
+    size_t n = min<size_t>(size, ms->data->size() - min(ms->pos, ms->data->size()));
+    if (n > 0)
+      memcpy(buf, ms->data->data() + ms->pos, n);
+    ms->pos += n;
+    return uLong(n);
+  }
+
+  uLong ZCALLBACK memWrite(voidpf opaque, voidpf stream, const void *buf, uLong size) {
+    MemoryZipStream *ms = (MemoryZipStream *)stream;
+    if (ms->pos + size > ms->data->size())
+      ms->data->resize(ms->pos + size);
+    memcpy(&(*ms->data)[ms->pos], buf, size);
+    ms->pos += size;
+    return size;
+  }
+
+  ZPOS64_T ZCALLBACK memTell(voidpf opaque, voidpf stream) {
+    return ((MemoryZipStream *)stream)->pos;
+  }
+
+  long ZCALLBACK memSeek(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin) {
+    MemoryZipStream *ms = (MemoryZipStream *)stream;
+    switch (origin) {
+    case ZLIB_FILEFUNC_SEEK_SET:
+      ms->pos = size_t(offset);
+      break;
+    case ZLIB_FILEFUNC_SEEK_CUR:
+      ms->pos += size_t(offset);
+      break;
+    case ZLIB_FILEFUNC_SEEK_END:
+      ms->pos = ms->data->size() + size_t(offset);
+      break;
+    default:
+      return -1;
+    }
+    return 0;
+  }
+
+  int ZCALLBACK memClose(voidpf opaque, voidpf stream) {
+    return 0;
+  }
+
+  int ZCALLBACK memError(voidpf opaque, voidpf stream) {
+    return 0;
+  }
+}
+
+void zipMemory(const string &fileNameInZip, const string &data, string &zipped) {
+  MemoryZipStream ms;
+  ms.data = &zipped;
+  ms.pos = 0;
+  zipped.reserve(data.size() / 4 + 256);
+
+  zlib_filefunc64_def ffunc;
+  ffunc.zopen64_file = memOpen;
+  ffunc.zread_file = memRead;
+  ffunc.zwrite_file = memWrite;
+  ffunc.ztell64_file = memTell;
+  ffunc.zseek64_file = memSeek;
+  ffunc.zclose_file = memClose;
+  ffunc.zerror_file = memError;
+  ffunc.opaque = &ms;
+
+  zipFile zf = zipOpen2_64("", 0, NULL, &ffunc);
+  if (zf == NULL)
+    throw meosException("Error creating zip archive in memory.");
+
+  zip_fileinfo zi;
+  memset(&zi, 0, sizeof(zi));
+  SYSTEMTIME st;
+  GetLocalTime(&st);
+  FILETIME ft;
+  SystemTimeToFileTime(&st, &ft);
+  FileTimeToDosDateTime(&ft, ((LPWORD)&zi.dosDate) + 1, ((LPWORD)&zi.dosDate) + 0);
+
+  const int opt_compress_level = Z_BEST_COMPRESSION;
+  int err = zipOpenNewFileInZip3_64(zf, fileNameInZip.c_str(), &zi,
+                                    NULL, 0, NULL, 0, NULL,
+                                    Z_DEFLATED, opt_compress_level, 0,
+                                    -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY,
+                                    NULL, 0, data.size() >= 0xffffffff ? 1 : 0);
+
+  // Write in bounded blocks; zipWriteInFileInZip takes an unsigned length
+  size_t written = 0;
+  while (err == ZIP_OK && written < data.size()) {
+    unsigned len = unsigned(min<size_t>(data.size() - written, WRITEBUFFERSIZE));
+    err = zipWriteInFileInZip(zf, data.data() + written, len);
+    written += len;
+  }
+
+  if (err == ZIP_OK)
+    err = zipCloseFileInZip(zf);
+
+  int errclose = zipClose(zf, NULL);
+  if (err != ZIP_OK || errclose != ZIP_OK)
+    throw meosException("Error writing zip archive in memory.");
+}